@@ -8,7 +8,9 @@
 #ifndef SOLARGATORSBSP_DATAMODULES_INC_DATAMODULE_HPP_
 #define SOLARGATORSBSP_DATAMODULES_INC_DATAMODULE_HPP_
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <cmsis_os.h>
 
 namespace SolarGators {
@@ -16,8 +18,9 @@ namespace DataModules {
 
 class DataModule {
 public:
-  DataModule(uint32_t can_id, uint16_t telem_id, uint32_t size, uint16_t instance_id = 0, bool is_ext_id = false, bool is_rtr = false):
-    can_id_(can_id), telem_id_(telem_id), size_(size), instance_id_(instance_id), is_ext_id_(is_ext_id), is_rtr_(is_rtr)
+  DataModule(uint32_t can_id, uint16_t telem_id, uint32_t size, uint16_t instance_id = 0, bool is_ext_id = false, bool is_rtr = false, bool is_brs = false):
+    can_id_(can_id), telem_id_(telem_id), size_(size), instance_id_(instance_id), is_ext_id_(is_ext_id), is_rtr_(is_rtr), is_brs_(is_brs),
+    rx_tick_(0), sequence_(0), freshness_deadline_(0), stale_(false), lazy_(false), decoded_sequence_(0), raw_{}
   {
     mutex_id_ = osMutexNew(&mutex_attributes_);
   };
@@ -25,6 +28,76 @@ public:
   // All data modules must define this so that we can parse the can messages
   virtual void ToByteArray(uint8_t* buff) const = 0;
   virtual void FromByteArray(uint8_t* buff) = 0;
+  // Received modules are published with a seqlock instead of the mutex. The CAN rx task is
+  // the only writer and wraps every decode in BeginUpdate/EndUpdate, sequence_ is odd in between.
+  void BeginUpdate()
+  {
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  void EndUpdate(uint32_t tick)
+  {
+    rx_tick_ = tick;
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+  // Runs fn until it completes without an update landing in the middle, so everything it
+  // reads from the module is from the same frame. fn must only copy data out, it can run more than once.
+  // Not for use from interrupts, the writer can never finish while an ISR spins here.
+  template <typename Fn>
+  void Read(Fn fn) const
+  {
+    while(true)
+    {
+      uint32_t start = sequence_.load(std::memory_order_acquire);
+      if(start & 1)
+        continue;
+      fn();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if(sequence_.load(std::memory_order_relaxed) == start)
+        return;
+    }
+  }
+  // Decodes a received payload, or in lazy mode just keeps it. Rx side only.
+  void Receive(uint8_t* buff, uint32_t tick)
+  {
+    BeginUpdate();
+    if(lazy_)
+      memcpy(raw_, buff, size_);
+    else
+      FromByteArray(buff);
+    EndUpdate(tick);
+  }
+  // Consistent serialised copy of a received module
+  void Snapshot(uint8_t* buff) const
+  {
+    if(lazy_)
+      Read([&]() { memcpy(buff, raw_, size_); });
+    else
+      Read([&]() { ToByteArray(buff); });
+  }
+  // In lazy mode the rx task only copies the payload and the first getter call after each
+  // frame decodes it. Only for modules whose getters and ToByteArray call Sync, set before registering.
+  bool SetLazy(bool lazy)
+  {
+    if(lazy && size_ > MAX_LAZY_SIZE)
+      return false;
+    lazy_ = lazy;
+    return true;
+  }
+  bool IsLazy() const { return lazy_; }
+  static constexpr uint8_t MAX_LAZY_SIZE = 8;
+  // Tick the last frame was received at
+  uint32_t GetRxTick() const { return rx_tick_; }
+  // Bumped on every update, compare against the last value seen to skip unchanged modules
+  uint32_t GetSequence() const { return sequence_.load(std::memory_order_acquire) >> 1; }
+  // Ticks without an update before the module is considered stale, 0 never goes stale
+  void SetFreshnessDeadline(uint32_t ticks) { freshness_deadline_ = ticks; }
+  uint32_t GetFreshnessDeadline() const { return freshness_deadline_; }
+  bool IsStale(uint32_t now) const
+  {
+    return freshness_deadline_ != 0 && now - rx_tick_ > freshness_deadline_;
+  }
+  bool IsStale() const { return IsStale(osKernelGetTickCount()); }
   // The can bus ID for the data module
   const uint32_t can_id_;
   // ID for transmitting the data module to the pit
@@ -37,6 +110,14 @@ public:
   const bool is_ext_id_;
   // If the can message is RTR
   const bool is_rtr_;
+  // If the module goes out as a CAN FD frame with the bit rate switched (size_ above 8 is always FD)
+  const bool is_brs_;
+  // Receive tick, update count and staleness state
+  volatile uint32_t rx_tick_;
+  std::atomic<uint32_t> sequence_;
+  uint32_t freshness_deadline_;
+  // Last staleness reported by the CAN driver, only touched by the rx task
+  bool stale_;
   // Mutex for the data module
   osMutexId_t mutex_id_;
   StaticSemaphore_t mutex_control_block_;
@@ -46,6 +127,31 @@ public:
     .cb_mem = &mutex_control_block_,
     .cb_size = sizeof(mutex_control_block_),
   };
+protected:
+  // Brings the decoded members up to date with the last payload received in lazy mode.
+  // A single branch otherwise, call it at the top of every getter and of ToByteArray.
+  void Sync() const
+  {
+    if(!lazy_ || decoded_sequence_ == sequence_.load(std::memory_order_acquire))
+      return;
+    // Readers on different tasks would otherwise decode over each other
+    osMutexAcquire(mutex_id_, osWaitForever);
+    uint8_t buff[MAX_LAZY_SIZE];
+    uint32_t sequence;
+    Read([&]() {
+      sequence = sequence_.load(std::memory_order_relaxed);
+      memcpy(buff, raw_, size_);
+    });
+    if(decoded_sequence_ != sequence)
+    {
+      const_cast<DataModule*>(this)->FromByteArray(buff);
+      decoded_sequence_ = sequence;
+    }
+    osMutexRelease(mutex_id_);
+  }
+  bool lazy_;
+  mutable uint32_t decoded_sequence_;              // sequence_ the members were decoded from
+  uint8_t raw_[MAX_LAZY_SIZE];                     // Last payload in lazy mode
 };
 
 } /* namespace DataModules */
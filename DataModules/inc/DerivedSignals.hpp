@@ -0,0 +1,130 @@
+/*
+ * DerivedSignals.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Signals computed on board from other modules, such as pack, solar and motor power
+ *               and the energy in and out of each. A derived signal is recomputed only when one of
+ *               its inputs has received a new frame since the last pass, and is a DataModule itself
+ *               so the UI and PitComms treat it like any other module.
+ */
+
+#ifndef SOLARGATORSBSP_DATAMODULES_INC_DERIVEDSIGNALS_HPP_
+#define SOLARGATORSBSP_DATAMODULES_INC_DERIVEDSIGNALS_HPP_
+
+#include <DataModule.hpp>
+#include <Mitsuba.hpp>
+#include <OrionBMS.hpp>
+#include <Proton1.hpp>
+#include <Units.hpp>
+#include <cstdint>
+
+namespace SolarGators::DataModules
+{
+  class DerivedSignal : public DataModule {
+  public:
+    DerivedSignal(uint32_t can_id, uint16_t telem_id, uint32_t size);
+    virtual ~DerivedSignal();
+    // Recomputes the signal if any input has been updated since the last call, returns true
+    // if it did. Only one task may call it, it is the writer for the module's seqlock.
+    bool Update();
+    static constexpr uint8_t MAX_INPUTS = 8;
+  protected:
+    bool AddInput(const DataModule& input);
+    // tick is the receive tick of the newest input frame, the module's rx tick becomes the same
+    virtual void Recompute(uint32_t tick) = 0;
+  private:
+    const DataModule* inputs_[MAX_INPUTS];
+    uint32_t seen_sequence_[MAX_INPUTS];           // Input sequence at the last recompute
+    uint8_t input_count_;
+  };
+
+  // Power with the energy it has moved, integrated with the trapezoid rule over the input
+  // receive ticks. Positive power is energy out (discharging the pack, driving the motor,
+  // producing from the array), negative is energy in.
+  class PowerSignal : public DerivedSignal {
+  public:
+    PowerSignal(uint32_t can_id, uint16_t telem_id);
+    virtual ~PowerSignal();
+    Units::Deciwatts GetPower() const;
+    Units::MilliwattHours GetEnergyOut() const;
+    Units::MilliwattHours GetEnergyIn() const;
+    void ResetEnergy();
+    // Frames further apart than this are a gap in the data and are not integrated across
+    void SetMaxGap(uint32_t ticks);
+    // Power, energy out and energy in as 32 bit little endian values. Larger than one classic
+    // CAN frame so it is meant for PitComms.
+    void ToByteArray(uint8_t* buff) const;
+    // Computed locally, there is nothing to decode
+    void FromByteArray(uint8_t* buff);
+    static constexpr uint8_t Size = 12;
+    static constexpr uint32_t DEFAULT_MAX_GAP = 2000;
+  protected:
+    virtual Units::Deciwatts ComputePower() const = 0;
+  private:
+    void Recompute(uint32_t tick) final;
+    Units::MilliwattHours ToEnergy(uint64_t area) const;
+    Units::Deciwatts power_;
+    uint32_t last_tick_;
+    bool primed_;                                  // power_ and last_tick_ hold a sample
+    uint32_t max_gap_;
+    // Twice the area under the power curve in deciwatt ticks, kept exact and only
+    // scaled to energy when read
+    uint64_t area_out_;
+    uint64_t area_in_;
+  };
+
+  // OrionBMSRx0 pack voltage times OrionBMSRx2 pack current
+  class PackPower final : public PowerSignal {
+  public:
+    PackPower(const OrionBMSRx0& voltage, const OrionBMSRx2& current, uint32_t can_id, uint16_t telem_id);
+    ~PackPower();
+  protected:
+    Units::Deciwatts ComputePower() const;
+  private:
+    const OrionBMSRx0& voltage_;
+    const OrionBMSRx2& current_;
+  };
+
+  // Array power summed over every MPPT added
+  class SolarPower final : public PowerSignal {
+  public:
+    SolarPower(uint32_t can_id, uint16_t telem_id);
+    ~SolarPower();
+    bool AddMppt(const Proton1& mppt);
+  protected:
+    Units::Deciwatts ComputePower() const;
+  private:
+    const Proton1* mppts_[MAX_INPUTS];
+    uint8_t mppt_count_;
+  };
+
+  // Motor controller input power from MitsubaRx0 battery voltage and current
+  class MotorPower final : public PowerSignal {
+  public:
+    MotorPower(const MitsubaRx0& motor, uint32_t can_id, uint16_t telem_id);
+    ~MotorPower();
+  protected:
+    Units::Deciwatts ComputePower() const;
+  private:
+    const MitsubaRx0& motor_;
+  };
+
+  // Runs Update on every derived signal in the order they were added, so a signal built on
+  // another derived signal sees it already updated. Call it from the task that owns the
+  // signals, e.g. when woken by CANDriver::Subscribe on the inputs or on a timer.
+  class DerivedSignalEngine {
+  public:
+    DerivedSignalEngine();
+    ~DerivedSignalEngine();
+    bool Add(DerivedSignal& signal);
+    // Returns how many signals were recomputed
+    uint8_t Update();
+    static constexpr uint8_t MAX_SIGNALS = 16;
+  private:
+    DerivedSignal* signals_[MAX_SIGNALS];
+    uint8_t signal_count_;
+  };
+}
+
+#endif /* SOLARGATORSBSP_DATAMODULES_INC_DERIVEDSIGNALS_HPP_ */
@@ -0,0 +1,107 @@
+/*
+ * FaultEngine.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Gathers the BMS, motor controller and steering faults into one vehicle fault word.
+ *               Each decoded frame is merged into the word and diffed against the previous one,
+ *               so an update costs the same few word operations however many faults there are.
+ *               Changes are queued as events for the UI and pit, and the module itself carries the
+ *               active word so it can be sent on CAN.
+ */
+
+#ifndef SOLARGATORSBSP_DATAMODULES_INC_FAULTENGINE_HPP_
+#define SOLARGATORSBSP_DATAMODULES_INC_FAULTENGINE_HPP_
+
+#include <DataModule.hpp>
+#include <Mitsuba.hpp>
+#include <OrionBMS.hpp>
+#include <Steering.hpp>
+#include <cstdint>
+
+namespace SolarGators::DataModules
+{
+  class FaultEngine final : public DataModule {
+  public:
+    // Bit layout of the vehicle fault word
+    static constexpr uint8_t BMS_SHIFT = 0;        // OrionBMSRx4 faults, 24 bits
+    static constexpr uint8_t MOTOR_SHIFT = 24;     // MitsubaRx2 faults, 28 bits
+    static constexpr uint8_t MOTOR_OVERHEAT_BIT = 52;  // MitsubaRx2 overheat level above 0
+    static constexpr uint8_t BPS_FAULT_BIT = 53;   // Steering BPS fault
+    static constexpr uint64_t BMS_FAULTS = static_cast<uint64_t>(0xFFFFFF) << BMS_SHIFT;
+    static constexpr uint64_t MOTOR_FAULTS = (static_cast<uint64_t>(MitsubaRx2::ALL_FAULTS) << MOTOR_SHIFT)
+                                             | (static_cast<uint64_t>(1) << MOTOR_OVERHEAT_BIT);
+    static constexpr uint64_t BPS_FAULT = static_cast<uint64_t>(1) << BPS_FAULT_BIT;
+    static constexpr uint64_t ALL_FAULTS = BMS_FAULTS | MOTOR_FAULTS | BPS_FAULT;
+    static constexpr uint64_t Bit(OrionBMSRx4::Fault fault)
+    {
+      return static_cast<uint64_t>(OrionBMSRx4::Faults::Mask(fault)) << BMS_SHIFT;
+    }
+    static constexpr uint64_t Bit(MitsubaRx2::Fault fault)
+    {
+      return static_cast<uint64_t>(MitsubaRx2::Faults::Mask(fault)) << MOTOR_SHIFT;
+    }
+    // Source group masks (OrionBMSRx4::THERMAL_FAULTS etc.) moved into the vehicle word
+    static constexpr uint64_t FromBms(uint32_t mask) { return static_cast<uint64_t>(mask) << BMS_SHIFT; }
+    static constexpr uint64_t FromMotor(uint32_t mask) { return static_cast<uint64_t>(mask) << MOTOR_SHIFT; }
+    enum class Severity : uint8_t {
+      None,
+      Info,
+      Warning,
+      Critical,
+      Shutdown
+    };
+    // A change in the active word. raised and cleared never share a bit.
+    struct Event {
+      uint64_t raised;
+      uint64_t cleared;
+      uint32_t tick;
+    };
+    static constexpr uint8_t MAX_EVENTS = 16;      // Power of two
+    static constexpr uint8_t EVENT_SIZE = 18;      // Encoded Event, for PitComms::SendBytes
+    static constexpr uint8_t Size = 8;
+    FaultEngine(uint32_t can_id, uint16_t telem_id);
+    ~FaultEngine();
+    // Call after the module has decoded a frame, e.g. from a task woken by CANDriver::Subscribe
+    void Update(const OrionBMSRx4& bms, uint32_t tick);
+    void Update(const MitsubaRx2& motor, uint32_t tick);
+    void Update(const Steering& steering, uint32_t tick);
+    // Every fault starts out at Info, later calls override earlier ones. Faults set to None
+    // never become active.
+    void SetSeverity(uint64_t mask, Severity severity);
+    Severity GetSeverity(uint8_t bit) const;
+    // A latched fault stays active after its source clears until it is acknowledged
+    void SetLatching(uint64_t mask, bool latching);
+    // Releases latched faults in mask whose source has cleared
+    void Acknowledge(uint64_t mask, uint32_t tick);
+    uint64_t GetActive() const;
+    uint64_t GetActive(Severity severity) const;   // Active faults of exactly this severity
+    uint64_t GetLatched() const;                   // Active only because they are latched
+    Severity GetHighestSeverity() const;
+    // Events are kept in a ring every reader walks with its own cursor. Start a reader at
+    // GetEventHead() and pass the cursor back in, a reader that falls more than MAX_EVENTS
+    // behind skips to the oldest event still held and dropped is set.
+    uint32_t GetEventHead() const;
+    bool ReadEvent(uint32_t& cursor, Event& event, bool& dropped) const;
+    static void EncodeEvent(const Event& event, uint8_t* buff);
+    // The active word, little endian
+    void ToByteArray(uint8_t* buff) const;
+    // A fault word received from another board is taken as the raw state of every fault
+    void FromByteArray(uint8_t* buff);
+  private:
+    static constexpr uint8_t SEVERITY_COUNT = static_cast<uint8_t>(Severity::Shutdown) + 1;
+    static constexpr uint8_t EVENT_MASK = MAX_EVENTS - 1;
+    static_assert((MAX_EVENTS & EVENT_MASK) == 0, "MAX_EVENTS must be a power of two");
+    void Apply(uint64_t source_mask, uint64_t bits, uint32_t tick);
+    void Publish(uint64_t active, uint32_t tick);
+    uint64_t raw_faults_;                          // Latest state reported by the sources
+    uint64_t latched_;
+    uint64_t active_;                              // raw_faults_ | latched_
+    uint64_t latch_mask_;
+    uint64_t severity_masks_[SEVERITY_COUNT];      // Faults at each severity, None are ignored
+    Event events_[MAX_EVENTS];
+    uint32_t event_head_;                          // Events ever published
+  };
+}
+
+#endif /* SOLARGATORSBSP_DATAMODULES_INC_FAULTENGINE_HPP_ */
@@ -0,0 +1,47 @@
+/*
+ * FaultSet.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Fault flags packed into one word, indexed by an enum whose values are bit
+ *               positions. Change detection is one compare and a count is one popcount.
+ */
+
+#ifndef SOLARGATORSBSP_DATAMODULES_INC_FAULTSET_HPP_
+#define SOLARGATORSBSP_DATAMODULES_INC_FAULTSET_HPP_
+
+#include <cstdint>
+
+namespace SolarGators::DataModules
+{
+  template <typename FAULT, typename WORD = uint32_t>
+  class FaultSet {
+  public:
+    constexpr FaultSet():bits_(0) { }
+    constexpr explicit FaultSet(WORD bits):bits_(bits) { }
+    static constexpr WORD Mask(FAULT fault)
+    {
+      return static_cast<WORD>(1) << static_cast<uint8_t>(fault);
+    }
+    template <typename... FAULTS>
+    static constexpr WORD Mask(FAULT fault, FAULTS... faults)
+    {
+      return (Mask(fault) | ... | Mask(faults));
+    }
+    constexpr WORD Bits() const { return bits_; }
+    constexpr bool Test(FAULT fault) const { return bits_ & Mask(fault); }
+    constexpr bool Any() const { return bits_ != 0; }
+    constexpr bool Any(WORD mask) const { return bits_ & mask; }
+    uint8_t Count() const { return __builtin_popcountll(bits_); }
+    // Faults that are set in one of the two sets but not the other
+    constexpr FaultSet Changed(FaultSet other) const { return FaultSet(bits_ ^ other.bits_); }
+    // Faults set here that aren't in other
+    constexpr FaultSet Raised(FaultSet other) const { return FaultSet(bits_ & ~other.bits_); }
+    constexpr bool operator==(FaultSet other) const { return bits_ == other.bits_; }
+    constexpr bool operator!=(FaultSet other) const { return bits_ != other.bits_; }
+  private:
+    WORD bits_;
+  };
+}
+
+#endif /* SOLARGATORSBSP_DATAMODULES_INC_FAULTSET_HPP_ */
@@ -0,0 +1,165 @@
+/*
+ * FieldCodec.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Compile time descriptions of the bit fields in a CAN payload. A module lists its
+ *               fields once and gets both ToByteArray and FromByteArray from them, instead of
+ *               hand writing the shifts and masks twice.
+ */
+
+#ifndef SOLARGATORSBSP_DATAMODULES_INC_FIELDCODEC_HPP_
+#define SOLARGATORSBSP_DATAMODULES_INC_FIELDCODEC_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <ratio>
+#include <type_traits>
+
+namespace SolarGators::DataModules
+{
+  // Byte order of a field, as in a DBC file
+  enum class Order : uint8_t {
+    Little,                                        // Intel, start is the least significant bit
+    Big                                            // Motorola, start is the most significant bit
+  };
+
+  // Bit n of byte b is bit b * 8 + n of the payload, the same numbering DBC start bits use
+  template <uint8_t START, uint8_t LENGTH, Order ORDER = Order::Little, bool SIGNED = false>
+  struct Field {
+    static_assert(LENGTH >= 1 && LENGTH <= 32, "Fields are 1 to 32 bits");
+    static_assert(START < 64, "Start bit is past the end of an 8 byte payload");
+    static_assert(ORDER == Order::Big || START + LENGTH <= 64, "Field runs past the end of an 8 byte payload");
+    static_assert(ORDER == Order::Little || (7 - START / 8) * 8 + START % 8 + 1 >= LENGTH,
+                  "Field runs past the end of an 8 byte payload");
+    using Raw = std::conditional_t<SIGNED, int32_t, uint32_t>;
+    // Little endian fields are read from the payload loaded as a little endian word, big endian
+    // fields from the same word byte swapped. Either way the field is contiguous and this is
+    // the position of its least significant bit.
+    static constexpr uint8_t SHIFT = ORDER == Order::Little ? START : (7 - START / 8) * 8 + START % 8 + 1 - LENGTH;
+    static constexpr uint64_t MASK = (static_cast<uint64_t>(1) << LENGTH) - 1;
+    static constexpr Raw Extract(uint64_t word)
+    {
+      uint32_t raw = static_cast<uint32_t>((word >> SHIFT) & MASK);
+      if constexpr (SIGNED)
+      {
+        uint32_t sign = static_cast<uint32_t>(1) << (LENGTH - 1);
+        return static_cast<int32_t>((raw ^ sign) - sign);
+      }
+      else
+      {
+        return raw;
+      }
+    }
+    // The field's bits in word must be clear, values too wide for the field are truncated
+    static constexpr uint64_t Insert(uint64_t word, Raw raw)
+    {
+      return word | ((static_cast<uint64_t>(static_cast<uint32_t>(raw)) & MASK) << SHIFT);
+    }
+  };
+
+  namespace CodecDetail
+  {
+    template <typename T>
+    struct MemberTraits;
+    template <typename C, typename T>
+    struct MemberTraits<T C::*> {
+      using Type = T;
+    };
+    constexpr uint64_t Swap(uint64_t word)
+    {
+      return __builtin_bswap64(word);
+    }
+  } /* namespace CodecDetail */
+
+  // Ties a field to a member. Floating point members hold the physical value, raw * SCALE.
+  // Integer and bool members hold the raw value and must keep the default scale.
+  template <auto MEMBER, uint8_t START, uint8_t LENGTH, Order ORDER = Order::Little, bool SIGNED = false,
+            typename SCALE = std::ratio<1>>
+  struct Bind {
+    using Layout = Field<START, LENGTH, ORDER, SIGNED>;
+    using Raw = typename Layout::Raw;
+    using Type = std::remove_cv_t<typename CodecDetail::MemberTraits<decltype(MEMBER)>::Type>;
+    static_assert(std::is_floating_point_v<Type> || std::ratio_equal_v<SCALE, std::ratio<1>>,
+                  "Only floating point members can be scaled");
+    static constexpr bool IS_BIG = ORDER == Order::Big;
+    // Bits the field takes up in the little endian payload word
+    static constexpr uint64_t PAYLOAD_MASK = IS_BIG ? CodecDetail::Swap(Layout::MASK << Layout::SHIFT)
+                                                    : Layout::MASK << Layout::SHIFT;
+    template <typename Module>
+    static void Decode(Module& module, uint64_t little, uint64_t big)
+    {
+      Raw raw = Layout::Extract(IS_BIG ? big : little);
+      if constexpr (std::is_floating_point_v<Type>)
+        module.*MEMBER = static_cast<Type>(raw) * (static_cast<Type>(SCALE::num) / SCALE::den);
+      else
+        module.*MEMBER = static_cast<Type>(raw);
+    }
+    template <typename Module>
+    static void Encode(const Module& module, uint64_t& little, uint64_t& big)
+    {
+      Raw raw;
+      if constexpr (std::is_floating_point_v<Type>)
+      {
+        // Round to the nearest step so a decoded value encodes back to the same bits
+        Type scaled = module.*MEMBER * (static_cast<Type>(SCALE::den) / SCALE::num);
+        raw = static_cast<Raw>(scaled + (scaled < 0 ? -0.5f : 0.5f));
+      }
+      else
+      {
+        raw = static_cast<Raw>(module.*MEMBER);
+      }
+      if constexpr (IS_BIG)
+        big = Layout::Insert(big, raw);
+      else
+        little = Layout::Insert(little, raw);
+    }
+  };
+
+  // A payload of SIZE bytes made of the BINDS. The payload is loaded or stored as one 64 bit
+  // word and every field is a shift and a mask on it. Targets are little endian.
+  template <uint8_t SIZE, typename... BINDS>
+  class Codec {
+  public:
+    static_assert(SIZE >= 1 && SIZE <= 8, "Codec payloads are 1 to 8 bytes");
+    template <typename Module>
+    static void Decode(Module& module, const uint8_t* buff)
+    {
+      uint64_t little = 0;
+      memcpy(&little, buff, SIZE);
+      uint64_t big = HAS_BIG ? CodecDetail::Swap(little) : 0;
+      (BINDS::Decode(module, little, big), ...);
+    }
+    // Bits no field covers are sent as 0
+    template <typename Module>
+    static void Encode(const Module& module, uint8_t* buff)
+    {
+      uint64_t little = 0;
+      uint64_t big = 0;
+      (BINDS::Encode(module, little, big), ...);
+      if constexpr (HAS_BIG)
+        little |= CodecDetail::Swap(big);
+      memcpy(buff, &little, SIZE);
+    }
+  private:
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "The payload word is loaded in native byte order");
+    static constexpr bool HAS_BIG = (BINDS::IS_BIG || ...);
+    static constexpr uint64_t SIZE_MASK = SIZE == 8 ? ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << (8 * SIZE)) - 1;
+    static constexpr bool Disjoint()
+    {
+      uint64_t masks[] = {0, BINDS::PAYLOAD_MASK...};
+      uint64_t seen = 0;
+      for (uint64_t mask : masks)
+      {
+        if(seen & mask)
+          return false;
+        seen |= mask;
+      }
+      return true;
+    }
+    static_assert(Disjoint(), "Fields overlap");
+    static_assert(((static_cast<uint64_t>(0) | ... | BINDS::PAYLOAD_MASK) & ~SIZE_MASK) == 0, "Field runs past the end of the payload");
+  };
+}
+
+#endif /* SOLARGATORSBSP_DATAMODULES_INC_FIELDCODEC_HPP_ */
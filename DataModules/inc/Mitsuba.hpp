@@ -9,6 +9,9 @@
 #define SOLARGATORSBSP_DATAMODULES_INC_MITSUBA_HPP_
 
 #include <DataModule.hpp>
+#include <FaultSet.hpp>
+#include <FieldCodec.hpp>
+#include <Units.hpp>
 
 namespace SolarGators {
 namespace DataModules {
@@ -28,6 +31,10 @@ protected:
   bool requestFrame0;
   bool requestFrame1;
   bool requestFrame2;
+  using Layout = Codec<Request_Size,
+    Bind<&MitsubaRequest::requestFrame0, 0, 1>,
+    Bind<&MitsubaRequest::requestFrame1, 1, 1>,
+    Bind<&MitsubaRequest::requestFrame2, 2, 1>>;
 };
 
 class MitsubaRx0 final: public DataModule
@@ -48,6 +55,10 @@ public:
   uint16_t GetMotorRPM() const;
   float GetPWMDuty() const;
   float GetLeadAngle() const;
+  // Integer versions, in the resolution the controller sends
+  Units::HalfVolts GetBatteryVoltageFixed() const;
+  Units::HalfPercents GetPWMDutyFixed() const;
+  Units::HalfDegrees GetLeadAngleFixed() const;
   // Converter Functions
   void ToByteArray(uint8_t* buff) const;
   void FromByteArray(uint8_t* buff);
@@ -61,6 +72,15 @@ protected:
   uint16_t motorRPM;
   uint16_t PWMDuty;
   uint8_t  LeadAngle;
+  using Layout = Codec<Rx0_Size,
+    Bind<&MitsubaRx0::battVoltage,        0, 10>,
+    Bind<&MitsubaRx0::battCurrent,       10,  9>,
+    Bind<&MitsubaRx0::battCurrentDir,    19,  1>,
+    Bind<&MitsubaRx0::motorCurrentPkAvg, 20, 10>,
+    Bind<&MitsubaRx0::FETtemp,           30,  5>,
+    Bind<&MitsubaRx0::motorRPM,          35, 12>,
+    Bind<&MitsubaRx0::PWMDuty,           47, 10>,
+    Bind<&MitsubaRx0::LeadAngle,         57,  7>>;
 };
 
 class MitsubaRx1 final: public DataModule
@@ -81,8 +101,13 @@ public:
   bool GetMcMode() const;
   float GetAcceleratorPosition() const;
   float GetRegenVrPosition() const;
+  Units::HalfPercents GetAcceleratorPositionFixed() const;
+  Units::HalfPercents GetRegenVrPositionFixed() const;
   uint8_t GetDigitSwitchPosition()const;
   float GetOutTargetVal() const;
+  // Integer versions of GetOutTargetVal, the target is a current in Current mode and a duty in PWM mode
+  Units::HalfAmps GetOutTargetCurrentFixed() const;
+  Units::HalfPercents GetOutTargetDutyFixed() const;
   enum DriveAction {
     Reserved = 0,
     Forward = 1,
@@ -103,57 +128,76 @@ protected:
   uint16_t outTargetVal;
   uint8_t  driveActStat;
   bool   regenStat;
+  using Layout = Codec<Rx1_Size,
+    Bind<&MitsubaRx1::powerMode,            0,  1>,
+    Bind<&MitsubaRx1::MCmode,               1,  1>,
+    Bind<&MitsubaRx1::AcceleratorPosition,  2, 10>,
+    Bind<&MitsubaRx1::regenVRposition,     12, 10>,
+    Bind<&MitsubaRx1::digitSWposition,     22,  4>,
+    Bind<&MitsubaRx1::outTargetVal,        26, 10>,
+    Bind<&MitsubaRx1::driveActStat,        36,  2>,
+    Bind<&MitsubaRx1::regenStat,           38,  1>>;
 };
 
+// name, getter, bit in the frame
+#define MITSUBA_RX2_FAULTS(X) \
+  X(AdSensor,            GetAdSensorError,            0) \
+  X(MotorCurrSensorU,    GetMotorSensorUError,        1) \
+  X(MotorCurrSensorW,    GetMotorCurrSensorWError,    2) \
+  X(FetTherm,            GetFetThermError,            3) \
+  X(BattVoltSensor,      GetBattVoltSensorError,      5) \
+  X(BattCurrSensor,      GetBattCurrSensorError,      6) \
+  X(BattCurrSensorAdj,   GetBattCurrSensorAdjError,   7) \
+  X(MotorCurrSensorAdj,  GetMotorCurrSensorAdjError,  8) \
+  X(AccelPos,            GetAccelPosError,            9) \
+  X(ContVoltSensor,      GetContVoltSensorError,     11) \
+  X(PowerSystem,         GetPowerSystemError,        16) \
+  X(OverCurr,            GetOverCurrError,           17) \
+  X(OverVolt,            GetOverVoltError,           19) \
+  X(OverCurrLimit,       GetOverCurrLimit,           21) \
+  X(MotorSystem,         GetMotorSystemError,        24) \
+  X(MotorLock,           GetMotorLock,               25) \
+  X(HallSensorShort,     GetHallSensorShort,         26) \
+  X(HallSensorOpen,      GetHallSensorOpen,          27)
+
 class MitsubaRx2 final: public DataModule
 {
 public:
   MitsubaRx2(uint32_t can_id, uint16_t telem_id);
   virtual ~MitsubaRx2();
+  enum class Fault : uint8_t {
+#define MITSUBA_RX2_ENUM(name, getter, bit) name = bit,
+    MITSUBA_RX2_FAULTS(MITSUBA_RX2_ENUM)
+#undef MITSUBA_RX2_ENUM
+  };
+  using Faults = FaultSet<Fault>;
+#define MITSUBA_RX2_MASK(name, getter, bit) | Faults::Mask(Fault::name)
+  static constexpr uint32_t ALL_FAULTS = 0 MITSUBA_RX2_FAULTS(MITSUBA_RX2_MASK);
+#undef MITSUBA_RX2_MASK
+  static constexpr uint32_t SENSOR_FAULTS = Faults::Mask(Fault::AdSensor, Fault::MotorCurrSensorU,
+      Fault::MotorCurrSensorW, Fault::BattVoltSensor, Fault::BattCurrSensor, Fault::BattCurrSensorAdj,
+      Fault::MotorCurrSensorAdj, Fault::AccelPos, Fault::ContVoltSensor, Fault::HallSensorShort,
+      Fault::HallSensorOpen);
+  static constexpr uint32_t POWER_FAULTS = Faults::Mask(Fault::PowerSystem, Fault::OverCurr, Fault::OverVolt,
+      Fault::OverCurrLimit);
+  static constexpr uint32_t MOTOR_FAULTS = Faults::Mask(Fault::MotorSystem, Fault::MotorLock);
+  static constexpr uint32_t THERMAL_FAULTS = Faults::Mask(Fault::FetTherm);
   // Getters
-  bool GetAdSensorError() const;
-  bool GetMotorSensorUError() const;
-  bool GetMotorCurrSensorWError() const;
-  bool GetFetThermError() const;
-  bool GetBattVoltSensorError() const;
-  bool GetBattCurrSensorError() const;
-  bool GetBattCurrSensorAdjError() const;
-  bool GetMotorCurrSensorAdjError() const;
-  bool GetAccelPosError() const;
-  bool GetContVoltSensorError() const;
-  bool GetPowerSystemError() const;
-  bool GetOverCurrError() const;
-  bool GetOverVoltError() const;
-  bool GetOverCurrLimit() const;
-  bool GetMotorSystemError() const;
-  bool GetMotorLock() const;
-  bool GetHallSensorShort() const;
-  bool GetHallSensorOpen() const;
+  Faults GetFaults() const;
+#define MITSUBA_RX2_GETTER(name, getter, bit) bool getter() const;
+  MITSUBA_RX2_FAULTS(MITSUBA_RX2_GETTER)
+#undef MITSUBA_RX2_GETTER
   uint8_t GetOverHeatLevel() const;
   // Converter Functions
   void ToByteArray(uint8_t* buff) const;
   void FromByteArray(uint8_t* buff);
   static constexpr uint8_t Rx2_Size = 5;
 protected:
-  bool adSensorError;
-  bool motorCurrSensorUError;
-  bool motorCurrSensorWError;
-  bool fetThermError;
-  bool battVoltSensorError;
-  bool battCurrSensorError;
-  bool battCurrSensorAdjError;
-  bool motorCurrSensorAdjError;
-  bool accelPosError;
-  bool contVoltSensorError;
-  bool powerSystemError;
-  bool overCurrError;
-  bool overVoltError;
-  bool overCurrLimit;
-  bool motorSystemError;
-  bool motorLock;
-  bool hallSensorShort;
-  bool hallSensorOpen;
+  uint32_t faults_;                                // Bit per Fault, reserved bits cleared
   uint8_t overHeatLevel;
+  using Layout = Codec<Rx2_Size,
+    Bind<&MitsubaRx2::faults_,         0, 28>,
+    Bind<&MitsubaRx2::overHeatLevel,  32,  2>>;
 };
 
 } /* namespace DataModules */
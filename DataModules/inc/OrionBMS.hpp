@@ -9,6 +9,9 @@
 #define SOLARGATORSBSP_DATAMODULES_INC_ORIONBMS_HPP_
 
 #include <DataModule.hpp>
+#include <FaultSet.hpp>
+#include <FieldCodec.hpp>
+#include <Units.hpp>
 
 namespace SolarGators::DataModules
 {
@@ -25,6 +28,12 @@ namespace SolarGators::DataModules
     float getHighCellVolt() const;
     float getLowCellVolt() const;
     float getPackSumVolt() const;
+    // Integer versions of the getters above, in the resolution the BMS sends
+    using CellVolts = Units::Quantity<Units::Volt, std::ratio<1, 10000>>;
+    CellVolts getAvgCellVoltFixed() const;
+    CellVolts getHighCellVoltFixed() const;
+    CellVolts getLowCellVoltFixed() const;
+    Units::Centivolts getPackSumVoltFixed() const;
 
     static constexpr uint8_t Size = 8;
   protected:
@@ -32,6 +41,11 @@ namespace SolarGators::DataModules
     uint16_t high_cell_volt_;
     uint16_t avg_cell_volt_;
     uint16_t pack_sum_volt_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx0::low_cell_volt_,   7, 16, Order::Big>,
+      Bind<&OrionBMSRx0::high_cell_volt_, 23, 16, Order::Big>,
+      Bind<&OrionBMSRx0::avg_cell_volt_,  39, 16, Order::Big>,
+      Bind<&OrionBMSRx0::pack_sum_volt_,  55, 16, Order::Big>>;
   };
 
   class OrionBMSRx1 final: public DataModule
@@ -44,7 +58,7 @@ namespace SolarGators::DataModules
     void FromByteArray(uint8_t* buff);
 
     uint8_t getAvgTemp() const;
-    uint8_t getConstantVal() const;
+    uint16_t getConstantVal() const;
     uint8_t getHighTemp() const;
     uint8_t getHighTempId() const;
     uint8_t getInternalTemp() const;
@@ -59,7 +73,15 @@ namespace SolarGators::DataModules
     uint8_t low_temp_id_;
     uint8_t avg_temp_;
     uint8_t internal_temp_;
-    uint8_t constant_val_;
+    uint16_t constant_val_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx1::high_temp_,      0,  8>,
+      Bind<&OrionBMSRx1::high_temp_id_,   8,  8>,
+      Bind<&OrionBMSRx1::low_temp_,      16,  8>,
+      Bind<&OrionBMSRx1::low_temp_id_,   24,  8>,
+      Bind<&OrionBMSRx1::avg_temp_,      32,  8>,
+      Bind<&OrionBMSRx1::internal_temp_, 40,  8>,
+      Bind<&OrionBMSRx1::constant_val_,  55, 16, Order::Big>>;
   };
 
   class OrionBMSRx2 final: public DataModule
@@ -75,6 +97,7 @@ namespace SolarGators::DataModules
     uint16_t getPackCcl() const;
     float getPackCurrent() const;
     uint16_t getPackDcl() const;
+    Units::Deciamps getPackCurrentFixed() const;
 
     static constexpr uint8_t Size = 8;
   protected:
@@ -82,6 +105,11 @@ namespace SolarGators::DataModules
     uint16_t pack_ccl_;
     int16_t pack_current_;
     uint16_t constant_val_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx2::pack_dcl_,      7, 16, Order::Big>,
+      Bind<&OrionBMSRx2::pack_ccl_,     23, 16, Order::Big>,
+      Bind<&OrionBMSRx2::pack_current_, 39, 16, Order::Big, true>,
+      Bind<&OrionBMSRx2::constant_val_, 55, 16, Order::Big>>;
   };
 
   class OrionBMSRx3 final: public DataModule
@@ -96,14 +124,50 @@ namespace SolarGators::DataModules
     float getHighCellRes() const;
     float getLowCellRes() const;
     float getPackRes() const;
+    // Integer versions, cells in the hundredths of a milliohm the BMS sends and the pack in milliohms
+    using CellOhms = Units::Quantity<Units::Ohm, std::ratio<1, 100000>>;
+    CellOhms getHighCellResFixed() const;
+    CellOhms getLowCellResFixed() const;
+    Units::Milliohms getPackResFixed() const;
 
     static constexpr uint8_t Size = 6;
   protected:
     uint16_t low_cell_res_;
     uint16_t high_cell_res_;
     uint16_t pack_res_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx3::low_cell_res_,   7, 16, Order::Big>,
+      Bind<&OrionBMSRx3::high_cell_res_, 23, 16, Order::Big>,
+      Bind<&OrionBMSRx3::pack_res_,      39, 16, Order::Big>>;
   };
 
+  // name, getter, bit in the frame
+  #define ORION_BMS_RX4_FAULTS(X) \
+    X(InternalCellCommunication,   isInternalCellCommunicationFault,   0) \
+    X(CellBalancingStuckOff,       isCellBalancingStuckOffFault,       1) \
+    X(WeakCell,                    isWeakCellFault,                    2) \
+    X(LowCellVoltage,              isLowCellVoltageFault,              3) \
+    X(CellOpenWiring,              isCellOpenWiringFault,              4) \
+    X(CurrentSensor,               isCurrentSensorFault,               5) \
+    X(CellVoltageOver5v,           isCellVoltageOver5vFault,           6) \
+    X(CellBank,                    isCellBankFault,                    7) \
+    X(WeakPack,                    isWeakPackFault,                    8) \
+    X(FanMonitor,                  isFanMonitorFault,                  9) \
+    X(Thermistor,                  isThermistorFault,                 10) \
+    X(CanCommunication,            isCanCommunicationFault,           11) \
+    X(RedundantPowerSupply,        isRedundantPowerSupplyFault,       12) \
+    X(HighVoltageIsolation,        isHighVoltageIsolationFault,       13) \
+    X(InvalidInputSupplyVoltage,   isInvalidInputSupplyVoltageFault,  14) \
+    X(ChargeenableRelay,           isChargeenableRelayFault,          15) \
+    X(DischargeenableRelay,        isDischargeenableRelayFault,       16) \
+    X(ChargerSafetyRelay,          isChargerSafetyRelayFault,         17) \
+    X(InternalHardware,            isInternalHardwareFault,           18) \
+    X(InternalHeatsinkThermistor,  isInternalHeatsinkThermistorFault, 19) \
+    X(InternalLogic,               isInternalLogicFault,              20) \
+    X(HighestCellVoltageTooHigh,   isHighestCellVoltageTooHighFault,  21) \
+    X(LowestCellVoltageTooLow,     isLowestCellVoltageTooLowFault,    22) \
+    X(PackTooHot,                  isPackTooHotFault,                 23)
+
   class OrionBMSRx4 final: public DataModule
   {
   public:
@@ -113,59 +177,35 @@ namespace SolarGators::DataModules
     void ToByteArray(uint8_t* buff) const;
     void FromByteArray(uint8_t* buff);
 
-    bool isCanCommunicationFault() const;
-    bool isCellBalancingStuckOffFault() const;
-    bool isCellBankFault() const;
-    bool isCellOpenWiringFault() const;
-    bool isCellVoltageOver5vFault() const;
-    bool isChargeenableRelayFault() const;
-    bool isChargerSafetyRelayFault() const;
-    bool isCurrentSensorFault() const;
-    bool isDischargeenableRelayFault() const;
-    bool isFanMonitorFault() const;
-    bool isHighVoltageIsolationFault() const;
-    bool isHighestCellVoltageTooHighFault() const;
-    bool isInternalCellCommunicationFault() const;
-    bool isInternalHardwareFault() const;
-    bool isInternalHeatsinkThermistorFault() const;
-    bool isInternalLogicFault() const;
-    bool isInvalidInputSupplyVoltageFault() const;
-    bool isLowCellVoltageFault() const;
-    bool isLowestCellVoltageTooLowFault() const;
-    bool isPackTooHotFault() const;
-    bool isRedundantPowerSupplyFault() const;
-    bool isThermistorFault() const;
-    bool isWeakCellFault() const;
-    bool isWeakPackFault() const;
+    enum class Fault : uint8_t {
+#define ORION_BMS_RX4_ENUM(name, getter, bit) name = bit,
+      ORION_BMS_RX4_FAULTS(ORION_BMS_RX4_ENUM)
+#undef ORION_BMS_RX4_ENUM
+    };
+    using Faults = FaultSet<Fault>;
+    static constexpr uint32_t THERMAL_FAULTS = Faults::Mask(Fault::FanMonitor, Fault::Thermistor,
+        Fault::InternalHeatsinkThermistor, Fault::PackTooHot);
+    static constexpr uint32_t CELL_VOLTAGE_FAULTS = Faults::Mask(Fault::WeakCell, Fault::LowCellVoltage,
+        Fault::CellVoltageOver5v, Fault::HighestCellVoltageTooHigh, Fault::LowestCellVoltageTooLow);
+    static constexpr uint32_t RELAY_FAULTS = Faults::Mask(Fault::ChargeenableRelay, Fault::DischargeenableRelay,
+        Fault::ChargerSafetyRelay);
+    static constexpr uint32_t COMMUNICATION_FAULTS = Faults::Mask(Fault::InternalCellCommunication,
+        Fault::CanCommunication);
+    Faults getFaults() const;
+
+#define ORION_BMS_RX4_GETTER(name, getter, bit) bool getter() const;
+    ORION_BMS_RX4_FAULTS(ORION_BMS_RX4_GETTER)
+#undef ORION_BMS_RX4_GETTER
     float getPackSoc() const;
+    Units::HalfPercents getPackSocFixed() const;
 
     static constexpr uint8_t Size = 4;
   protected:
-    bool internal_cell_communication_fault_;
-    bool cell_balancing_stuck_off_fault_;
-    bool weak_cell_fault_;
-    bool low_cell_voltage_fault_;
-    bool cell_open_wiring_fault_;
-    bool current_sensor_fault_;
-    bool cell_voltage_over_5v_fault_;
-    bool cell_bank_fault_;
-    bool weak_pack_fault_;
-    bool fan_monitor_fault_;
-    bool thermistor_fault_;
-    bool can_communication_fault_;
-    bool redundant_power_supply_fault_;
-    bool high_voltage_isolation_fault_;
-    bool invalid_input_supply_voltage_fault_;
-    bool chargeenable_relay_fault_;
-    bool dischargeenable_relay_fault_;
-    bool charger_safety_relay_fault_;
-    bool internal_hardware_fault_;
-    bool internal_heatsink_thermistor_fault_;
-    bool internal_logic_fault_;
-    bool highest_cell_voltage_too_high_fault_;
-    bool lowest_cell_voltage_too_low_fault_;
-    bool pack_too_hot_fault_;
+    uint32_t faults_;                              // Bit per Fault
     uint8_t pack_soc_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx4::faults_,    0, 24>,
+      Bind<&OrionBMSRx4::pack_soc_, 24,  8>>;
   };
 
   class OrionBMSRx5 final: public DataModule
@@ -181,6 +221,8 @@ namespace SolarGators::DataModules
     uint16_t getMaxPackDcl() const;
     float getMaxPackVolt() const;
     float getMinPackVolt() const;
+    Units::Decivolts getMaxPackVoltFixed() const;
+    Units::Decivolts getMinPackVoltFixed() const;
 
     static constexpr uint8_t Size = 8;
   protected:
@@ -188,6 +230,11 @@ namespace SolarGators::DataModules
     uint16_t max_pack_ccl_;
     uint16_t max_pack_volt_;
     uint16_t min_pack_volt_;
+    using Layout = Codec<Size,
+      Bind<&OrionBMSRx5::max_pack_dcl_,   7, 16, Order::Big>,
+      Bind<&OrionBMSRx5::max_pack_ccl_,  23, 16, Order::Big>,
+      Bind<&OrionBMSRx5::max_pack_volt_, 39, 16, Order::Big>,
+      Bind<&OrionBMSRx5::min_pack_volt_, 55, 16, Order::Big>>;
   };
 
 }
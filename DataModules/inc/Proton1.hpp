@@ -9,6 +9,8 @@
 #define SOLARGATORSBSP_DATAMODULES_INC_PROTON1_HPP_
 
 #include <DataModule.hpp>
+#include <FieldCodec.hpp>
+#include <Units.hpp>
 
 namespace SolarGators {
 namespace DataModules {
@@ -18,19 +20,30 @@ public:
   Proton1(uint32_t id);
   virtual ~Proton1();
   // Getters
-  float getArrayVoltage();
-  float getArrayCurrent();
-  float getBatteryVoltage();
-  float getMpptTemperature();
+  float getArrayVoltage() const;
+  float getArrayCurrent() const;
+  float getBatteryVoltage() const;
+  float getMpptTemperature() const;
+  // Integer versions, in the resolution the MPPT sends
+  Units::Centivolts getArrayVoltageFixed() const;
+  Units::Centiamps getArrayCurrentFixed() const;
+  Units::Centivolts getBatteryVoltageFixed() const;
+  Units::CentidegreesC getMpptTemperatureFixed() const;
   // Converter Functions
   void ToByteArray(uint8_t* buff) const;
   void FromByteArray(uint8_t* buff);
-
+  static constexpr uint8_t Mppt_Size = 8;
 protected:
-  float arrayVoltage;
-  float arrayCurrent;
-  float batteryVoltage;
-  float mpptTemperature;
+  // Raw 0.01 per bit, scaled in the getters so decoding needs no floating point
+  uint16_t arrayVoltage;
+  uint16_t arrayCurrent;
+  uint16_t batteryVoltage;
+  uint16_t mpptTemperature;
+  using Layout = Codec<Mppt_Size,
+    Bind<&Proton1::arrayVoltage,     0, 16>,
+    Bind<&Proton1::arrayCurrent,    16, 16>,
+    Bind<&Proton1::batteryVoltage,  32, 16>,
+    Bind<&Proton1::mpptTemperature, 48, 16>>;
 };
 
 } /* namespace DataModules */
@@ -9,6 +9,7 @@
 #define SOLARGATORSBSP_DATAMODULES_INC_STEERING_HPP_
 
 #include <DataModule.hpp>
+#include <FieldCodec.hpp>
 #include <cstdint>
 
 namespace SolarGators::DataModules
@@ -31,6 +32,7 @@ namespace SolarGators::DataModules
     void FromByteArray(uint8_t* buff);
     static constexpr uint8_t Max_Cruise_Speed_ = 60;
     static constexpr uint8_t Min_Cruise_Speed_ = 0;
+    static constexpr uint8_t Size = 3;
   protected:
     bool left_turn_;
     bool right_turn_;
@@ -42,6 +44,17 @@ namespace SolarGators::DataModules
     bool horn_;
     bool reverse_;
     uint8_t cruise_speed_;
+    using Layout = Codec<Size,
+      Bind<&Steering::left_turn_,      0, 1>,
+      Bind<&Steering::right_turn_,     1, 1>,
+      Bind<&Steering::hazards_,        2, 1>,
+      Bind<&Steering::bps_fault_,      3, 1>,
+      Bind<&Steering::cruise_enable_,  4, 1>,
+      Bind<&Steering::eco_enable_,     5, 1>,
+      Bind<&Steering::headlights_,     6, 1>,
+      Bind<&Steering::horn_,           7, 1>,
+      Bind<&Steering::reverse_,        8, 1>,
+      Bind<&Steering::cruise_speed_,  16, 8>>;
   };
 }
 
@@ -0,0 +1,86 @@
+/*
+ * Units.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Integer quantities tagged with their unit and step size, for reading signals
+ *               without floating point. The boards are Cortex-M0 parts with no FPU, where every
+ *               float or double operation is a library call.
+ */
+
+#ifndef SOLARGATORSBSP_DATAMODULES_INC_UNITS_HPP_
+#define SOLARGATORSBSP_DATAMODULES_INC_UNITS_HPP_
+
+#include <cstdint>
+#include <ratio>
+
+namespace SolarGators::DataModules::Units
+{
+  struct Volt {};
+  struct Amp {};
+  struct Ohm {};
+  struct Celsius {};
+  struct Percent {};
+  struct Degree {};
+  struct Rpm {};
+  struct Watt {};
+  struct WattHour {};
+
+  // count steps of RATIO units, Quantity<Volt, std::milli>(1500) is 1.5V
+  template <typename UNIT, typename RATIO>
+  class Quantity {
+  public:
+    using Unit = UNIT;
+    using Ratio = RATIO;
+    constexpr Quantity():count_(0) { }
+    constexpr explicit Quantity(int32_t count):count_(count) { }
+    constexpr int32_t Count() const { return count_; }
+    // Converts to another step size of the same unit, rounding toward zero when it is coarser.
+    // Steps that divide evenly are a single multiply or divide.
+    template <typename TO_RATIO>
+    constexpr Quantity<UNIT, TO_RATIO> To() const
+    {
+      using Factor = std::ratio_divide<RATIO, TO_RATIO>;
+      if constexpr (Factor::den == 1)
+        return Quantity<UNIT, TO_RATIO>(count_ * static_cast<int32_t>(Factor::num));
+      else if constexpr (Factor::num == 1)
+        return Quantity<UNIT, TO_RATIO>(count_ / static_cast<int32_t>(Factor::den));
+      else
+        return Quantity<UNIT, TO_RATIO>(static_cast<int32_t>(static_cast<int64_t>(count_) * Factor::num / Factor::den));
+    }
+    constexpr Quantity operator+(Quantity other) const { return Quantity(count_ + other.count_); }
+    constexpr Quantity operator-(Quantity other) const { return Quantity(count_ - other.count_); }
+    constexpr Quantity operator-() const { return Quantity(-count_); }
+    constexpr Quantity operator*(int32_t factor) const { return Quantity(count_ * factor); }
+    constexpr bool operator==(Quantity other) const { return count_ == other.count_; }
+    constexpr bool operator!=(Quantity other) const { return count_ != other.count_; }
+    constexpr bool operator<(Quantity other) const { return count_ < other.count_; }
+    constexpr bool operator<=(Quantity other) const { return count_ <= other.count_; }
+    constexpr bool operator>(Quantity other) const { return count_ > other.count_; }
+    constexpr bool operator>=(Quantity other) const { return count_ >= other.count_; }
+  private:
+    int32_t count_;
+  };
+
+  using Volts = Quantity<Volt, std::ratio<1>>;
+  using HalfVolts = Quantity<Volt, std::ratio<1, 2>>;
+  using Decivolts = Quantity<Volt, std::deci>;
+  using Centivolts = Quantity<Volt, std::centi>;
+  using Millivolts = Quantity<Volt, std::milli>;
+  using Amps = Quantity<Amp, std::ratio<1>>;
+  using HalfAmps = Quantity<Amp, std::ratio<1, 2>>;
+  using Deciamps = Quantity<Amp, std::deci>;
+  using Centiamps = Quantity<Amp, std::centi>;
+  using Milliamps = Quantity<Amp, std::milli>;
+  using Milliohms = Quantity<Ohm, std::milli>;
+  using DegreesC = Quantity<Celsius, std::ratio<1>>;
+  using CentidegreesC = Quantity<Celsius, std::centi>;
+  using Percents = Quantity<Percent, std::ratio<1>>;
+  using HalfPercents = Quantity<Percent, std::ratio<1, 2>>;
+  using HalfDegrees = Quantity<Degree, std::ratio<1, 2>>;
+  using Rpms = Quantity<Rpm, std::ratio<1>>;
+  using Deciwatts = Quantity<Watt, std::deci>;
+  using MilliwattHours = Quantity<WattHour, std::milli>;
+}
+
+#endif /* SOLARGATORSBSP_DATAMODULES_INC_UNITS_HPP_ */
@@ -0,0 +1,252 @@
+/*
+ * DerivedSignals.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include "DerivedSignals.hpp"
+
+namespace SolarGators::DataModules
+{
+  DerivedSignal::DerivedSignal(uint32_t can_id, uint16_t telem_id, uint32_t size):
+    DataModule(can_id, telem_id, size),
+    inputs_{},
+    seen_sequence_{},
+    input_count_(0)
+  {}
+  DerivedSignal::~DerivedSignal()
+  {}
+  bool DerivedSignal::Update()
+  {
+    bool changed = false;
+    uint32_t tick = 0;
+    for (uint8_t i = 0; i < input_count_; ++i)
+    {
+      uint32_t sequence = inputs_[i]->GetSequence();
+      if(sequence == seen_sequence_[i])
+        continue;
+      seen_sequence_[i] = sequence;
+      uint32_t rx_tick = inputs_[i]->GetRxTick();
+      if(!changed || static_cast<int32_t>(rx_tick - tick) > 0)
+        tick = rx_tick;
+      changed = true;
+    }
+    if(!changed)
+      return false;
+    BeginUpdate();
+    Recompute(tick);
+    EndUpdate(tick);
+    return true;
+  }
+  // Frames the input already had when it was added don't trigger a recompute
+  bool DerivedSignal::AddInput(const DataModule& input)
+  {
+    if(input_count_ >= MAX_INPUTS)
+      return false;
+    inputs_[input_count_] = &input;
+    seen_sequence_[input_count_] = input.GetSequence();
+    ++input_count_;
+    return true;
+  }
+
+  PowerSignal::PowerSignal(uint32_t can_id, uint16_t telem_id):
+    DerivedSignal(can_id, telem_id, Size),
+    power_(0),
+    last_tick_(0),
+    primed_(false),
+    max_gap_(DEFAULT_MAX_GAP),
+    area_out_(0),
+    area_in_(0)
+  {}
+  PowerSignal::~PowerSignal()
+  {}
+  // Getters go through the seqlock, the areas are two loads each on the M0 and would
+  // tear against a recompute on the Update task
+  Units::Deciwatts PowerSignal::GetPower() const
+  {
+    Units::Deciwatts power;
+    Read([&]() { power = power_; });
+    return power;
+  }
+  Units::MilliwattHours PowerSignal::GetEnergyOut() const
+  {
+    uint64_t area;
+    Read([&]() { area = area_out_; });
+    return ToEnergy(area);
+  }
+  Units::MilliwattHours PowerSignal::GetEnergyIn() const
+  {
+    uint64_t area;
+    Read([&]() { area = area_in_; });
+    return ToEnergy(area);
+  }
+  // Call from the task running Update
+  void PowerSignal::ResetEnergy()
+  {
+    BeginUpdate();
+    area_out_ = 0;
+    area_in_ = 0;
+    EndUpdate(GetRxTick());
+  }
+  void PowerSignal::SetMaxGap(uint32_t ticks)
+  {
+    max_gap_ = ticks;
+  }
+  void PowerSignal::ToByteArray(uint8_t* buff) const
+  {
+    int32_t power;
+    uint64_t area_out;
+    uint64_t area_in;
+    Read([&]() {
+      power = power_.Count();
+      area_out = area_out_;
+      area_in = area_in_;
+    });
+    uint32_t values[] = {static_cast<uint32_t>(power),
+                         static_cast<uint32_t>(ToEnergy(area_out).Count()),
+                         static_cast<uint32_t>(ToEnergy(area_in).Count())};
+    for (uint8_t i = 0; i < 3; ++i)
+    {
+      buff[4 * i]     = values[i] & 0xFF;
+      buff[4 * i + 1] = (values[i] >> 8) & 0xFF;
+      buff[4 * i + 2] = (values[i] >> 16) & 0xFF;
+      buff[4 * i + 3] = values[i] >> 24;
+    }
+  }
+  void PowerSignal::FromByteArray(uint8_t*)
+  { }
+  void PowerSignal::Recompute(uint32_t tick)
+  {
+    int64_t previous = power_.Count();
+    Units::Deciwatts power = ComputePower();
+    int64_t current = power.Count();
+    uint32_t ticks = tick - last_tick_;
+    if(primed_ && ticks <= max_gap_)
+    {
+      if(previous >= 0 && current >= 0)
+      {
+        area_out_ += (previous + current) * ticks;
+      }
+      else if(previous <= 0 && current <= 0)
+      {
+        area_in_ -= (previous + current) * ticks;
+      }
+      else
+      {
+        // Crosses zero, split at the crossing of the line between the two samples
+        int64_t high = previous > 0 ? previous : current;
+        int64_t low = previous > 0 ? -current : -previous;
+        area_out_ += high * high * ticks / (high + low);
+        area_in_ += low * low * ticks / (high + low);
+      }
+    }
+    power_ = power;
+    last_tick_ = tick;
+    primed_ = true;
+  }
+  // area is 2 * dW * ticks, so mWh = area * 100 / (2 * 3600 * tick_freq)
+  Units::MilliwattHours PowerSignal::ToEnergy(uint64_t area) const
+  {
+    return Units::MilliwattHours(static_cast<int32_t>(area / (72ull * osKernelGetTickFreq())));
+  }
+
+  PackPower::PackPower(const OrionBMSRx0& voltage, const OrionBMSRx2& current, uint32_t can_id, uint16_t telem_id):
+    PowerSignal(can_id, telem_id),
+    voltage_(voltage),
+    current_(current)
+  {
+    AddInput(voltage_);
+    AddInput(current_);
+  }
+  PackPower::~PackPower()
+  {}
+  Units::Deciwatts PackPower::ComputePower() const
+  {
+    int32_t volts;
+    int32_t amps;
+    voltage_.Read([&]() { volts = voltage_.getPackSumVoltFixed().Count(); });
+    current_.Read([&]() { amps = current_.getPackCurrentFixed().Count(); });
+    // Centivolts times deciamps is milliwatts
+    return Units::Deciwatts(static_cast<int32_t>(static_cast<int64_t>(volts) * amps / 100));
+  }
+
+  SolarPower::SolarPower(uint32_t can_id, uint16_t telem_id):
+    PowerSignal(can_id, telem_id),
+    mppts_{},
+    mppt_count_(0)
+  {}
+  SolarPower::~SolarPower()
+  {}
+  bool SolarPower::AddMppt(const Proton1& mppt)
+  {
+    if(!AddInput(mppt))
+      return false;
+    mppts_[mppt_count_++] = &mppt;
+    return true;
+  }
+  Units::Deciwatts SolarPower::ComputePower() const
+  {
+    int64_t total = 0;
+    for (uint8_t i = 0; i < mppt_count_; ++i)
+    {
+      const Proton1& mppt = *mppts_[i];
+      int32_t volts;
+      int32_t amps;
+      mppt.Read([&]() {
+        volts = mppt.getArrayVoltageFixed().Count();
+        amps = mppt.getArrayCurrentFixed().Count();
+      });
+      total += static_cast<int64_t>(volts) * amps;
+    }
+    // Centivolts times centiamps is 0.1mW
+    return Units::Deciwatts(static_cast<int32_t>(total / 1000));
+  }
+
+  MotorPower::MotorPower(const MitsubaRx0& motor, uint32_t can_id, uint16_t telem_id):
+    PowerSignal(can_id, telem_id),
+    motor_(motor)
+  {
+    AddInput(motor_);
+  }
+  MotorPower::~MotorPower()
+  {}
+  Units::Deciwatts MotorPower::ComputePower() const
+  {
+    int32_t half_volts;
+    int32_t amps;
+    bool charging;
+    motor_.Read([&]() {
+      half_volts = motor_.GetBatteryVoltageFixed().Count();
+      amps = motor_.GetBatteryCurrent();
+      charging = motor_.GetBatteryCurrentDir() == MitsubaRx0::Charging;
+    });
+    // Half volts times amps is 0.5W
+    int32_t power = half_volts * amps * 5;
+    return Units::Deciwatts(charging ? -power : power);
+  }
+
+  DerivedSignalEngine::DerivedSignalEngine():
+    signals_{},
+    signal_count_(0)
+  {}
+  DerivedSignalEngine::~DerivedSignalEngine()
+  {}
+  bool DerivedSignalEngine::Add(DerivedSignal& signal)
+  {
+    if(signal_count_ >= MAX_SIGNALS)
+      return false;
+    signals_[signal_count_++] = &signal;
+    return true;
+  }
+  uint8_t DerivedSignalEngine::Update()
+  {
+    uint8_t updated = 0;
+    for (uint8_t i = 0; i < signal_count_; ++i)
+    {
+      if(signals_[i]->Update())
+        ++updated;
+    }
+    return updated;
+  }
+}
@@ -0,0 +1,193 @@
+/*
+ * FaultEngine.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include "FaultEngine.hpp"
+
+namespace SolarGators::DataModules
+{
+  FaultEngine::FaultEngine(uint32_t can_id, uint16_t telem_id):
+    DataModule(can_id, telem_id, Size),
+    raw_faults_(0),
+    latched_(0),
+    active_(0),
+    latch_mask_(0),
+    severity_masks_{},
+    events_{},
+    event_head_(0)
+  {
+    severity_masks_[static_cast<uint8_t>(Severity::Info)] = ALL_FAULTS;
+  }
+  FaultEngine::~FaultEngine()
+  {}
+  void FaultEngine::Update(const OrionBMSRx4& bms, uint32_t tick)
+  {
+    uint32_t bits;
+    bms.Read([&]() { bits = bms.getFaults().Bits(); });
+    Apply(BMS_FAULTS, static_cast<uint64_t>(bits) << BMS_SHIFT, tick);
+  }
+  void FaultEngine::Update(const MitsubaRx2& motor, uint32_t tick)
+  {
+    uint32_t bits;
+    bool overheat;
+    motor.Read([&]() {
+      bits = motor.GetFaults().Bits();
+      overheat = motor.GetOverHeatLevel() != 0;
+    });
+    Apply(MOTOR_FAULTS, (static_cast<uint64_t>(bits) << MOTOR_SHIFT)
+          | (static_cast<uint64_t>(overheat) << MOTOR_OVERHEAT_BIT), tick);
+  }
+  void FaultEngine::Update(const Steering& steering, uint32_t tick)
+  {
+    bool fault;
+    steering.Read([&]() { fault = steering.GetBpFaultStatus(); });
+    Apply(BPS_FAULT, fault ? BPS_FAULT : 0, tick);
+  }
+  void FaultEngine::SetSeverity(uint64_t mask, Severity severity)
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    for (uint64_t& severity_mask : severity_masks_)
+      severity_mask &= ~mask;
+    severity_masks_[static_cast<uint8_t>(severity)] |= mask & ALL_FAULTS;
+    // Faults moved to or from None appear or disappear straight away
+    Publish((raw_faults_ | latched_) & ~severity_masks_[static_cast<uint8_t>(Severity::None)],
+            osKernelGetTickCount());
+    osMutexRelease(mutex_id_);
+  }
+  FaultEngine::Severity FaultEngine::GetSeverity(uint8_t bit) const
+  {
+    uint64_t mask = static_cast<uint64_t>(1) << bit;
+    Severity severity = Severity::None;
+    osMutexAcquire(mutex_id_, osWaitForever);
+    for (uint8_t i = 0; i < SEVERITY_COUNT; ++i)
+    {
+      if(severity_masks_[i] & mask)
+      {
+        severity = static_cast<Severity>(i);
+        break;
+      }
+    }
+    osMutexRelease(mutex_id_);
+    return severity;
+  }
+  void FaultEngine::SetLatching(uint64_t mask, bool latching)
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    if(latching)
+      latch_mask_ |= mask;
+    else
+      latch_mask_ &= ~mask;
+    osMutexRelease(mutex_id_);
+  }
+  void FaultEngine::Acknowledge(uint64_t mask, uint32_t tick)
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    latched_ &= ~mask | raw_faults_;
+    Publish((raw_faults_ | latched_) & ~severity_masks_[static_cast<uint8_t>(Severity::None)], tick);
+    osMutexRelease(mutex_id_);
+  }
+  // The words are two loads each on the M0, the mutex keeps them from tearing
+  uint64_t FaultEngine::GetActive() const
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    uint64_t active = active_;
+    osMutexRelease(mutex_id_);
+    return active;
+  }
+  uint64_t FaultEngine::GetActive(Severity severity) const
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    uint64_t active = active_ & severity_masks_[static_cast<uint8_t>(severity)];
+    osMutexRelease(mutex_id_);
+    return active;
+  }
+  uint64_t FaultEngine::GetLatched() const
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    uint64_t latched = active_ & latched_ & ~raw_faults_;
+    osMutexRelease(mutex_id_);
+    return latched;
+  }
+  FaultEngine::Severity FaultEngine::GetHighestSeverity() const
+  {
+    Severity highest = Severity::None;
+    osMutexAcquire(mutex_id_, osWaitForever);
+    for (uint8_t i = SEVERITY_COUNT - 1; i > 0; --i)
+    {
+      if(active_ & severity_masks_[i])
+      {
+        highest = static_cast<Severity>(i);
+        break;
+      }
+    }
+    osMutexRelease(mutex_id_);
+    return highest;
+  }
+  uint32_t FaultEngine::GetEventHead() const
+  {
+    return event_head_;
+  }
+  bool FaultEngine::ReadEvent(uint32_t& cursor, Event& event, bool& dropped) const
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    dropped = event_head_ - cursor > MAX_EVENTS;
+    if(dropped)
+      cursor = event_head_ - MAX_EVENTS;
+    bool available = cursor != event_head_;
+    if(available)
+      event = events_[cursor++ & EVENT_MASK];
+    osMutexRelease(mutex_id_);
+    return available;
+  }
+  void FaultEngine::EncodeEvent(const Event& event, uint8_t* buff)
+  {
+    for (uint8_t i = 0; i < 7; ++i)
+    {
+      buff[i] = event.raised >> (8 * i);
+      buff[7 + i] = event.cleared >> (8 * i);
+    }
+    buff[14] = event.tick & 0xFF;
+    buff[15] = (event.tick >> 8) & 0xFF;
+    buff[16] = (event.tick >> 16) & 0xFF;
+    buff[17] = event.tick >> 24;
+  }
+  void FaultEngine::ToByteArray(uint8_t* buff) const
+  {
+    uint64_t active = GetActive();
+    for (uint8_t i = 0; i < Size; ++i)
+      buff[i] = active >> (8 * i);
+  }
+  void FaultEngine::FromByteArray(uint8_t* buff)
+  {
+    uint64_t bits = 0;
+    for (uint8_t i = 0; i < Size; ++i)
+      bits |= static_cast<uint64_t>(buff[i]) << (8 * i);
+    Apply(ALL_FAULTS, bits & ALL_FAULTS, osKernelGetTickCount());
+  }
+  // Merges a source's faults in and publishes whatever changed, the same handful of
+  // word operations for any number of faults
+  void FaultEngine::Apply(uint64_t source_mask, uint64_t bits, uint32_t tick)
+  {
+    osMutexAcquire(mutex_id_, osWaitForever);
+    raw_faults_ = (raw_faults_ & ~source_mask) | bits;
+    latched_ |= raw_faults_ & latch_mask_;
+    Publish((raw_faults_ | latched_) & ~severity_masks_[static_cast<uint8_t>(Severity::None)], tick);
+    osMutexRelease(mutex_id_);
+  }
+  // Called with the mutex held
+  void FaultEngine::Publish(uint64_t active, uint32_t tick)
+  {
+    uint64_t changed = active ^ active_;
+    if(!changed)
+      return;
+    active_ = active;
+    Event& event = events_[event_head_ & EVENT_MASK];
+    event.raised = changed & active;
+    event.cleared = changed & ~active;
+    event.tick = tick;
+    ++event_head_;
+  }
+}
@@ -16,40 +16,55 @@ namespace SolarGators::DataModules
 
   void OrionBMSRx0::ToByteArray(uint8_t* buff) const
   {
-    buff[0] = low_cell_volt_ >> 8;
-    buff[1] = (low_cell_volt_ & 0x00FF);
-    buff[2] = high_cell_volt_ >> 8;
-    buff[3] = (high_cell_volt_ & 0x00FF);
-    buff[4] = avg_cell_volt_ >> 8;
-    buff[5] = (avg_cell_volt_ & 0x00FF);
-    buff[6] = pack_sum_volt_ >> 8;
-    buff[7] = (pack_sum_volt_ & 0x00FF);
+    Sync();
+    Layout::Encode(*this, buff);
   }
 
   void OrionBMSRx0::FromByteArray(uint8_t* buff)
   {
-    low_cell_volt_   = (static_cast<uint16_t>(buff[0]) << 8) | buff[1];
-    high_cell_volt_  = (static_cast<uint16_t>(buff[2]) << 8) | buff[3];
-    avg_cell_volt_   = (static_cast<uint16_t>(buff[4]) << 8) | buff[5];
-    pack_sum_volt_   = (static_cast<uint16_t>(buff[6]) << 8) | buff[7];
+    Layout::Decode(*this, buff);
   }
 
   float OrionBMSRx0::getAvgCellVolt() const {
+    Sync();
     return avg_cell_volt_ * 1e-4;
   }
 
   float OrionBMSRx0::getHighCellVolt() const {
+    Sync();
     return high_cell_volt_ * 1e-4;
   }
 
   float OrionBMSRx0::getLowCellVolt() const {
+    Sync();
     return low_cell_volt_ * 1e-4;
   }
 
   float OrionBMSRx0::getPackSumVolt() const {
+    Sync();
     return pack_sum_volt_ * 0.01;
   }
 
+  OrionBMSRx0::CellVolts OrionBMSRx0::getAvgCellVoltFixed() const {
+    Sync();
+    return CellVolts(avg_cell_volt_);
+  }
+
+  OrionBMSRx0::CellVolts OrionBMSRx0::getHighCellVoltFixed() const {
+    Sync();
+    return CellVolts(high_cell_volt_);
+  }
+
+  OrionBMSRx0::CellVolts OrionBMSRx0::getLowCellVoltFixed() const {
+    Sync();
+    return CellVolts(low_cell_volt_);
+  }
+
+  Units::Centivolts OrionBMSRx0::getPackSumVoltFixed() const {
+    Sync();
+    return Units::Centivolts(pack_sum_volt_);
+  }
+
   // BMS Message 1
   OrionBMSRx1::OrionBMSRx1(uint32_t can_id, uint32_t telem_id):
         DataModule(can_id, telem_id, this->Size, 0, false)
@@ -57,52 +72,47 @@ namespace SolarGators::DataModules
 
   void OrionBMSRx1::ToByteArray(uint8_t* buff) const
   {
-    buff[0] = high_temp_;
-    buff[1] = high_temp_id_;
-    buff[2] = low_temp_;
-    buff[3] = low_temp_id_;
-    buff[4] = avg_temp_;
-    buff[5] = internal_temp_;
-    buff[6] = constant_val_ >> 8;
-    buff[7] = (constant_val_ & 0x00FF);
+    Sync();
+    Layout::Encode(*this, buff);
   }
 
   void OrionBMSRx1::FromByteArray(uint8_t* buff)
   {
-    high_temp_      = buff[0];
-    high_temp_id_   = buff[1];
-    low_temp_       = buff[2];
-    low_temp_id_    = buff[3];
-    avg_temp_       = buff[4];
-    internal_temp_  = buff[5];
-    constant_val_   = (static_cast<uint16_t>(buff[6]) << 8) | buff[7];
+    Layout::Decode(*this, buff);
   }
 
   uint8_t OrionBMSRx1::getAvgTemp() const {
+    Sync();
     return avg_temp_;
   }
 
-  uint8_t OrionBMSRx1::getConstantVal() const {
+  uint16_t OrionBMSRx1::getConstantVal() const {
+    Sync();
     return constant_val_;
   }
 
   uint8_t OrionBMSRx1::getHighTemp() const {
+    Sync();
     return high_temp_;
   }
 
   uint8_t OrionBMSRx1::getHighTempId() const {
+    Sync();
     return high_temp_id_;
   }
 
   uint8_t OrionBMSRx1::getInternalTemp() const {
+    Sync();
     return internal_temp_;
   }
 
   uint8_t OrionBMSRx1::getLowTemp() const {
+    Sync();
     return low_temp_;
   }
 
   uint8_t OrionBMSRx1::getLowTempId() const {
+    Sync();
     return low_temp_id_;
   }
 
@@ -113,243 +123,125 @@ namespace SolarGators::DataModules
 
   void OrionBMSRx2::ToByteArray(uint8_t* buff) const
   {
-    buff[0] = pack_dcl_ >> 8;
-    buff[1] = (pack_dcl_ & 0x00FF);
-    buff[2] = pack_ccl_ >> 8;
-    buff[3] = (pack_ccl_ & 0x00FF);
-    buff[4] = pack_current_ >> 8;
-    buff[5] = (pack_current_ & 0x00FF);
-    buff[6] = constant_val_ >> 8;
-    buff[7] = (constant_val_ & 0x00FF);
+    Sync();
+    Layout::Encode(*this, buff);
   }
 
   void OrionBMSRx2::FromByteArray(uint8_t* buff)
   {
-    pack_dcl_     = (static_cast<uint16_t>(buff[0]) << 8) | buff[1];
-    pack_ccl_     = (static_cast<uint16_t>(buff[2]) << 8) | buff[3];
-    pack_current_ = (static_cast<uint16_t>(buff[4]) << 8) | buff[5];
-    constant_val_ = (static_cast<uint16_t>(buff[6]) << 8) | buff[7];
+    Layout::Decode(*this, buff);
   }
 
   uint16_t OrionBMSRx2::getConstantVal() const {
+    Sync();
     return constant_val_;
   }
 
   uint16_t OrionBMSRx2::getPackCcl() const {
+    Sync();
     return pack_ccl_;
   }
 
   float OrionBMSRx2::getPackCurrent() const {
+    Sync();
     return pack_current_ * 0.1;
   }
 
   uint16_t OrionBMSRx2::getPackDcl() const {
+    Sync();
     return pack_dcl_;
   }
 
+  Units::Deciamps OrionBMSRx2::getPackCurrentFixed() const {
+    Sync();
+    return Units::Deciamps(pack_current_);
+  }
+
   // BMS Message 3
   OrionBMSRx3::OrionBMSRx3(uint32_t can_id, uint32_t telem_id):
         DataModule(can_id, telem_id, this->Size, 0, false)
   { }
 
   void OrionBMSRx3::ToByteArray(uint8_t* buff) const
-    {
-      buff[0] = low_cell_res_ >> 8;
-      buff[1] = (low_cell_res_ & 0x00FF);
-      buff[2] = high_cell_res_ >> 8;
-      buff[3] = (high_cell_res_ & 0x00FF);
-      buff[4] = pack_res_ >> 8;
-      buff[5] = (pack_res_ & 0x00FF);
-    }
-
-    void OrionBMSRx3::FromByteArray(uint8_t* buff)
-    {
-      low_cell_res_  = (static_cast<uint16_t>(buff[0]) << 8) | buff[1];
-      high_cell_res_  = (static_cast<uint16_t>(buff[2]) << 8) | buff[3];
-      pack_res_ = (static_cast<uint16_t>(buff[4]) << 8) | buff[5];
-    }
+  {
+    Sync();
+    Layout::Encode(*this, buff);
+  }
+
+  void OrionBMSRx3::FromByteArray(uint8_t* buff)
+  {
+    Layout::Decode(*this, buff);
+  }
 
   float OrionBMSRx3::getHighCellRes() const {
+    Sync();
     return high_cell_res_ * 0.01;
   }
 
   float OrionBMSRx3::getLowCellRes() const {
+    Sync();
     return low_cell_res_ * 0.01;
   }
 
   float OrionBMSRx3::getPackRes() const {
+    Sync();
     return pack_res_ * 0.001;
   }
 
+  OrionBMSRx3::CellOhms OrionBMSRx3::getHighCellResFixed() const {
+    Sync();
+    return CellOhms(high_cell_res_);
+  }
+
+  OrionBMSRx3::CellOhms OrionBMSRx3::getLowCellResFixed() const {
+    Sync();
+    return CellOhms(low_cell_res_);
+  }
+
+  Units::Milliohms OrionBMSRx3::getPackResFixed() const {
+    Sync();
+    return Units::Milliohms(pack_res_);
+  }
+
   // BMS Message 4
   OrionBMSRx4::OrionBMSRx4(uint32_t can_id, uint32_t telem_id):
-        DataModule(can_id, telem_id, this->Size, 0, false)
+        DataModule(can_id, telem_id, this->Size, 0, false), faults_(0), pack_soc_(0)
   { }
 
   void OrionBMSRx4::ToByteArray(uint8_t* buff) const
   {
-    buff[0]  = (static_cast<uint8_t>(internal_cell_communication_fault_)   << 0);
-    buff[0] |= (static_cast<uint8_t>(cell_balancing_stuck_off_fault_)      << 1);
-    buff[0] |= (static_cast<uint8_t>(weak_cell_fault_)                     << 2);
-    buff[0] |= (static_cast<uint8_t>(low_cell_voltage_fault_)              << 3);
-    buff[0] |= (static_cast<uint8_t>(cell_open_wiring_fault_)              << 4);
-    buff[0] |= (static_cast<uint8_t>(current_sensor_fault_)                << 5);
-    buff[0] |= (static_cast<uint8_t>(cell_voltage_over_5v_fault_)          << 6);
-    buff[0] |= (static_cast<uint8_t>(cell_bank_fault_)                     << 7);
-
-    buff[1]  = (static_cast<uint8_t>(weak_pack_fault_)                     << 0);
-    buff[1] |= (static_cast<uint8_t>(fan_monitor_fault_)                   << 1);
-    buff[1] |= (static_cast<uint8_t>(thermistor_fault_)                    << 2);
-    buff[1] |= (static_cast<uint8_t>(can_communication_fault_)             << 3);
-    buff[1] |= (static_cast<uint8_t>(redundant_power_supply_fault_)        << 4);
-    buff[1] |= (static_cast<uint8_t>(high_voltage_isolation_fault_)        << 5);
-    buff[1] |= (static_cast<uint8_t>(invalid_input_supply_voltage_fault_)  << 6);
-    buff[1] |= (static_cast<uint8_t>(chargeenable_relay_fault_)            << 7);
-
-    buff[2]  = (static_cast<uint8_t>(dischargeenable_relay_fault_)         << 0);
-    buff[2] |= (static_cast<uint8_t>(charger_safety_relay_fault_)          << 1);
-    buff[2] |= (static_cast<uint8_t>(internal_hardware_fault_)             << 2);
-    buff[2] |= (static_cast<uint8_t>(internal_heatsink_thermistor_fault_)  << 3);
-    buff[2] |= (static_cast<uint8_t>(internal_logic_fault_)                << 4);
-    buff[2] |= (static_cast<uint8_t>(highest_cell_voltage_too_high_fault_) << 5);
-    buff[2] |= (static_cast<uint8_t>(lowest_cell_voltage_too_low_fault_)   << 6);
-    buff[2] |= (static_cast<uint8_t>(pack_too_hot_fault_)                  << 7);
-
-    buff[3]  = pack_soc_;
+    Sync();
+    Layout::Encode(*this, buff);
   }
 
   void OrionBMSRx4::FromByteArray(uint8_t* buff)
   {
-    internal_cell_communication_fault_  = buff[0] & (1 << 0);
-    cell_balancing_stuck_off_fault_     = buff[0] & (1 << 1);
-    weak_cell_fault_                    = buff[0] & (1 << 2);
-    low_cell_voltage_fault_             = buff[0] & (1 << 3);
-    cell_open_wiring_fault_             = buff[0] & (1 << 4);
-    current_sensor_fault_               = buff[0] & (1 << 5);
-    cell_voltage_over_5v_fault_         = buff[0] & (1 << 6);
-    cell_bank_fault_                    = buff[0] & (1 << 7);
-
-    weak_pack_fault_                    = buff[1] & (1 << 0);
-    fan_monitor_fault_                  = buff[1] & (1 << 1);
-    thermistor_fault_                   = buff[1] & (1 << 2);
-    can_communication_fault_            = buff[1] & (1 << 3);
-    redundant_power_supply_fault_       = buff[1] & (1 << 4);
-    high_voltage_isolation_fault_       = buff[1] & (1 << 5);
-    invalid_input_supply_voltage_fault_ = buff[1] & (1 << 6);
-    chargeenable_relay_fault_           = buff[1] & (1 << 7);
-
-    dischargeenable_relay_fault_        = buff[2] & (1 << 0);
-    charger_safety_relay_fault_         = buff[2] & (1 << 1);
-    internal_hardware_fault_            = buff[2] & (1 << 2);
-    internal_heatsink_thermistor_fault_ = buff[2] & (1 << 3);
-    internal_logic_fault_               = buff[2] & (1 << 4);
-    highest_cell_voltage_too_high_fault_= buff[2] & (1 << 5);
-    lowest_cell_voltage_too_low_fault_  = buff[2] & (1 << 6);
-    pack_too_hot_fault_                 = buff[2] & (1 << 7);
-
-    pack_soc_ = buff[3];
-  }
-
-  bool OrionBMSRx4::isCanCommunicationFault() const {
-    return can_communication_fault_;
-  }
-
-  bool OrionBMSRx4::isCellBalancingStuckOffFault() const {
-    return cell_balancing_stuck_off_fault_;
+    Layout::Decode(*this, buff);
   }
 
-  bool OrionBMSRx4::isCellBankFault() const {
-    return cell_bank_fault_;
+  OrionBMSRx4::Faults OrionBMSRx4::getFaults() const {
+    Sync();
+    return Faults(faults_);
   }
 
-  bool OrionBMSRx4::isCellOpenWiringFault() const {
-    return cell_open_wiring_fault_;
-  }
-
-  bool OrionBMSRx4::isCellVoltageOver5vFault() const {
-    return cell_voltage_over_5v_fault_;
-  }
-
-  bool OrionBMSRx4::isChargeenableRelayFault() const {
-    return chargeenable_relay_fault_;
-  }
-
-  bool OrionBMSRx4::isChargerSafetyRelayFault() const {
-    return charger_safety_relay_fault_;
-  }
-
-  bool OrionBMSRx4::isCurrentSensorFault() const {
-    return current_sensor_fault_;
-  }
-
-  bool OrionBMSRx4::isDischargeenableRelayFault() const {
-    return dischargeenable_relay_fault_;
-  }
-
-  bool OrionBMSRx4::isFanMonitorFault() const {
-    return fan_monitor_fault_;
-  }
-
-  bool OrionBMSRx4::isHighVoltageIsolationFault() const {
-    return high_voltage_isolation_fault_;
-  }
-
-  bool OrionBMSRx4::isHighestCellVoltageTooHighFault() const {
-    return highest_cell_voltage_too_high_fault_;
-  }
-
-  bool OrionBMSRx4::isInternalCellCommunicationFault() const {
-    return internal_cell_communication_fault_;
-  }
-
-  bool OrionBMSRx4::isInternalHardwareFault() const {
-    return internal_hardware_fault_;
-  }
-
-  bool OrionBMSRx4::isInternalHeatsinkThermistorFault() const {
-    return internal_heatsink_thermistor_fault_;
-  }
-
-  bool OrionBMSRx4::isInternalLogicFault() const {
-    return internal_logic_fault_;
-  }
-
-  bool OrionBMSRx4::isInvalidInputSupplyVoltageFault() const {
-    return invalid_input_supply_voltage_fault_;
-  }
-
-  bool OrionBMSRx4::isLowCellVoltageFault() const {
-    return low_cell_voltage_fault_;
-  }
-
-  bool OrionBMSRx4::isLowestCellVoltageTooLowFault() const {
-    return lowest_cell_voltage_too_low_fault_;
-  }
-
-  bool OrionBMSRx4::isPackTooHotFault() const {
-    return pack_too_hot_fault_;
-  }
-
-  bool OrionBMSRx4::isRedundantPowerSupplyFault() const {
-    return redundant_power_supply_fault_;
-  }
-
-  bool OrionBMSRx4::isThermistorFault() const {
-    return thermistor_fault_;
-  }
-
-  bool OrionBMSRx4::isWeakCellFault() const {
-    return weak_cell_fault_;
-  }
-
-  bool OrionBMSRx4::isWeakPackFault() const {
-    return weak_pack_fault_;
+#define ORION_BMS_RX4_GETTER(name, getter, bit)   \
+  bool OrionBMSRx4::getter() const {              \
+    Sync();                                       \
+    return faults_ & Faults::Mask(Fault::name);   \
   }
+  ORION_BMS_RX4_FAULTS(ORION_BMS_RX4_GETTER)
+#undef ORION_BMS_RX4_GETTER
 
   float OrionBMSRx4::getPackSoc() const {
+    Sync();
     return pack_soc_ * 0.5;
   }
 
+  Units::HalfPercents OrionBMSRx4::getPackSocFixed() const {
+    Sync();
+    return Units::HalfPercents(pack_soc_);
+  }
+
   // BMS Message 5
   OrionBMSRx5::OrionBMSRx5(uint32_t can_id, uint32_t telem_id):
         DataModule(can_id, telem_id, this->Size, 0, false)
@@ -357,37 +249,42 @@ namespace SolarGators::DataModules
 
   void OrionBMSRx5::ToByteArray(uint8_t* buff) const
   {
-    buff[0] = max_pack_dcl_ >> 8;
-    buff[1] = (max_pack_dcl_ & 0x00FF);
-    buff[2] = max_pack_ccl_ >> 8;
-    buff[3] = (max_pack_ccl_ & 0x00FF);
-    buff[4] = max_pack_volt_ >> 8;
-    buff[5] = (max_pack_volt_ & 0x00FF);
-    buff[6] = min_pack_volt_ >> 8;
-    buff[7] = (min_pack_volt_ & 0x00FF);
+    Sync();
+    Layout::Encode(*this, buff);
   }
 
   void OrionBMSRx5::FromByteArray(uint8_t* buff)
   {
-    max_pack_dcl_  = (static_cast<uint16_t>(buff[0]) << 8) | buff[1];
-    max_pack_ccl_  = (static_cast<uint16_t>(buff[2]) << 8) | buff[3];
-    max_pack_volt_ = (static_cast<uint16_t>(buff[4]) << 8) | buff[5];
-    min_pack_volt_ = (static_cast<uint16_t>(buff[6]) << 8) | buff[7];
+    Layout::Decode(*this, buff);
   }
 
   uint16_t OrionBMSRx5::getMaxPackCcl() const {
+    Sync();
     return max_pack_ccl_;
   }
 
   uint16_t OrionBMSRx5::getMaxPackDcl() const {
+    Sync();
     return max_pack_dcl_;
   }
 
   float OrionBMSRx5::getMaxPackVolt() const {
+    Sync();
     return max_pack_volt_ * 0.1;
   }
 
   float OrionBMSRx5::getMinPackVolt() const {
+    Sync();
     return min_pack_volt_ * 0.1;
   }
+
+  Units::Decivolts OrionBMSRx5::getMaxPackVoltFixed() const {
+    Sync();
+    return Units::Decivolts(max_pack_volt_);
+  }
+
+  Units::Decivolts OrionBMSRx5::getMinPackVoltFixed() const {
+    Sync();
+    return Units::Decivolts(min_pack_volt_);
+  }
 }
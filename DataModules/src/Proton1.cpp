@@ -10,8 +10,6 @@
 namespace SolarGators {
 namespace DataModules {
 
-static constexpr uint8_t Mppt_Size = 8;
-
 Proton1::Proton1(uint32_t id):
     DataModule(id, 0, Mppt_Size, 0, false, true), arrayVoltage(0),
     arrayCurrent(0), batteryVoltage(0),mpptTemperature(0)
@@ -22,47 +20,53 @@ Proton1::~Proton1()
 
 void Proton1::ToByteArray(uint8_t* buff) const
 {
-  float convArrayVoltage = arrayVoltage * 100;
-  float convArrayCurrent = arrayCurrent * 100;
-  float convBatteryVoltage = batteryVoltage * 100;
-  float convMpptTemperature = mpptTemperature * 100;
-
-  buff[0] = static_cast<uint32_t>(convArrayVoltage) & 0xFF;
-  buff[1] = (static_cast<uint32_t>(convArrayVoltage) >> 8) & 0xFF;
-  buff[2] = static_cast<uint32_t>(convArrayCurrent) & 0xFF;
-  buff[3] = (static_cast<uint32_t>(convArrayCurrent) >> 8) & 0xFF;
-  buff[4] = static_cast<uint32_t>(convBatteryVoltage) & 0xFF;
-  buff[5] = (static_cast<uint32_t>(convBatteryVoltage) >> 8) & 0xFF;
-  buff[6] = static_cast<uint32_t>(convMpptTemperature) & 0xFF;
-  buff[7] = (static_cast<uint32_t>(convMpptTemperature) >> 8) & 0xFF;
+  Sync();
+  Layout::Encode(*this, buff);
 }
 
 void Proton1::FromByteArray(uint8_t* buff)
 {
-  uint32_t preArrayVoltage = (static_cast<uint32_t>(buff[1]) << 8) | buff[0];
-  uint32_t preArrayCurrent = (static_cast<uint32_t>(buff[3]) << 8) | buff[2];
-  uint32_t preBatteryVoltage = (static_cast<uint32_t>(buff[5]) << 8) | buff[4];
-  uint32_t preMpptTemperature = (static_cast<uint32_t>(buff[7]) << 8) | buff[6];
-  arrayVoltage = static_cast<float>(preArrayVoltage)/100;
-  arrayCurrent = static_cast<float>(preArrayCurrent)/100;
-  batteryVoltage = static_cast<float>(preBatteryVoltage)/100;
-  mpptTemperature = static_cast<float>(preMpptTemperature)/100;
+  Layout::Decode(*this, buff);
 }
 
 float Proton1::getArrayCurrent() const {
-  return arrayCurrent;
+  Sync();
+  return arrayCurrent * 0.01f;
 }
 
 float Proton1::getArrayVoltage() const {
-  return arrayVoltage;
+  Sync();
+  return arrayVoltage * 0.01f;
 }
 
 float Proton1::getBatteryVoltage() const {
-  return batteryVoltage;
+  Sync();
+  return batteryVoltage * 0.01f;
 }
 
 float Proton1::getMpptTemperature() const {
-  return mpptTemperature;
+  Sync();
+  return mpptTemperature * 0.01f;
+}
+
+Units::Centivolts Proton1::getArrayVoltageFixed() const {
+  Sync();
+  return Units::Centivolts(arrayVoltage);
+}
+
+Units::Centiamps Proton1::getArrayCurrentFixed() const {
+  Sync();
+  return Units::Centiamps(arrayCurrent);
+}
+
+Units::Centivolts Proton1::getBatteryVoltageFixed() const {
+  Sync();
+  return Units::Centivolts(batteryVoltage);
+}
+
+Units::CentidegreesC Proton1::getMpptTemperatureFixed() const {
+  Sync();
+  return Units::CentidegreesC(mpptTemperature);
 }
 
 } /* namespace DataModules */
@@ -6,16 +6,14 @@
  */
 
 #include "Steering.hpp"
-#include <string.h>
 
 namespace {
   static constexpr uint32_t ID = 1023;
-  static constexpr uint32_t SIZE = 0x2;
 }
 namespace SolarGators::DataModules
 {
   Steering::Steering():
-    DataModule(ID, 0, SIZE),
+    DataModule(ID, 0, Size),
     left_turn_(false),
     right_turn_(false),
     hazards_(false),
@@ -71,29 +69,10 @@ namespace SolarGators::DataModules
   }
   void Steering::ToByteArray(uint8_t* buff) const
   {
-    memset(buff, 0, sizeof(buff));
-    buff[0] |= (static_cast<uint8_t>(left_turn_)     << 0);
-    buff[0] |= (static_cast<uint8_t>(right_turn_)    << 1);
-    buff[0] |= (static_cast<uint8_t>(hazards_)       << 2);
-    buff[0] |= (static_cast<uint8_t>(bps_fault_)     << 3);
-    buff[0] |= (static_cast<uint8_t>(cruise_enable_) << 4);
-    buff[0] |= (static_cast<uint8_t>(eco_enable_)    << 5);
-    buff[0] |= (static_cast<uint8_t>(headlights_)    << 6);
-    buff[0] |= (static_cast<uint8_t>(horn_)          << 7);
-    buff[1] |= (static_cast<uint8_t>(reverse_)       << 0);
-    buff[2] |= cruise_speed_;
+    Layout::Encode(*this, buff);
   }
   void Steering::FromByteArray(uint8_t* buff)
   {
-    left_turn_      = buff[0] & (1 << 0);
-    right_turn_     = buff[0] & (1 << 1);
-    hazards_        = buff[0] & (1 << 2);
-    bps_fault_      = buff[0] & (1 << 3);
-    cruise_enable_  = buff[0] & (1 << 4);
-    eco_enable_     = buff[0] & (1 << 5);
-    headlights_     = buff[0] & (1 << 6);
-    horn_           = buff[0] & (1 << 7);
-    reverse_        = buff[1] & (1 << 0);
-    cruise_speed_   = buff[2];
+    Layout::Decode(*this, buff);
   }
 }
@@ -8,10 +8,30 @@
 #ifndef SOLARGATORSBSP_DRIVERS_INC_CAN_HPP_
 #define SOLARGATORSBSP_DRIVERS_INC_CAN_HPP_
 
+#include <atomic>
+#include <functional>
 #include <cmsis_os.h>
 #include "main.h"
 #include <DataModule.hpp>
-#include "etl/map.h"
+#include <CANDispatch.hpp>
+#include <CANFilter.hpp>
+#include <CANFrameRing.hpp>
+#include <CANRecorder.hpp>
+#include <CANSubscriptions.hpp>
+#include "etl/priority_queue.h"
+#include "etl/vector.h"
+
+// Rx task stack in bytes. Everything that reacts to a received frame runs on the rx task: frame
+// hooks, module decoders, stale callbacks, subscription notifies, RTR answers through BuildFrame and
+// SendFrame, ISO-TP reassembly and the recorder, each with a CANFrame or two on the stack. Boards
+// with heavier hooks can raise it, check GetRxStackFree after exercising every path.
+#ifndef SOLARGATORS_CAN_RX_STACK_SIZE
+#ifdef SOLARGATORS_CAN_FD
+#define SOLARGATORS_CAN_RX_STACK_SIZE 2048
+#else
+#define SOLARGATORS_CAN_RX_STACK_SIZE 1024
+#endif
+#endif
 
 namespace SolarGators {
 namespace Drivers {
@@ -21,19 +41,266 @@ public:
   CANDriver(CAN_HandleTypeDef* hcan, uint32_t rx_fifo_num_);
   void Init();
   virtual ~CANDriver();
-  void Send(SolarGators::DataModules::DataModule* data);
+  enum class TxStatus : uint8_t {
+    Queued,                                        // Frame will go out in CAN priority order
+    Dropped,                                       // Frame can never be sent (bad length, or bus-off with flush_tx)
+    Full,                                          // Tx queue is full, try again later
+    Suppressed                                     // Same bytes as the last frame and no heartbeat due
+  };
+  // Never blocks, safe to call from any task. urgent skips the module's tx policy.
+  TxStatus Send(SolarGators::DataModules::DataModule* data, bool urgent = false);
+  TxStatus SendFrame(const CANFrame& frame);
+  // Call from HAL_CAN_TxMailbox0/1/2CompleteCallback, refills the free mailboxes
+  void HandleTxInterrupt();
   void HandleReceive();
+  // Call from HAL_CAN_RxFifo0MsgPendingCallback and HAL_CAN_RxFifo1MsgPendingCallback,
+  // copies both hardware fifos into the rx rings, priority fifo first
   void SetRxFlag();
-  bool AddRxModule(DataModules::DataModule* module);
-  bool RemoveRxModule(uint32_t module_id);
-  static constexpr uint8_t MAX_DATA_SIZE = 8;     // Maximum data size in bytes
+  // Call from HAL_CAN_ErrorCallback. The peripheral must be set up with AutoBusOff disabled,
+  // leaving bus-off is handled here with a backoff.
+  void HandleErrorInterrupt();
+  enum class ErrorState : uint8_t {
+    Active,
+    Warning,                                       // TEC or REC at 96 or above
+    Passive,                                       // TEC or REC above 127
+    BusOff                                         // TEC above 255, the node is off the bus
+  };
+  struct ErrorTransition {
+    uint32_t tick;
+    ErrorState from;
+    ErrorState to;
+    uint8_t tec;
+    uint8_t rec;
+  };
+  struct BusOffPolicy {
+    uint32_t backoff_min_ms;                       // Wait before the first recovery attempt
+    uint32_t backoff_max_ms;                       // Doubles per bus-off up to this, resets after this long error active
+    bool flush_tx;                                 // Drop queued frames on bus-off instead of sending them late
+  };
+  void SetBusOffPolicy(const BusOffPolicy& policy);
+  ErrorState GetErrorState() const;
+  uint32_t GetErrorStateCount(ErrorState state) const;  // Times the state was entered
+  // Copies up to max transitions into history, newest first, and returns how many
+  uint8_t GetErrorHistory(ErrorTransition* history, uint8_t max) const;
+  enum class RegisterStatus : uint8_t {
+    Ok,
+    Duplicate,                                     // The ID is already registered
+    TableFull,                                     // No room in the dispatch table
+    FilterFull,                                    // No room in the filter planner
+    TooLarge,                                      // Module doesn't fit in a frame on this driver
+    NotFound,
+    Busy                                           // The rx task still holds the table the last change replaced
+  };
+  // High priority modules are filtered into their own fifo and always decoded before bulk traffic.
+  // Safe to call from any task while the driver is running, including the rx task from a hook.
+  // The rx task keeps using the old table until it finishes its batch, the next change waits up
+  // to TABLE_WAIT_TICKS for that and returns Busy if it doesn't happen, so from the rx task only
+  // one change per batch goes through.
+  RegisterStatus AddRxModule(DataModules::DataModule* module, bool high_priority = false);
+  RegisterStatus RemoveRxModule(uint32_t module_id, bool is_ext_id = false);
+  // Lets frames with the ID through the hardware filters without a module, for frame hooks
+  RegisterStatus AddRxId(uint32_t id, bool is_ext, bool high_priority = false);
+  RegisterStatus RemoveRxId(uint32_t id, bool is_ext);
+  // Pass every frame through the hardware filters
+  void SetAcceptAll(bool accept_all);
+  // Filter banks this driver plans into, call before Init. Defaults to the first
+  // CANFilterPlanner::DEFAULT_BANKS, every bank on the STM32F0. Dual bxCAN parts share
+  // CANFilterPlanner::MAX_BANKS banks, give CAN1 a range from 0 and CAN2 the banks after it.
+  bool SetFilterBanks(uint8_t first, uint8_t count);
+  // Sees every raw frame on the rx task before it is decoded. Returning false stops the frame
+  // from going to the rx modules. Set it before Init.
+  using FrameHook = std::function<bool(const CANFrame&)>;
+  void SetFrameHook(FrameHook hook);
+  // Sets flags on the thread (or event flags object) when a frame for the rx module changes any
+  // bit in signal_mask, at most once per coalesce_ticks. Later changes in the window are folded
+  // into one notification at the end of it.
+  bool Subscribe(DataModules::DataModule* module, osThreadId_t thread, uint32_t flags,
+                 uint64_t signal_mask = CANSubscriptions::ALL_SIGNALS, uint32_t coalesce_ticks = 0);
+  bool SubscribeEvent(DataModules::DataModule* module, osEventFlagsId_t event, uint32_t flags,
+                      uint64_t signal_mask = CANSubscriptions::ALL_SIGNALS, uint32_t coalesce_ticks = 0);
+  // Drops every subscription on the module for the thread or event flags object
+  bool Unsubscribe(DataModules::DataModule* module, const void* target);
+  // Remote frames for the module's ID are answered from the rx task with a fresh ToByteArray.
+  // A request that arrives while another task holds the module's mutex is counted as a tx drop.
+  RegisterStatus AddRtrResponder(DataModules::DataModule* module, bool high_priority = false);
+  RegisterStatus RemoveRtrResponder(uint32_t module_id, bool is_ext_id = false);
+  const CANDispatchTable::Entry* GetRtrResponderStats(uint32_t id, bool is_ext) const;  // rx_count counts requests
+  uint32_t GetRxOverflowCount(uint32_t fifo) const;  // Frames lost because the rx ring was full
+  uint16_t GetRxHighWater(uint32_t fifo) const;
+  uint32_t GetRxFifoOverrunCount(uint32_t fifo) const;  // Frames lost in the hardware fifo
+  uint16_t GetTxQueueDepth() const;
+  // With a tx policy Send only queues the module when its bytes differ from the last frame
+  // queued for it, or heartbeat_ms has passed since then (0 sends on change only)
+  struct TxPolicyStats {
+    uint32_t sent;
+    uint32_t suppressed;                           // Sends that were skipped, the bus load saved
+    uint32_t urgent;                               // Of sent, forced out by an urgent send
+  };
+  bool SetTxPolicy(DataModules::DataModule* module, uint32_t heartbeat_ms);
+  bool RemoveTxPolicy(DataModules::DataModule* module);
+  bool GetTxPolicyStats(DataModules::DataModule* module, TxPolicyStats& stats) const;
+  uint16_t GetTxQueueHighWater() const;
+  uint32_t GetTxDropCount() const;
+  uint32_t GetTxMailboxWaitTicks() const;          // Total ticks frames spent queued for a mailbox
+  uint32_t GetTxMaxMailboxWaitTicks() const;
+  // Bus instrumentation, rates and load are recomputed once a second by the rx task.
+  // The entry is only valid until the next module is added or removed.
+  const CANDispatchTable::Entry* GetRxIdStats(uint32_t id, bool is_ext) const;
+  uint32_t GetRxFrameCount() const;
+  uint32_t GetTxFrameCount() const;
+  uint32_t GetUnknownIdCount() const;              // Frames that passed the filters but had no module
+  uint16_t GetRxRate() const;                      // Frames per second
+  uint16_t GetTxRate() const;
+  // Estimated from the frames this node received and sent, frames rejected by the
+  // hardware filters are invisible so this is a lower bound
+  uint8_t GetBusLoad() const;                      // Percent
+  uint32_t GetRxStackFree() const;                 // Least rx task stack ever left unused, in bytes
+  uint8_t GetTransmitErrorCount() const;           // bxCAN TEC
+  uint8_t GetReceiveErrorCount() const;            // bxCAN REC
+  // Called from the rx task when a module with a freshness deadline goes stale (true) or recovers (false)
+  void SetStaleCallback(std::function<void(DataModules::DataModule&, bool)> callback);
+  // Every frame taken off the rx rings and every frame queued by SendFrame is recorded, nullptr stops it
+  void SetRecorder(CANRecorder* recorder);
+  static constexpr uint8_t MAX_DATA_SIZE = 8;     // Maximum data size in bytes, bxCAN is classic CAN only
+  // Largest payload this driver can put in one frame. Modules above it or asking for FD are dropped.
+  uint8_t GetMaxPayload() const;
+  // Frames that can wait for the rx task. At 500kbit/s a saturated bus delivers a frame
+  // about every 230us, so the task can be held off for ~7ms without losing anything.
+  static constexpr uint16_t RX_RING_SIZE = 32;
+  static constexpr uint16_t RX_PRIORITY_RING_SIZE = 8;
+  static constexpr uint8_t TX_QUEUE_SIZE = 16;
+  static constexpr uint8_t MAX_TX_POLICIES = 16;
+  static constexpr uint32_t STALE_CHECK_TICKS = 100;  // How often freshness deadlines are checked
+  static constexpr uint8_t ERROR_HISTORY_SIZE = 8;
+  static constexpr uint32_t TABLE_WAIT_TICKS = 10;  // Longest a registry change waits for the rx task
+  static constexpr uint32_t RX_STACK_SIZE = SOLARGATORS_CAN_RX_STACK_SIZE;
+  static_assert(RX_STACK_SIZE % sizeof(uint32_t) == 0, "RX_STACK_SIZE must be whole words");
 private:
-  ::etl::map<uint16_t, SolarGators::DataModules::DataModule*, 15> modules_;
+  struct TxEntry {
+    uint32_t priority;                             // Arbitration order, lower wins the bus
+    uint32_t sequence;                             // Keeps frames with the same ID in order
+    CANFrame frame;
+  };
+  struct TxPolicy {
+    DataModules::DataModule* module;
+    uint32_t heartbeat_ticks;
+    uint32_t last_tick;                            // Tick the last frame was queued
+    bool primed;                                   // last_data holds a queued frame
+    uint8_t last_data[CANFrame::MAX_DATA_SIZE];
+    TxPolicyStats stats;
+  };
+  struct TxEntryCompare {
+    bool operator()(const TxEntry& a, const TxEntry& b) const
+    {
+      // True if a goes out after b
+      return a.priority != b.priority ? a.priority > b.priority : a.sequence > b.sequence;
+    }
+  };
+  static uint32_t ArbitrationPriority(uint32_t id, bool is_ext);
+  template <uint16_t SIZE>
+  void DrainFifo(uint32_t fifo, CANFrameRing<SIZE>& ring);
+  void DrainPriorityRing();
+  void DispatchFrame(const CANFrame& frame);
+  CANDispatchTable* AcquireTable();
+  void ReleaseTable();
+  void PublishTable(CANDispatchTable* table);
+  CANDispatchTable* SpareTable();
+  bool ReclaimSpare(bool wait);
+  static RegisterStatus ToRegisterStatus(CANDispatchTable::Result result);
+  void HandleRemoteFrame(const CANFrame& frame);
+  bool AddSubscription(DataModules::DataModule* module, const CANSubscriptions::Target& target,
+                       uint64_t signal_mask, uint32_t coalesce_ticks);
+  // False if the module doesn't fit or its mutex isn't free within timeout
+  bool BuildFrame(DataModules::DataModule* data, CANFrame& frame, uint32_t timeout = osWaitForever);
+  void CountTxDrop();
+  TxPolicy* FindTxPolicy(const DataModules::DataModule* module);
+  void UpdateStats(uint32_t now);
+  void CheckStaleness(uint32_t now);
+  ErrorState ReadErrorState() const;
+  void UpdateErrorState(ErrorState state);
+  void CheckErrorState(uint32_t now);
+  void ArmRecovery();
+  void HandleBusOff();
+  static void RecoveryTimerCallback(void* arg);
+  void Recover();
+  static constexpr uint32_t RX_FLAG = 0x1;
+  static constexpr uint32_t BUS_OFF_FLAG = 0x2;
+  static uint32_t FrameBits(const CANFrame& frame);
+  void FillTxMailboxes();
+  void ConfigureFilters();
+  void ConfigureFilterBank(uint32_t bank, const CANFilterBank& filter_bank);
+  // Rx modules by CAN ID. Changes are made to a copy that is then swapped in, so the
+  // rx task never takes a lock to look a frame up.
+  CANDispatchTable module_tables_[2];
+  std::atomic<CANDispatchTable*> modules_;         // Published table
+  std::atomic<CANDispatchTable*> rx_table_;        // Table the rx task is using, nullptr between batches
+  CANDispatchTable rtr_responders_;                // Tx modules answered on request, changed with interrupts off
+  CANSubscriptions subscriptions_;                 // Change notifications, chained off the modules_ entries
+  uint8_t retired_subscription_;                   // Chain of a removed module, freed with the spare table
+  osMutexId_t registry_mutex_;                     // Serialises changes to the tables and filters
+  StaticSemaphore_t registry_mutex_control_block_;
+  const osMutexAttr_t registry_mutex_attributes_ = {
+    .name = "CAN Registry",
+    .attr_bits = osMutexRecursive,
+    .cb_mem = &registry_mutex_control_block_,
+    .cb_size = sizeof(registry_mutex_control_block_),
+  };
   CAN_HandleTypeDef* hcan_;                        // CAN handle
-  uint32_t rx_fifo_num_;                           // CAN hardware fifo number
+  uint32_t rx_fifo_num_;                           // CAN hardware fifo for bulk traffic
+  uint32_t priority_fifo_num_;                     // CAN hardware fifo for high priority modules
+  CANFilterPlanner filter_planner_;                // Hardware filter layout for the registered modules
+  uint8_t first_filter_bank_;                      // Hardware number of the first bank this driver owns
+  uint8_t active_filter_banks_;                    // Number of filter banks currently enabled
+  // First CAN2 bank on dual bxCAN parts. Every filter write from either instance sets it,
+  // so it is shared and only the driver whose banks start at 0 (CAN1) moves it.
+  static uint8_t slave_start_filter_bank_;
+  bool started_;                                   // Filters are live, changes must be re-planned
+  CANFrameRing<RX_RING_SIZE> rx_ring_;             // Frames copied out of the bulk fifo by the ISR
+  CANFrameRing<RX_PRIORITY_RING_SIZE> rx_priority_ring_; // Frames copied out of the priority fifo by the ISR
+  volatile uint32_t rx_fifo_overruns_[2];          // Hardware fifo overruns, indexed by fifo
+  ::etl::priority_queue<TxEntry, TX_QUEUE_SIZE, ::etl::vector<TxEntry, TX_QUEUE_SIZE>, TxEntryCompare> tx_queue_;
+  uint32_t tx_sequence_;                           // Sequence number of the next queued frame
+  uint16_t tx_queue_high_water_;                   // Most frames ever waiting in the tx queue
+  uint32_t tx_drop_count_;                         // Frames rejected by Send, only changed with interrupts off
+  etl::vector<TxPolicy, MAX_TX_POLICIES> tx_policies_;  // Changed and checked with interrupts off
+  uint32_t tx_wait_ticks_;                         // Total ticks spent waiting for a mailbox
+  uint32_t tx_max_wait_ticks_;                     // Longest wait for a mailbox
+  uint32_t rx_frame_count_;                        // Frames taken off the rx rings
+  uint32_t tx_frame_count_;                        // Frames loaded into a mailbox
+  uint32_t unknown_id_count_;                      // Frames with no registered module
+  uint32_t rx_bits_;                               // Estimated bits received, wraps
+  volatile uint32_t tx_bits_;                      // Estimated bits sent, wraps
+  uint32_t bit_rate_;                              // Nominal bit rate from the bit timing register
+  uint32_t stats_window_ticks_;                    // Length of the rate window, one second
+  uint32_t stats_window_start_;                    // Tick the current rate window started
+  uint32_t window_rx_frames_;                      // Counters at the start of the window
+  uint32_t window_tx_frames_;
+  uint32_t window_bits_;
+  uint16_t rx_rate_;
+  uint16_t tx_rate_;
+  uint8_t bus_load_;
+  uint32_t last_stale_check_;                      // Tick freshness deadlines were last checked
+  std::function<void(DataModules::DataModule&, bool)> stale_callback_;
+  FrameHook frame_hook_;
+  CANRecorder* volatile recorder_;                 // Optional frame log
+  BusOffPolicy bus_off_policy_;
+  volatile ErrorState error_state_;
+  uint32_t error_state_counts_[4];                 // Indexed by ErrorState
+  ErrorTransition error_history_[ERROR_HISTORY_SIZE];
+  uint8_t error_history_next_;                     // Slot the next transition goes in
+  uint8_t error_history_count_;
+  uint32_t backoff_ms_;                            // Wait before the next recovery attempt
+  osTimerId_t recovery_timer_;                     // Bus-off Recovery Timer
+  StaticTimer_t recovery_timer_control_block_;     // Bus-off Recovery Timer Control Block
+  const osTimerAttr_t recovery_timer_attributes_ = // Bus-off Recovery Timer Attributes
+  {
+    .name = "CAN Bus-off Recovery",
+    .cb_mem = &recovery_timer_control_block_,
+    .cb_size = sizeof(recovery_timer_control_block_),
+  };
   osEventFlagsId_t can_rx_event_;                  // Rx CAN Interrupt Event
   osThreadId_t rx_task_handle_;                    // Rx Task Handle
-  uint32_t rx_task_buffer_[ 128 ];                 // Rx Task Buffer
+  uint32_t rx_task_buffer_[ RX_STACK_SIZE / sizeof(uint32_t) ]; // Rx Task Buffer
   StaticTask_t rx_task_control_block_;             // Rx Task Control Block
   const osThreadAttr_t rx_task_attributes_ =       // Rx Task Attributes
   {
@@ -0,0 +1,36 @@
+/*
+ * CANBusStats.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Exposes the CAN driver instrumentation as a DataModule so it can be sent to the pit.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANBUSSTATS_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANBUSSTATS_HPP_
+
+#include <DataModule.hpp>
+#include <CAN.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANBusStats final : public DataModules::DataModule {
+public:
+  CANBusStats(CANDriver* driver, uint32_t can_id, uint16_t telem_id);
+  ~CANBusStats();
+  // Snapshot of the driver counters, larger than one classic CAN frame so it is meant for PitComms
+  void ToByteArray(uint8_t* buff) const;
+  // Counters are generated locally, there is nothing to decode
+  void FromByteArray(uint8_t* buff);
+  static constexpr uint8_t Size = 16;
+private:
+  static uint8_t Saturate8(uint32_t value);
+  static uint16_t Saturate16(uint32_t value);
+  CANDriver* driver_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANBUSSTATS_HPP_ */
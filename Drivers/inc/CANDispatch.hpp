@@ -0,0 +1,72 @@
+/*
+ * CANDispatch.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Constant time lookup from a received CAN ID to the DataModule that decodes it.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANDISPATCH_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANDISPATCH_HPP_
+
+#include <cstdint>
+#include <DataModule.hpp>
+#include <CANSubscriptions.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+// Open addressed hash table keyed on the full 29 bit ID plus the IDE bit,
+// kept at most half full so a lookup is almost always a single probe.
+// Entries are stored densely so walking every registered ID is cheap.
+class CANDispatchTable {
+public:
+  static constexpr uint8_t MAX_MODULES = 64;
+  static constexpr uint8_t SLOT_COUNT = 2 * MAX_MODULES;
+  enum class Result : uint8_t {
+    Ok,
+    Duplicate,
+    Full
+  };
+  struct Entry {
+    DataModules::DataModule* module;
+    uint32_t rx_count;                             // Frames received for this ID
+    uint32_t last_tick;                            // Tick the last frame arrived
+    uint32_t window_count;                         // rx_count at the start of the rate window
+    uint16_t rate;                                 // Frames per second over the last window
+    uint8_t subscription;                          // First CANSubscriptions entry for this ID
+  };
+  CANDispatchTable();
+  ~CANDispatchTable();
+  Result Insert(DataModules::DataModule* module);
+  bool Remove(uint32_t id, bool is_ext);
+  // Returns nullptr if no module is registered for the ID
+  Entry* Find(uint32_t id, bool is_ext);
+  const Entry* Find(uint32_t id, bool is_ext) const;
+  uint8_t Size() const;
+  void Clear();
+  template <typename Function>
+  void ForEach(Function fn)
+  {
+    for (uint8_t i = 0; i < size_; ++i)
+      fn(entries_[i]);
+  }
+private:
+  static constexpr uint8_t EMPTY = 0xFF;
+  uint8_t FindSlot(uint32_t key) const;
+  static uint32_t MakeKey(uint32_t id, bool is_ext);
+  static uint8_t Hash(uint32_t key);
+  static constexpr uint32_t ID_MASK = 0x1FFFFFFF;
+  static constexpr uint32_t EXT_FLAG = 0x80000000;
+  static constexpr uint8_t SLOT_BITS = 7;
+  static_assert((1 << SLOT_BITS) == SLOT_COUNT, "SLOT_BITS must match SLOT_COUNT");
+  uint32_t keys_[SLOT_COUNT];                      // Key in each hash slot
+  uint8_t slot_entry_[SLOT_COUNT];                 // Index into entries_, or EMPTY
+  Entry entries_[MAX_MODULES];
+  uint8_t size_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANDISPATCH_HPP_ */
@@ -0,0 +1,37 @@
+/*
+ * CANErrorStats.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Exposes the CAN driver error state and its transition history as a DataModule.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANERRORSTATS_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANERRORSTATS_HPP_
+
+#include <DataModule.hpp>
+#include <CAN.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANErrorStats final : public DataModules::DataModule {
+public:
+  CANErrorStats(CANDriver* driver, uint32_t can_id, uint16_t telem_id);
+  ~CANErrorStats();
+  // [0] state in bits 1:0, state before the last transition in bits 3:2
+  // [1] TEC, [2] REC, [3..5] times error warning, error passive and bus-off were entered
+  // [6..7] seconds since the last transition, 0xFFFF if there hasn't been one
+  void ToByteArray(uint8_t* buff) const;
+  // Generated locally, there is nothing to decode
+  void FromByteArray(uint8_t* buff);
+  static constexpr uint8_t Size = 8;
+private:
+  static uint8_t Saturate8(uint32_t value);
+  CANDriver* driver_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANERRORSTATS_HPP_ */
@@ -0,0 +1,98 @@
+/*
+ * CANFilter.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Plans the bxCAN hardware acceptance filter banks from the set of
+ *               CAN IDs the driver actually wants so unwanted frames never reach the RX path.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANFILTER_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANFILTER_HPP_
+
+#include <cstdint>
+#include "etl/vector.h"
+
+namespace SolarGators {
+namespace Drivers {
+
+struct CANFilterId {
+  uint32_t id;
+  bool is_ext;
+  bool is_rtr;                    // Accept remote frames for the ID instead of data frames
+  uint8_t fifo;
+};
+
+// One bxCAN filter bank, FR1/FR2 are laid out exactly like the filter bank registers
+// (see the bxCAN "identifier filtering" section of the reference manual)
+struct CANFilterBank {
+  enum class Mode : uint8_t {
+    IdList,
+    IdMask
+  };
+  enum class Scale : uint8_t {
+    Bit16,
+    Bit32
+  };
+  Mode mode;
+  Scale scale;
+  uint8_t fifo;
+  uint32_t fr1;
+  uint32_t fr2;
+};
+
+class CANFilterPlanner {
+public:
+  static constexpr uint8_t MAX_IDS = 64;           // Maximum number of IDs that can be planned
+  static constexpr uint8_t MAX_BANKS = 28;         // Filter banks shared by both bxCANs on dual CAN parts
+  static constexpr uint8_t DEFAULT_BANKS = 14;     // Filter banks available on the STM32F0
+  CANFilterPlanner();
+  ~CANFilterPlanner();
+  bool AddId(uint32_t id, bool is_ext, uint8_t fifo = 0, bool is_rtr = false);
+  bool RemoveId(uint32_t id, bool is_ext, bool is_rtr = false);
+  void Clear();
+  // Builds the smallest bank layout that accepts exactly the added IDs.
+  // If that does not fit in the bank limit the layout falls back to sending every frame to
+  // bulk_fifo except the IDs assigned to the other fifo, and Plan returns false.
+  bool Plan(uint8_t bulk_fifo = 0);
+  // Always use the fallback layout, for nodes that need frames they can't list by ID
+  void SetAcceptAll(bool accept_all);
+  const etl::vector<CANFilterBank, MAX_BANKS>& GetBanks() const;
+  // Banks a layout may use, clamped to 1 to MAX_BANKS. Takes effect on the next Plan.
+  void SetBankLimit(uint8_t limit);
+  uint8_t GetBankLimit() const;
+private:
+  // A group of IDs sharing every bit not set in dont_care_
+  struct Group {
+    uint32_t value;
+    uint32_t dont_care;
+    bool rtr;
+  };
+  using GroupList = etl::vector<Group, MAX_IDS>;
+  void Merge(GroupList& groups);
+  bool PlanFifo(uint8_t fifo);
+  bool PlanStandard(GroupList& groups, uint8_t fifo);
+  bool PlanExtended(GroupList& groups, uint8_t fifo);
+  void PlanFallback(uint8_t bulk_fifo);
+  bool AddBank(CANFilterBank::Mode mode, CANFilterBank::Scale scale, uint8_t fifo, uint32_t fr1, uint32_t fr2);
+  // Register encodings
+  static uint32_t Std16(uint32_t id, bool rtr = false);
+  static uint32_t Ext32(uint32_t id, bool rtr = false);
+  static constexpr uint32_t IDE_16 = 1 << 3;
+  static constexpr uint32_t IDE_32 = 1 << 2;
+  static constexpr uint32_t RTR_16 = 1 << 4;
+  static constexpr uint32_t RTR_32 = 1 << 1;
+  static constexpr uint32_t STD_MASK = 0x7FF;
+  static constexpr uint32_t EXT_MASK = 0x1FFFFFFF;
+  // Groups of at least this many IDs are cheaper as a mask filter than as list entries
+  static constexpr uint8_t MIN_MASK_GROUP = 4;
+  etl::vector<CANFilterId, MAX_IDS> ids_;
+  etl::vector<CANFilterBank, MAX_BANKS> banks_;
+  uint8_t bank_limit_;
+  bool accept_all_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANFILTER_HPP_ */
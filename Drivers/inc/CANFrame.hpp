@@ -0,0 +1,52 @@
+/*
+ * CANFrame.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Raw CAN frame as it is passed between the CAN interrupt and the driver tasks.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANFRAME_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANFRAME_HPP_
+
+#include <cstdint>
+
+namespace SolarGators {
+namespace Drivers {
+
+struct CANFrame {
+  // Boards with an FDCAN peripheral build with SOLARGATORS_CAN_FD to carry up to 64 data bytes.
+  // Classic boards keep 8 so the rx rings and tx queue stay small.
+#ifdef SOLARGATORS_CAN_FD
+  static constexpr uint8_t MAX_DATA_SIZE = 64;
+#else
+  static constexpr uint8_t MAX_DATA_SIZE = 8;
+#endif
+  uint32_t id;                    // 11 or 29 bit identifier
+  uint32_t tick;                  // Kernel tick the frame was received (or queued) at
+  uint8_t dlc;                    // Data length code, above 8 only valid for FD frames
+  bool is_ext;                    // Extended identifier
+  bool is_rtr;                    // Remote transmission request
+  bool is_fd = false;             // CAN FD format
+  bool brs = false;               // FD bit rate switch for the data phase
+  uint8_t data[MAX_DATA_SIZE];
+  uint8_t Length() const
+  {
+    return DlcToLength(dlc);
+  }
+  // DLC 9-15 select 12, 16, 20, 24, 32, 48 and 64 bytes
+  static constexpr uint8_t DlcToLength(uint8_t dlc)
+  {
+    return dlc <= 8 ? dlc : dlc <= 12 ? 8 + 4 * (dlc - 8) : dlc == 13 ? 32 : dlc == 14 ? 48 : 64;
+  }
+  // Smallest DLC that holds len bytes, the rest of the frame is padding
+  static constexpr uint8_t LengthToDlc(uint8_t len)
+  {
+    return len <= 8 ? len : len <= 24 ? 8 + (len - 5) / 4 : len <= 32 ? 13 : len <= 48 ? 14 : 15;
+  }
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANFRAME_HPP_ */
@@ -0,0 +1,99 @@
+/*
+ * CANFrameRing.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Lock free single producer / single consumer ring of CAN frames.
+ *               The producer is the CAN RX interrupt, the consumer is the CAN RX task.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANFRAMERING_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANFRAMERING_HPP_
+
+#include <atomic>
+#include <cstdint>
+
+#include "CANFrame.hpp"
+
+namespace SolarGators {
+namespace Drivers {
+
+template <uint16_t SIZE>
+class CANFrameRing {
+  static_assert(SIZE > 0 && (SIZE & (SIZE - 1)) == 0, "CANFrameRing size must be a power of two");
+  static_assert(SIZE <= 0x8000, "CANFrameRing indices are 16 bit");
+public:
+  CANFrameRing():head_(0),tail_(0),overflow_count_(0),high_water_(0)
+  { }
+
+  // ---- Producer side (interrupt) ---- //
+  // Slot to write the next frame into, or nullptr if the ring is full (the frame is counted as lost)
+  CANFrame* Claim()
+  {
+    uint16_t head = head_.load(std::memory_order_relaxed);
+    uint16_t used = head - tail_.load(std::memory_order_acquire);
+    if(used >= SIZE)
+    {
+      overflow_count_ = overflow_count_ + 1;
+      return nullptr;
+    }
+    if(used + 1 > high_water_)
+      high_water_ = used + 1;
+    return &frames_[head & (SIZE - 1)];
+  }
+  // Publish the slot returned by Claim
+  void Commit()
+  {
+    head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+  bool Push(const CANFrame& frame)
+  {
+    CANFrame* slot = Claim();
+    if(slot == nullptr)
+      return false;
+    *slot = frame;
+    Commit();
+    return true;
+  }
+
+  // ---- Consumer side (task) ---- //
+  // Number of frames ready to be read, frames stay valid until they are released
+  uint16_t Available() const
+  {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+  }
+  // Frame i of the current batch, i must be less than Available()
+  const CANFrame& Peek(uint16_t i) const
+  {
+    return frames_[(tail_.load(std::memory_order_relaxed) + i) & (SIZE - 1)];
+  }
+  // Hand count frames back to the producer
+  void Release(uint16_t count)
+  {
+    tail_.store(tail_.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+  bool Pop(CANFrame& frame)
+  {
+    if(Available() == 0)
+      return false;
+    frame = Peek(0);
+    Release(1);
+    return true;
+  }
+
+  // ---- Statistics ---- //
+  uint32_t GetOverflowCount() const { return overflow_count_; }
+  uint16_t GetHighWater() const { return high_water_; }
+  static constexpr uint16_t Capacity() { return SIZE; }
+private:
+  CANFrame frames_[SIZE];
+  std::atomic<uint16_t> head_;                     // Next slot to write, only written by the producer
+  std::atomic<uint16_t> tail_;                     // Next slot to read, only written by the consumer
+  volatile uint32_t overflow_count_;               // Frames dropped because the ring was full
+  volatile uint16_t high_water_;                   // Most frames ever waiting in the ring
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANFRAMERING_HPP_ */
@@ -0,0 +1,90 @@
+/*
+ * CANGateway.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Bridges two CAN buses by forwarding raw frames between two CANDriver instances
+ *               according to a routing table that is compiled once at startup.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANGATEWAY_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANGATEWAY_HPP_
+
+#include "etl/vector.h"
+
+#include <CAN.hpp>
+#include <CANFrame.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANGateway {
+public:
+  static constexpr uint8_t MAX_ROUTES = 32;        // Per port
+  static constexpr uint32_t KEEP_ID = 0xFFFFFFFF;
+  enum class Port : uint8_t {
+    A,
+    B
+  };
+  enum class Action : uint8_t {
+    Forward,
+    Drop
+  };
+  struct Route {
+    uint32_t id;
+    uint32_t mask;                                 // ID bits that must match, ID_EXACT for a single ID
+    bool is_ext;
+    Action action;
+    uint32_t remap_id;                             // ID on the other bus, KEEP_ID to keep it
+    bool remap_ext;                                // IDE on the other bus when remapping
+    uint32_t min_interval;                         // Ticks between forwarded frames, 0 for no limit
+    bool local;                                    // Also hand the frame to this port's rx modules
+  };
+  struct RouteStats {
+    uint32_t forwarded;
+    uint32_t dropped;                              // By a Drop route
+    uint32_t rate_limited;
+    uint32_t tx_full;                              // The other port's tx queue was full
+  };
+  static constexpr uint32_t ID_EXACT = 0x1FFFFFFF;
+  CANGateway(CANDriver* port_a, CANDriver* port_b);
+  ~CANGateway();
+  // Routes can only be added before Compile. Exact routes are matched first, then masked
+  // routes in the order they were added.
+  bool AddRoute(Port from, const Route& route);
+  // Sorts the tables, sets up the hardware filters and installs the frame hooks.
+  // Call before starting the drivers. Returns false if a routed ID didn't fit in the input
+  // port's filters, frames for it will never arrive.
+  bool Compile(Action default_action = Action::Drop);
+  const RouteStats* GetRouteStats(Port from, uint32_t id, bool is_ext) const;
+  uint32_t GetUnroutedCount(Port from) const;      // Frames handled by the default action
+  uint32_t GetMaxLatency(Port from) const;         // Worst ticks from arrival to queued on the other port
+private:
+  struct CompiledRoute {
+    Route route;
+    uint32_t last_forward;
+    bool forwarded_once;
+    RouteStats stats;
+  };
+  struct Table {
+    CANDriver* in;
+    CANDriver* out;
+    etl::vector<CompiledRoute, MAX_ROUTES> exact;  // Sorted by Key
+    etl::vector<CompiledRoute, MAX_ROUTES> masked;
+    uint32_t unrouted;
+    uint32_t max_latency;
+  };
+  bool HandleFrame(Table& table, const CANFrame& frame);
+  void Forward(Table& table, CompiledRoute* compiled, const CANFrame& frame);
+  static CompiledRoute* FindExact(Table& table, uint32_t key);
+  static uint32_t Key(uint32_t id, bool is_ext);
+  bool CompileTable(Table& table);
+  Table tables_[2];
+  Action default_action_;
+  bool compiled_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANGATEWAY_HPP_ */
@@ -0,0 +1,138 @@
+/*
+ * CANIsoTp.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: ISO 15765-2 (ISO-TP) transport so DataModules larger than one CAN frame
+ *               can be sent and received. Runs on top of CANDriver.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANISOTP_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANISOTP_HPP_
+
+#include <cmsis_os.h>
+#include "etl/vector.h"
+
+#include <CAN.hpp>
+#include <DataModule.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANIsoTp;
+
+// One direction of an ISO-TP link for a single DataModule. The channel is registered with the
+// CAN driver as the module for the ID it listens on and passes those frames to CANIsoTp.
+class CANIsoTpChannel final : public DataModules::DataModule {
+public:
+  enum class Direction : uint8_t {
+    Rx,                                            // module is filled from frames on data_id, flow control goes out on fc_id
+    Tx                                             // module is segmented onto data_id, flow control comes in on fc_id
+  };
+  CANIsoTpChannel(DataModules::DataModule* module, Direction direction, uint32_t data_id, uint32_t fc_id, bool is_ext = false);
+  ~CANIsoTpChannel();
+  void ToByteArray(uint8_t* buff) const override;
+  void FromByteArray(uint8_t* buff) override;
+private:
+  friend class CANIsoTp;
+  DataModules::DataModule* module_;
+  const Direction direction_;
+  const uint32_t data_id_;
+  const uint32_t fc_id_;
+  CANIsoTp* owner_;
+  // Reassembly state, only touched by the CAN rx task
+  uint8_t buffer_;                                 // Index into the pool, NO_BUFFER when idle
+  uint16_t expected_;
+  uint16_t received_;
+  uint8_t next_sn_;
+  uint8_t block_left_;
+  // Transmit state
+  volatile bool tx_pending_;
+};
+
+class CANIsoTp {
+public:
+  static constexpr uint16_t MAX_MESSAGE_SIZE = 256;  // Largest module that can be carried
+  static constexpr uint8_t POOL_SIZE = 4;          // Reassemblies that can be in flight at once
+  static constexpr uint8_t MAX_CHANNELS = 16;
+  static constexpr uint8_t RX_BLOCK_SIZE = 0;      // Consecutive frames between flow controls, 0 is unlimited
+  static constexpr uint8_t RX_STMIN = 0;           // Separation time we ask senders for (ms)
+  static constexpr uint32_t TIMEOUT_MS = 1000;     // N_Bs and N_Cr
+  static constexpr uint8_t MAX_WAIT_FRAMES = 10;   // Flow control WAITs before giving up
+  struct Stats {
+    uint32_t rx_messages;
+    uint32_t tx_messages;
+    uint32_t rx_aborts;                            // Sequence errors, timeouts and lost frames
+    uint32_t tx_aborts;                            // No or refused flow control
+    uint32_t pool_exhausted;                       // First frames refused because every buffer was busy
+  };
+  CANIsoTp(CANDriver* driver);
+  ~CANIsoTp();
+  void Init();
+  // Registers the channel with the CAN driver
+  bool AddChannel(CANIsoTpChannel* channel);
+  // Queues the channel's module for transmission, false if it is already waiting
+  bool Send(CANIsoTpChannel* channel);
+  const Stats& GetStats() const;
+private:
+  friend class CANIsoTpChannel;
+  // Protocol control information, upper nibble of the first byte
+  static constexpr uint8_t PCI_SINGLE = 0x00;
+  static constexpr uint8_t PCI_FIRST = 0x10;
+  static constexpr uint8_t PCI_CONSECUTIVE = 0x20;
+  static constexpr uint8_t PCI_FLOW = 0x30;
+  static constexpr uint8_t FLOW_CTS = 0;
+  static constexpr uint8_t FLOW_WAIT = 1;
+  static constexpr uint8_t FLOW_OVERFLOW = 2;
+  static constexpr uint8_t PADDING = 0xCC;
+  static constexpr uint8_t NO_BUFFER = 0xFF;
+  static constexpr uint32_t FLAG_SEND = 0x1;
+  static constexpr uint32_t FLAG_FLOW = 0x2;
+  struct Buffer {
+    uint8_t data[MAX_MESSAGE_SIZE];
+    CANIsoTpChannel* owner;                        // nullptr while free
+    uint32_t last_tick;                            // Last frame, stale buffers are reclaimed
+  };
+  void HandleFrame(CANIsoTpChannel& channel, const uint8_t* data);
+  void HandleFlowControl(CANIsoTpChannel& channel, const uint8_t* data);
+  void HandleSingle(CANIsoTpChannel& channel, const uint8_t* data);
+  void HandleFirst(CANIsoTpChannel& channel, const uint8_t* data);
+  void HandleConsecutive(CANIsoTpChannel& channel, const uint8_t* data);
+  void Complete(CANIsoTpChannel& channel, const uint8_t* data);
+  void Abort(CANIsoTpChannel& channel);
+  uint8_t AllocateBuffer(CANIsoTpChannel& channel);
+  void SendFlowControl(const CANIsoTpChannel& channel, uint8_t status);
+  void HandleTransmit();
+  bool Transmit(CANIsoTpChannel& channel);
+  bool WaitForFlowControl();
+  bool SendSegment(const CANIsoTpChannel& channel, const uint8_t* payload, uint8_t len);
+  uint32_t MsToTicks(uint32_t ms) const;
+  static uint32_t SeparationMs(uint8_t stmin);
+  CANDriver* driver_;
+  etl::vector<CANIsoTpChannel*, MAX_CHANNELS> channels_;
+  Buffer pool_[POOL_SIZE];
+  Stats stats_;
+  // Transmit side, owned by the ISO-TP task. Flow control arrives on the CAN rx task.
+  CANIsoTpChannel* volatile tx_active_;
+  volatile uint8_t fc_status_;
+  volatile uint8_t fc_block_size_;
+  volatile uint8_t fc_stmin_;
+  uint8_t tx_buffer_[MAX_MESSAGE_SIZE];
+  osThreadId_t task_handle_;                       // Tx Task Handle
+  uint32_t task_buffer_[ 128 ];                    // Tx Task Buffer
+  StaticTask_t task_control_block_;                // Tx Task Control Block
+  const osThreadAttr_t task_attributes_ =          // Tx Task Attributes
+  {
+    .name = "CAN ISO-TP",
+    .cb_mem = &task_control_block_,
+    .cb_size = sizeof(task_control_block_),
+    .stack_mem = &task_buffer_[0],
+    .stack_size = sizeof(task_buffer_),
+    .priority = (osPriority_t) osPriorityAboveNormal,
+  };
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANISOTP_HPP_ */
@@ -0,0 +1,81 @@
+/*
+ * CANLog.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: The CAN log format written by CANRecorder and a reader for it. Nothing here
+ *               depends on the RTOS or HAL, so pit and desktop tools can build it as is.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANLOG_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANLOG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "etl/vector.h"
+
+#include "CANFrame.hpp"
+
+namespace SolarGators {
+namespace Drivers {
+
+// Log format, every multi byte field is little endian.
+//
+// Session start: 0x10, version, tick[4]
+//   Resets the ID dictionary and sets the absolute tick the following deltas build on.
+// Frame: header, delta, id, data[dlc]
+//   header [7] sent by this node, [6] remote frame, [5] new ID, [4] 0, [3:0] dlc
+//   delta  zigzag varint of the tick minus the previous record's tick (rx and tx frames
+//          are recorded in task order so this can be negative)
+//   id     new ID: id[4] with bit 31 set for extended IDs, and it takes the next free
+//          dictionary index if there is one. Otherwise the 1 byte dictionary index.
+//   data   CANFrame::DlcToLength(dlc) bytes, none for remote frames. FD and BRS are not kept.
+// A typical 8 byte frame takes 11 bytes against 16 for the raw frame plus a timestamp.
+namespace CANLog {
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t START = 0x10;
+  static constexpr uint8_t START_SIZE = 6;
+  static constexpr uint8_t TX_FLAG = 0x80;
+  static constexpr uint8_t RTR_FLAG = 0x40;
+  static constexpr uint8_t NEW_ID_FLAG = 0x20;
+  static constexpr uint8_t CONTROL_FLAG = 0x10;
+  static constexpr uint8_t DLC_MASK = 0x0F;
+  static constexpr uint32_t EXT_FLAG = 0x80000000;
+  static constexpr uint32_t ID_MASK = 0x1FFFFFFF;
+  static constexpr uint8_t DICTIONARY_SIZE = 64;
+  // Header, 5 byte varint, 4 byte ID and data
+  static constexpr uint8_t MAX_RECORD_SIZE = 1 + 5 + 4 + CANFrame::MAX_DATA_SIZE;
+  enum class Direction : uint8_t {
+    Rx,
+    Tx
+  };
+} /* namespace CANLog */
+
+class CANLogReader {
+public:
+  enum class Status : uint8_t {
+    Frame,                                         // frame and direction are valid
+    End,                                           // Ran out of data on a record boundary
+    Error                                          // Truncated or corrupt log
+  };
+  CANLogReader(const uint8_t* data, size_t size);
+  ~CANLogReader();
+  Status Next(CANFrame& frame, CANLog::Direction& direction);
+  void Rewind();
+  size_t GetOffset() const;
+private:
+  bool ReadByte(uint8_t& value);
+  bool ReadVarint(uint32_t& value);
+  bool ReadWord(uint32_t& value);
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+  bool started_;                                   // A session start record has been seen
+  uint32_t tick_;
+  etl::vector<uint32_t, CANLog::DICTIONARY_SIZE> dictionary_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANLOG_HPP_ */
@@ -0,0 +1,60 @@
+/*
+ * CANRecorder.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Records received and sent CAN frames into a RAM ring in the compact CANLog
+ *               format that can be flushed to the pit or to storage and replayed later with CANReplay.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANRECORDER_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANRECORDER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "etl/vector.h"
+
+#include "CANFrame.hpp"
+#include "CANLog.hpp"
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANRecorder {
+public:
+  using Direction = CANLog::Direction;
+  // Takes bytes from the front of the log, returns how many it accepted
+  using Sink = std::function<size_t(const uint8_t*, size_t)>;
+  // size must be a power of two
+  CANRecorder(uint8_t* buffer, uint32_t size);
+  ~CANRecorder();
+  // Begins a session. Call again to give a reader that missed the start a fresh dictionary.
+  bool Start();
+  void Stop();
+  bool IsRecording() const;
+  // Safe from any task or interrupt. Frames that do not fit are dropped whole.
+  bool Record(const CANFrame& frame, Direction direction);
+  // Hands the recorded bytes to sink, from a single task only. Returns the bytes taken.
+  size_t Flush(const Sink& sink);
+  uint32_t GetUsed() const;
+  uint32_t GetRecordCount() const;
+  uint32_t GetDropCount() const;
+private:
+  bool Write(const uint8_t* data, uint8_t len);
+  static uint8_t EncodeVarint(uint32_t value, uint8_t* out);
+  uint8_t* buffer_;
+  uint32_t mask_;
+  volatile uint32_t head_;                         // Written under the critical section
+  volatile uint32_t tail_;                         // Written by Flush
+  bool recording_;
+  uint32_t last_tick_;                             // Tick of the last record written
+  etl::vector<uint32_t, CANLog::DICTIONARY_SIZE> dictionary_;
+  uint32_t record_count_;
+  uint32_t drop_count_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANRECORDER_HPP_ */
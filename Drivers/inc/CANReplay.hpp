@@ -0,0 +1,48 @@
+/*
+ * CANReplay.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Reads logs written by CANRecorder and feeds them back through the real
+ *               DataModule decoders, in real time, sped up or as fast as possible.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANREPLAY_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANREPLAY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <CANDispatch.hpp>
+#include <CANFrame.hpp>
+#include <CANLog.hpp>
+#include <DataModule.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANReplay {
+public:
+  static constexpr uint16_t UNTHROTTLED = 0;
+  struct Stats {
+    uint32_t frames;                               // Frames read from the log
+    uint32_t decoded;                              // Frames that matched a module
+    uint32_t unknown;                              // Frames with no module
+    uint32_t ticks;                                // Kernel ticks the run took, frames / ticks is the decode throughput when unthrottled
+    bool error;                                    // The log was cut short or corrupt
+  };
+  CANReplay();
+  ~CANReplay();
+  bool AddModule(DataModules::DataModule* module);
+  bool RemoveModule(uint32_t id, bool is_ext);
+  // speed is a multiple of real time, UNTHROTTLED replays without waiting.
+  // Sent frames are only replayed with include_tx, normally they are this node's own modules.
+  Stats Run(CANLogReader& reader, uint16_t speed = 1, bool include_tx = false);
+private:
+  CANDispatchTable modules_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANREPLAY_HPP_ */
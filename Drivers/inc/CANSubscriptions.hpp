@@ -0,0 +1,77 @@
+/*
+ * CANSubscriptions.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Wakes tasks through RTOS flags when the CAN rx task decodes a frame that
+ *               changed the signals they care about, so they don't have to poll getters.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANSUBSCRIPTIONS_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANSUBSCRIPTIONS_HPP_
+
+#include <cstdint>
+#include <cmsis_os.h>
+
+#include "CANFrame.hpp"
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANSubscriptions {
+public:
+  static constexpr uint8_t MAX_SUBSCRIPTIONS = 16;
+  static constexpr uint8_t NONE = 0xFF;
+  static constexpr uint64_t ALL_SIGNALS = ~0ull;
+  static constexpr uint32_t NO_DEADLINE = 0xFFFFFFFF;
+  // Bits of the payload read as a little endian 64 bit word, so bit 0 is bit 0 of byte 0.
+  // Bytes past the eighth of an FD frame only count towards ALL_SIGNALS.
+  static constexpr uint64_t SignalMask(uint8_t start_bit, uint8_t length)
+  {
+    return (length >= 64 ? ALL_SIGNALS : ((1ull << length) - 1)) << start_bit;
+  }
+  struct Target {
+    osThreadId_t thread;                           // Thread flags are set on this thread if it isn't null
+    osEventFlagsId_t event;                        // otherwise on this event flags object
+    uint32_t flags;
+  };
+  CANSubscriptions();
+  ~CANSubscriptions();
+  // Links a new subscription in front of head and returns its index, NONE if the pool is empty
+  uint8_t Add(uint8_t head, const Target& target, uint64_t mask, uint32_t coalesce_ticks);
+  // Unlinks every subscription in the chain waking the given thread or event flags, returns the new head
+  uint8_t Remove(uint8_t head, const void* target);
+  // Unlinks the whole chain
+  void RemoveAll(uint8_t head);
+  // Runs every subscription in the chain against a newly decoded frame
+  void OnFrame(uint8_t head, const CANFrame& frame, uint32_t now);
+  // Delivers coalesced notifications that are due, returns ticks until the next one or NO_DEADLINE
+  uint32_t Poll(uint32_t now);
+  uint32_t GetNotifyCount() const;
+  uint32_t GetCoalescedCount() const;              // Changes folded into a later notification
+private:
+  struct Subscription {
+    Target target;
+    uint64_t mask;
+    uint32_t coalesce_ticks;                       // Minimum ticks between notifications
+    uint32_t last_notify;
+    uint8_t next;                                  // Next subscription for the same module, or the free list
+    bool primed;                                   // last_data holds a frame
+    bool pending;                                  // A change is waiting for the coalescing window
+    uint8_t last_length;
+    uint8_t last_data[CANFrame::MAX_DATA_SIZE];
+  };
+  bool Changed(Subscription& subscription, const CANFrame& frame);
+  void Notify(Subscription& subscription, uint32_t now);
+  static uint64_t Load64(const uint8_t* data, uint8_t length);
+  Subscription subscriptions_[MAX_SUBSCRIPTIONS];
+  uint8_t free_;
+  uint8_t pending_count_;
+  uint32_t notify_count_;
+  uint32_t coalesced_count_;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANSUBSCRIPTIONS_HPP_ */
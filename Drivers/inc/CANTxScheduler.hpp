@@ -0,0 +1,80 @@
+/*
+ * CANTxScheduler.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Sends DataModules on a fixed period from a single timer, staggering their
+ *               phases so frames are spread out instead of hitting the mailboxes together.
+ */
+
+#ifndef SOLARGATORSBSP_DRIVERS_INC_CANTXSCHEDULER_HPP_
+#define SOLARGATORSBSP_DRIVERS_INC_CANTXSCHEDULER_HPP_
+
+#include <cmsis_os.h>
+#include "etl/vector.h"
+
+#include <CAN.hpp>
+#include <DataModule.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANTxScheduler {
+public:
+  static constexpr uint8_t MAX_ENTRIES = 16;
+  static constexpr uint32_t AUTO_PHASE = 0xFFFFFFFF;   // Pick the least crowded phase
+  struct Stats {
+    uint32_t sent;                                     // Frames queued by the scheduler
+    uint32_t changes;                                  // Of those, sent early because the data changed
+    uint32_t deferred;                                 // Ticks the frame was due but the tx queue was full
+    uint32_t busy;                                     // Ticks the frame was due but the module was locked
+    uint32_t max_jitter;                               // Worst lateness against the ideal schedule (ticks)
+    uint32_t total_jitter;                             // Sum of lateness, divide by sent - changes for the mean
+  };
+  CANTxScheduler(CANDriver* driver);
+  virtual ~CANTxScheduler();
+  void Init();
+  // period and phase are in kernel ticks. With send_on_change the module is also
+  // sent on the first tick its bytes differ from the last frame sent
+  bool AddModule(DataModules::DataModule* module, uint32_t period, uint32_t phase = AUTO_PHASE, bool send_on_change = false);
+  bool RemoveModule(DataModules::DataModule* module);
+  bool GetStats(DataModules::DataModule* module, Stats& stats) const;
+  void Tick();
+private:
+  struct Entry {
+    DataModules::DataModule* module;
+    uint32_t period;
+    uint32_t phase;
+    uint32_t next_due;
+    bool send_on_change;
+    uint8_t last_data[CANFrame::MAX_DATA_SIZE];
+    Stats stats;
+  };
+  static void TimerCallback(void* arg);
+  uint32_t PickPhase(uint32_t period) const;
+  static uint32_t Gcd(uint32_t a, uint32_t b);
+  CANDriver* driver_;
+  etl::vector<Entry, MAX_ENTRIES> entries_;
+  uint32_t epoch_;                                     // Tick every phase is measured from
+  osTimerId_t timer_;                                  // Scheduler Timer
+  StaticTimer_t timer_control_block_;                  // Scheduler Timer Control Block
+  const osTimerAttr_t timer_attributes_ =              // Scheduler Timer Attributes
+  {
+    .name = "CAN Tx Scheduler",
+    .cb_mem = &timer_control_block_,
+    .cb_size = sizeof(timer_control_block_),
+  };
+  osMutexId_t mutex_id_;                               // Protects the entry table
+  StaticSemaphore_t mutex_control_block_;
+  const osMutexAttr_t mutex_attributes_ = {
+    .name = "CTS",
+    .attr_bits = osMutexRecursive,
+    .cb_mem = &mutex_control_block_,
+    .cb_size = sizeof(mutex_control_block_),
+  };
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_DRIVERS_INC_CANTXSCHEDULER_HPP_ */
@@ -21,6 +21,7 @@ namespace Drivers {
 class PitComms {
 private:
   static constexpr uint8_t MAX_PACKETS = 10;
+  static constexpr uint8_t MAX_MODULE_SIZE = 64;  // Largest data module, matches a CAN FD frame
   static constexpr uint8_t START_CHAR = 0xFF;
   static constexpr uint8_t ESC_CHAR = 0x2F;
   static constexpr uint8_t END_CHAR = 0x3F;
@@ -30,6 +31,8 @@ public:
   virtual ~PitComms();
   void Init();
   void SendDataModule(SolarGators::DataModules::DataModule& data_module);
+  // Sends a raw block (e.g. a chunk of a CANRecorder log) framed like a data module
+  void SendBytes(uint8_t telem_id, const uint8_t* data, uint8_t len);
   void EscapeData(uint8_t data);
 private:
 };
@@ -6,28 +6,42 @@
  */
 
 #include <CAN.hpp>
+#include <cstring>
 
 namespace SolarGators {
 namespace Drivers {
 
-CANDriver::CANDriver(CAN_HandleTypeDef* hcan, uint32_t rx_fifo_num_):hcan_(hcan),rx_fifo_num_(rx_fifo_num_)
-{
+uint8_t CANDriver::slave_start_filter_bank_ = CANFilterPlanner::DEFAULT_BANKS;
 
+CANDriver::CANDriver(CAN_HandleTypeDef* hcan, uint32_t rx_fifo_num_):hcan_(hcan),rx_fifo_num_(rx_fifo_num_),
+    priority_fifo_num_(rx_fifo_num_ == CAN_RX_FIFO0 ? CAN_RX_FIFO1 : CAN_RX_FIFO0), first_filter_bank_(0), active_filter_banks_(0), started_(false), tx_sequence_(0), tx_queue_high_water_(0), tx_drop_count_(0),
+    tx_wait_ticks_(0), tx_max_wait_ticks_(0), rx_frame_count_(0), tx_frame_count_(0), unknown_id_count_(0),
+    rx_bits_(0), tx_bits_(0), bit_rate_(0), stats_window_ticks_(1000), stats_window_start_(0), window_rx_frames_(0),
+    window_tx_frames_(0), window_bits_(0), rx_rate_(0), tx_rate_(0), bus_load_(0), last_stale_check_(0), recorder_(nullptr),
+    bus_off_policy_{10, 1000, false}, error_state_(ErrorState::Active), error_state_counts_{},
+    error_history_next_(0), error_history_count_(0), backoff_ms_(10), recovery_timer_(nullptr), rx_task_handle_(nullptr)
+{
+  rx_fifo_overruns_[0] = 0;
+  rx_fifo_overruns_[1] = 0;
+  modules_ = &module_tables_[0];
+  rx_table_ = nullptr;
+  retired_subscription_ = CANSubscriptions::NONE;
+  registry_mutex_ = osMutexNew(&registry_mutex_attributes_);
 }
 
 void CANDriver::Init()
 {
-  // Configure Filter
-  //Initialize a hardware filter that passes everything
-  CAN_FilterTypeDef sFilterConfig;
-  sFilterConfig.FilterActivation = CAN_FILTER_ENABLE; /*Enable the filter*/
-  sFilterConfig.FilterMode = CAN_FILTERMODE_IDMASK;   /*Mask mode*/
-  sFilterConfig.FilterMaskIdHigh = 0;
-  sFilterConfig.FilterMaskIdLow = 0;                  /*Accept everything*/
-  sFilterConfig.FilterScale = CAN_FILTERSCALE_32BIT;  /*One 32-bit filter*/
-  sFilterConfig.FilterBank = 0;                       /*Init bank 0*/
-  sFilterConfig.FilterFIFOAssignment = 0;             /*Assign to FIFO 0*/
-  HAL_CAN_ConfigFilter(hcan_, &sFilterConfig);
+  // Configure Filters for the modules registered so far
+  ConfigureFilters();
+  started_ = true;
+
+  // Nominal bit time is 1 sync quantum + BS1 + BS2, the register holds each field minus one
+  uint32_t btr = hcan_->Instance->BTR;
+  uint32_t prescaler = ((btr & CAN_BTR_BRP) >> CAN_BTR_BRP_Pos) + 1;
+  uint32_t quanta = ((btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos) + ((btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos) + 3;
+  bit_rate_ = HAL_RCC_GetPCLK1Freq() / (prescaler * quanta);
+  stats_window_ticks_ = osKernelGetTickFreq();
+  stats_window_start_ = osKernelGetTickCount();
 
   can_rx_event_ = osEventFlagsNew(NULL);
   if (can_rx_event_ == NULL)
@@ -35,12 +49,21 @@ void CANDriver::Init()
       Error_Handler();
   }
 
+  recovery_timer_ = osTimerNew(&CANDriver::RecoveryTimerCallback, osTimerOnce, this, &recovery_timer_attributes_);
+  if (recovery_timer_ == NULL)
+  {
+      Error_Handler();
+  }
+
   rx_task_handle_ = osThreadNew((osThreadFunc_t)&CANDriver::HandleReceive, this, &rx_task_attributes_);
   if (rx_task_handle_ == NULL)
   {
       Error_Handler();
   }
-  HAL_CAN_ActivateNotification(hcan_, CAN_IT_RX_FIFO0_MSG_PENDING);
+  HAL_CAN_ActivateNotification(hcan_, CAN_IT_RX_FIFO0_MSG_PENDING | CAN_IT_RX_FIFO0_OVERRUN |
+                                      CAN_IT_RX_FIFO1_MSG_PENDING | CAN_IT_RX_FIFO1_OVERRUN |
+                                      CAN_IT_TX_MAILBOX_EMPTY | CAN_IT_ERROR_WARNING |
+                                      CAN_IT_ERROR_PASSIVE | CAN_IT_BUSOFF | CAN_IT_ERROR);
   HAL_CAN_Start(hcan_);
 }
 
@@ -51,69 +74,988 @@ void CANDriver::HandleReceive()
 {
   while(1)
   {
-    osEventFlagsWait(can_rx_event_, 0x1, osFlagsWaitAny, osWaitForever);
-    CAN_RxHeaderTypeDef pHeader;
-    uint8_t aData[MAX_DATA_SIZE];
-
-    while(HAL_CAN_GetRxFifoFillLevel(hcan_, rx_fifo_num_))
+    // Wake up often enough to check freshness deadlines and roll the rate counters
+    uint32_t elapsed = osKernelGetTickCount() - last_stale_check_;
+    uint32_t timeout = elapsed < STALE_CHECK_TICKS ? STALE_CHECK_TICKS - elapsed : 0;
+    // and to deliver coalesced change notifications on time
+    uint32_t notify = subscriptions_.Poll(osKernelGetTickCount());
+    if(notify < timeout)
+      timeout = notify;
+    uint32_t flags = osEventFlagsWait(can_rx_event_, RX_FLAG | BUS_OFF_FLAG, osFlagsWaitAny, timeout);
+    if(!(flags & osFlagsError) && (flags & BUS_OFF_FLAG))
+      ArmRecovery();
+    // Drain the rings in batches, the ISR can keep adding frames behind us.
+    // Priority frames are handled first and again before every bulk frame.
+    while(rx_priority_ring_.Available() || rx_ring_.Available())
     {
-      HAL_CAN_GetRxMessage(hcan_, rx_fifo_num_, &pHeader, aData);
-      DataModules::DataModule* rx_module = (*modules_.find(pHeader.IDE == CAN_ID_STD ? pHeader.StdId : pHeader.ExtId)).second;
-      if(rx_module != nullptr)
+      AcquireTable();
+      DrainPriorityRing();
+      uint16_t count = rx_ring_.Available();
+      for (uint16_t i = 0; i < count; ++i)
       {
-        osMutexAcquire(rx_module->mutex_id_, osWaitForever);
-        rx_module->FromByteArray(aData);
-        osMutexRelease(rx_module->mutex_id_);
+        if(rx_priority_ring_.Available())
+          DrainPriorityRing();
+        DispatchFrame(rx_ring_.Peek(i));
       }
+      rx_ring_.Release(count);
+      ReleaseTable();
     }
-    HAL_CAN_ActivateNotification(hcan_, CAN_IT_RX_FIFO0_MSG_PENDING);
+    uint32_t now = osKernelGetTickCount();
+    AcquireTable();
+    CheckStaleness(now);
+    UpdateStats(now);
+    ReleaseTable();
+    CheckErrorState(now);
+  }
+}
+
+void CANDriver::DrainPriorityRing()
+{
+  uint16_t count;
+  while((count = rx_priority_ring_.Available()) != 0)
+  {
+    for (uint16_t i = 0; i < count; ++i)
+      DispatchFrame(rx_priority_ring_.Peek(i));
+    rx_priority_ring_.Release(count);
+  }
+}
+
+void CANDriver::DispatchFrame(const CANFrame& frame)
+{
+  ++rx_frame_count_;
+  rx_bits_ += FrameBits(frame);
+  CANRecorder* recorder = recorder_;
+  if(recorder != nullptr)
+    recorder->Record(frame, CANRecorder::Direction::Rx);
+  if(frame_hook_ && !frame_hook_(frame))
+    return;
+  // Remote frames carry no data, they are only ever requests for one of our modules
+  if(frame.is_rtr)
+  {
+    HandleRemoteFrame(frame);
+    return;
   }
+  CANDispatchTable::Entry* entry = rx_table_.load(std::memory_order_relaxed)->Find(frame.id, frame.is_ext);
+  if(entry == nullptr)
+  {
+    ++unknown_id_count_;
+    return;
+  }
+  ++entry->rx_count;
+  entry->last_tick = frame.tick;
+  DataModules::DataModule* rx_module = entry->module;
+  // Readers use DataModule::Read, the rx task never blocks on them
+  rx_module->Receive(const_cast<uint8_t*>(frame.data), frame.tick);
+  if(entry->subscription != CANSubscriptions::NONE)
+    subscriptions_.OnFrame(entry->subscription, frame, frame.tick);
+  if(rx_module->stale_)
+  {
+    rx_module->stale_ = false;
+    if(stale_callback_)
+      stale_callback_(*rx_module, false);
+  }
+}
+
+void CANDriver::HandleRemoteFrame(const CANFrame& frame)
+{
+  CANDispatchTable::Entry* entry = rtr_responders_.Find(frame.id, frame.is_ext);
+  if(entry == nullptr)
+  {
+    ++unknown_id_count_;
+    return;
+  }
+  ++entry->rx_count;
+  entry->last_tick = frame.tick;
+  // Answer with a data frame whatever the module's own RTR setting is. The rx task can't wait
+  // for a task that is writing the module, that request goes unanswered and the requester asks again.
+  CANFrame response;
+  if(!BuildFrame(entry->module, response, 0))
+  {
+    CountTxDrop();
+    return;
+  }
+  response.is_rtr = false;
+  SendFrame(response);
 }
 
-void CANDriver::Send(SolarGators::DataModules::DataModule* data)
+CANDriver::RegisterStatus CANDriver::AddRtrResponder(DataModules::DataModule* module, bool high_priority)
 {
-  //Spinlock until a tx mailbox is empty
-  while(!HAL_CAN_GetTxMailboxesFreeLevel(hcan_));
+  if(module->size_ > GetMaxPayload())
+    return RegisterStatus::TooLarge;
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  // Responders change rarely, so the table is edited in place with the rx task held off
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  RegisterStatus status = ToRegisterStatus(rtr_responders_.Insert(module));
+  __set_PRIMASK(primask);
+  if(status == RegisterStatus::Ok &&
+     !filter_planner_.AddId(module->can_id_, module->is_ext_id_, high_priority ? priority_fifo_num_ : rx_fifo_num_, true))
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+    rtr_responders_.Remove(module->can_id_, module->is_ext_id_);
+    __set_PRIMASK(primask);
+    status = RegisterStatus::FilterFull;
+  }
+  if(status == RegisterStatus::Ok && started_)
+    ConfigureFilters();
+  osMutexRelease(registry_mutex_);
+  return status;
+}
 
-  //Initialize Header
-  uint32_t pTxMailbox;
-  CAN_TxHeaderTypeDef pHeader;
-  pHeader.RTR = data->is_rtr_ ? CAN_RTR_REMOTE : CAN_RTR_DATA;
-  pHeader.DLC = data->size_;
-  if(data->is_ext_id_)
+CANDriver::RegisterStatus CANDriver::RemoveRtrResponder(uint32_t module_id, bool is_ext_id)
+{
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  bool removed = rtr_responders_.Remove(module_id, is_ext_id);
+  __set_PRIMASK(primask);
+  if(removed)
   {
-    pHeader.ExtId = data->can_id_;
-    pHeader.IDE = CAN_ID_EXT;
+    filter_planner_.RemoveId(module_id, is_ext_id, true);
+    if(started_)
+      ConfigureFilters();
   }
+  osMutexRelease(registry_mutex_);
+  return removed ? RegisterStatus::Ok : RegisterStatus::NotFound;
+}
+
+const CANDispatchTable::Entry* CANDriver::GetRtrResponderStats(uint32_t id, bool is_ext) const
+{
+  return rtr_responders_.Find(id, is_ext);
+}
+
+void CANDriver::CheckStaleness(uint32_t now)
+{
+  if(now - last_stale_check_ < STALE_CHECK_TICKS)
+    return;
+  last_stale_check_ = now;
+  rx_table_.load(std::memory_order_relaxed)->ForEach([&](CANDispatchTable::Entry& entry)
+  {
+    DataModules::DataModule* module = entry.module;
+    if(!module->stale_ && module->IsStale(now))
+    {
+      module->stale_ = true;
+      if(stale_callback_)
+        stale_callback_(*module, true);
+    }
+  });
+}
+
+void CANDriver::SetRecorder(CANRecorder* recorder)
+{
+  recorder_ = recorder;
+}
+
+void CANDriver::SetStaleCallback(std::function<void(DataModules::DataModule&, bool)> callback)
+{
+  stale_callback_ = callback;
+}
+
+CANDriver::TxStatus CANDriver::Send(SolarGators::DataModules::DataModule* data, bool urgent)
+{
+  CANFrame frame;
+  if(!BuildFrame(data, frame))
+  {
+    CountTxDrop();
+    return TxStatus::Dropped;
+  }
+  uint32_t now = osKernelGetTickCount();
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  TxPolicy* policy = FindTxPolicy(data);
+  if(policy != nullptr && !urgent && policy->primed && memcmp(frame.data, policy->last_data, data->size_) == 0 &&
+     (policy->heartbeat_ticks == 0 || now - policy->last_tick < policy->heartbeat_ticks))
+  {
+    ++policy->stats.suppressed;
+    __set_PRIMASK(primask);
+    return TxStatus::Suppressed;
+  }
+  __set_PRIMASK(primask);
+  TxStatus status = SendFrame(frame);
+  if(status != TxStatus::Queued || policy == nullptr)
+    return status;
+  // Only a queued frame counts as sent, a full queue leaves the next call free to try again.
+  // Look the policy up again in case it was removed while the frame was queued.
+  primask = __get_PRIMASK();
+  __disable_irq();
+  policy = FindTxPolicy(data);
+  if(policy != nullptr)
+  {
+    memcpy(policy->last_data, frame.data, data->size_);
+    policy->last_tick = now;
+    policy->primed = true;
+    ++policy->stats.sent;
+    if(urgent)
+      ++policy->stats.urgent;
+  }
+  __set_PRIMASK(primask);
+  return status;
+}
+
+bool CANDriver::SetTxPolicy(DataModules::DataModule* module, uint32_t heartbeat_ms)
+{
+  if(module->size_ > GetMaxPayload())
+    return false;
+  TxPolicy entry = {};
+  entry.module = module;
+  entry.heartbeat_ticks = (heartbeat_ms * osKernelGetTickFreq() + 999) / 1000;
+  bool set = true;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  TxPolicy* policy = FindTxPolicy(module);
+  if(policy != nullptr)
+    policy->heartbeat_ticks = entry.heartbeat_ticks;
+  else if(tx_policies_.full())
+    set = false;
   else
+    tx_policies_.push_back(entry);
+  __set_PRIMASK(primask);
+  return set;
+}
+
+bool CANDriver::RemoveTxPolicy(DataModules::DataModule* module)
+{
+  bool removed = false;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  TxPolicy* policy = FindTxPolicy(module);
+  if(policy != nullptr)
   {
-    pHeader.StdId = data->can_id_;
-    pHeader.IDE = CAN_ID_STD;
+    // Order doesn't matter, move the last one into the gap
+    *policy = tx_policies_.back();
+    tx_policies_.pop_back();
+    removed = true;
   }
-  //Put CAN message in tx mailbox
-  uint8_t aData[MAX_DATA_SIZE];
-  osMutexAcquire(data->mutex_id_, osWaitForever);
-  data->ToByteArray(aData);
+  __set_PRIMASK(primask);
+  return removed;
+}
+
+bool CANDriver::GetTxPolicyStats(DataModules::DataModule* module, TxPolicyStats& stats) const
+{
+  bool found = false;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  for (const TxPolicy& policy : tx_policies_)
+  {
+    if(policy.module == module)
+    {
+      stats = policy.stats;
+      found = true;
+      break;
+    }
+  }
+  __set_PRIMASK(primask);
+  return found;
+}
+
+CANDriver::TxPolicy* CANDriver::FindTxPolicy(const DataModules::DataModule* module)
+{
+  for (TxPolicy& policy : tx_policies_)
+  {
+    if(policy.module == module)
+      return &policy;
+  }
+  return nullptr;
+}
+
+bool CANDriver::BuildFrame(DataModules::DataModule* data, CANFrame& frame, uint32_t timeout)
+{
+  if(data->size_ > GetMaxPayload())
+    return false;
+  frame.id = data->can_id_;
+  frame.is_ext = data->is_ext_id_;
+  frame.is_rtr = data->is_rtr_;
+  frame.is_fd = data->size_ > 8 || data->is_brs_;
+  frame.brs = data->is_brs_;
+  frame.dlc = CANFrame::LengthToDlc(data->size_);
+  if(osMutexAcquire(data->mutex_id_, timeout) != osOK)
+    return false;
+  data->ToByteArray(frame.data);
   osMutexRelease(data->mutex_id_);
-  HAL_CAN_AddTxMessage(hcan_, &pHeader, aData, &pTxMailbox);
+  // FD lengths jump in steps, pad up to the next one
+  for (uint8_t i = data->size_; i < frame.Length(); ++i)
+    frame.data[i] = 0;
+  return true;
+}
+
+CANDriver::TxStatus CANDriver::SendFrame(const CANFrame& frame)
+{
+  if(frame.is_fd || frame.Length() > MAX_DATA_SIZE)
+  {
+    CountTxDrop();
+    return TxStatus::Dropped;
+  }
+  if(error_state_ == ErrorState::BusOff && bus_off_policy_.flush_tx)
+  {
+    CountTxDrop();
+    return TxStatus::Dropped;
+  }
+  TxStatus status = TxStatus::Queued;
+  TxEntry entry = {ArbitrationPriority(frame.id, frame.is_ext), 0, frame};
+  entry.frame.tick = osKernelGetTickCount();
+  // The tx interrupt pulls from the same queue, so keep it out while we touch it
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if(tx_queue_.full())
+  {
+    ++tx_drop_count_;
+    status = TxStatus::Full;
+  }
+  else
+  {
+    entry.sequence = tx_sequence_++;
+    tx_queue_.push(entry);
+    if(tx_queue_.size() > tx_queue_high_water_)
+      tx_queue_high_water_ = tx_queue_.size();
+  }
+  // Mailbox empty interrupts only fire when a transmission finishes, so an idle bus needs a kick
+  FillTxMailboxes();
+  __set_PRIMASK(primask);
+  CANRecorder* recorder = recorder_;
+  if(status == TxStatus::Queued && recorder != nullptr)
+    recorder->Record(entry.frame, CANRecorder::Direction::Tx);
+  return status;
+}
+
+void CANDriver::HandleTxInterrupt()
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  FillTxMailboxes();
+  __set_PRIMASK(primask);
+}
+
+void CANDriver::FillTxMailboxes()
+{
+  while(!tx_queue_.empty() && HAL_CAN_GetTxMailboxesFreeLevel(hcan_))
+  {
+    const CANFrame& frame = tx_queue_.top().frame;
+    //Initialize Header
+    uint32_t pTxMailbox;
+    CAN_TxHeaderTypeDef pHeader;
+    pHeader.RTR = frame.is_rtr ? CAN_RTR_REMOTE : CAN_RTR_DATA;
+    pHeader.DLC = frame.dlc;
+    pHeader.TransmitGlobalTime = DISABLE;
+    if(frame.is_ext)
+    {
+      pHeader.ExtId = frame.id;
+      pHeader.IDE = CAN_ID_EXT;
+    }
+    else
+    {
+      pHeader.StdId = frame.id;
+      pHeader.IDE = CAN_ID_STD;
+    }
+    //Put CAN message in tx mailbox
+    HAL_CAN_AddTxMessage(hcan_, &pHeader, const_cast<uint8_t*>(frame.data), &pTxMailbox);
+    uint32_t wait = osKernelGetTickCount() - frame.tick;
+    tx_wait_ticks_ += wait;
+    if(wait > tx_max_wait_ticks_)
+      tx_max_wait_ticks_ = wait;
+    tx_queue_.pop();
+    ++tx_frame_count_;
+    tx_bits_ = tx_bits_ + FrameBits(frame);
+  }
+}
+
+uint32_t CANDriver::ArbitrationPriority(uint32_t id, bool is_ext)
+{
+  // Base ID first, then a standard frame beats an extended frame with the same base ID,
+  // then the 18 bit ID extension
+  if(is_ext)
+    return ((id >> 18) & 0x7FF) << 19 | (1 << 18) | (id & 0x3FFFF);
+  return (id & 0x7FF) << 19;
+}
+
+void CANDriver::UpdateStats(uint32_t now)
+{
+  uint32_t elapsed = now - stats_window_start_;
+  if(elapsed < stats_window_ticks_)
+    return;
+  uint32_t tick_freq = osKernelGetTickFreq();
+  rx_table_.load(std::memory_order_relaxed)->ForEach([&](CANDispatchTable::Entry& entry)
+  {
+    entry.rate = (entry.rx_count - entry.window_count) * tick_freq / elapsed;
+    entry.window_count = entry.rx_count;
+  });
+  uint32_t tx_frames = tx_frame_count_;
+  rx_rate_ = (rx_frame_count_ - window_rx_frames_) * tick_freq / elapsed;
+  tx_rate_ = (tx_frames - window_tx_frames_) * tick_freq / elapsed;
+  window_rx_frames_ = rx_frame_count_;
+  window_tx_frames_ = tx_frames;
+  uint32_t bits = rx_bits_ + tx_bits_;
+  if(bit_rate_ != 0)
+  {
+    uint64_t load = static_cast<uint64_t>(bits - window_bits_) * tick_freq * 100 / (static_cast<uint64_t>(bit_rate_) * elapsed);
+    bus_load_ = load > 100 ? 100 : load;
+  }
+  window_bits_ = bits;
+  stats_window_start_ = now;
 }
 
-bool CANDriver::AddRxModule(DataModules::DataModule* module)
+uint32_t CANDriver::FrameBits(const CANFrame& frame)
 {
-  modules_.insert(etl::make_pair(module->can_id_, module));
-  // TODO: Check if successful insertion
+  // A remote frame carries a DLC but no data field
+  uint32_t len = frame.is_rtr ? 0 : frame.Length();
+  bool is_ext = frame.is_ext;
+  // Fixed fields are 47 bits for a standard frame and 67 for an extended one. Only the
+  // bits up to the CRC are stuffed, assume half the worst case of one stuff bit per four.
+  uint32_t stuffed = (is_ext ? 54 : 34) + 8 * len;
+  return (is_ext ? 67 : 47) + 8 * len + (stuffed - 1) / 8;
+}
+
+const CANDispatchTable::Entry* CANDriver::GetRxIdStats(uint32_t id, bool is_ext) const
+{
+  return modules_.load(std::memory_order_acquire)->Find(id, is_ext);
+}
+
+uint32_t CANDriver::GetRxFrameCount() const
+{
+  return rx_frame_count_;
+}
+
+uint32_t CANDriver::GetTxFrameCount() const
+{
+  return tx_frame_count_;
+}
+
+uint32_t CANDriver::GetUnknownIdCount() const
+{
+  return unknown_id_count_;
+}
+
+uint16_t CANDriver::GetRxRate() const
+{
+  return rx_rate_;
+}
+
+uint16_t CANDriver::GetTxRate() const
+{
+  return tx_rate_;
+}
+
+uint8_t CANDriver::GetMaxPayload() const
+{
+  return MAX_DATA_SIZE;
+}
+
+uint8_t CANDriver::GetBusLoad() const
+{
+  return bus_load_;
+}
+
+uint32_t CANDriver::GetRxStackFree() const
+{
+  // The RTOS keeps the high water mark by checking how much of the fill pattern is untouched
+  return rx_task_handle_ == nullptr ? RX_STACK_SIZE : osThreadGetStackSpace(rx_task_handle_);
+}
+
+uint8_t CANDriver::GetTransmitErrorCount() const
+{
+  return (hcan_->Instance->ESR & CAN_ESR_TEC) >> CAN_ESR_TEC_Pos;
+}
+
+uint8_t CANDriver::GetReceiveErrorCount() const
+{
+  return (hcan_->Instance->ESR & CAN_ESR_REC) >> CAN_ESR_REC_Pos;
+}
+
+uint16_t CANDriver::GetTxQueueDepth() const
+{
+  return tx_queue_.size();
+}
+
+uint16_t CANDriver::GetTxQueueHighWater() const
+{
+  return tx_queue_high_water_;
+}
+
+// Senders on any task and the bus-off handler all count drops. The M0 has no exclusive
+// load/store, so the increment is made atomic by holding interrupts off.
+void CANDriver::CountTxDrop()
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  ++tx_drop_count_;
+  __set_PRIMASK(primask);
+}
+
+uint32_t CANDriver::GetTxDropCount() const
+{
+  return tx_drop_count_;
+}
+
+uint32_t CANDriver::GetTxMailboxWaitTicks() const
+{
+  return tx_wait_ticks_;
+}
+
+uint32_t CANDriver::GetTxMaxMailboxWaitTicks() const
+{
+  return tx_max_wait_ticks_;
+}
+
+CANDriver::RegisterStatus CANDriver::AddRxModule(DataModules::DataModule* module, bool high_priority)
+{
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  CANDispatchTable* table = SpareTable();
+  if(table == nullptr)
+  {
+    osMutexRelease(registry_mutex_);
+    return RegisterStatus::Busy;
+  }
+  RegisterStatus status = ToRegisterStatus(table->Insert(module));
+  if(status == RegisterStatus::Ok &&
+     !filter_planner_.AddId(module->can_id_, module->is_ext_id_, high_priority ? priority_fifo_num_ : rx_fifo_num_))
+    status = RegisterStatus::FilterFull;
+  if(status == RegisterStatus::Ok)
+  {
+    PublishTable(table);
+    if(started_)
+      ConfigureFilters();
+  }
+  osMutexRelease(registry_mutex_);
+  return status;
+}
+
+CANDispatchTable* CANDriver::SpareTable()
+{
+  if(!ReclaimSpare(true))
+    return nullptr;
+  // Start from a copy of the live table. Counters the rx task bumps while the copy is
+  // being edited are lost, which only costs a little accuracy in the rate statistics.
+  CANDispatchTable* active = modules_.load(std::memory_order_relaxed);
+  CANDispatchTable* spare = active == &module_tables_[0] ? &module_tables_[1] : &module_tables_[0];
+  *spare = *active;
+  return spare;
+}
+
+bool CANDriver::ReclaimSpare(bool wait)
+{
+  // The spare is the table the last change replaced and the rx task may still be part way
+  // through a batch on it. The wait is bounded, the rx task can be blocked on a module mutex
+  // the caller holds, and on the rx task itself it would never let go.
+  CANDispatchTable* active = modules_.load(std::memory_order_relaxed);
+  CANDispatchTable* spare = active == &module_tables_[0] ? &module_tables_[1] : &module_tables_[0];
+  bool can_wait = wait && osThreadGetId() != rx_task_handle_;
+  uint32_t waited = 0;
+  while(rx_table_.load(std::memory_order_seq_cst) == spare)
+  {
+    if(!can_wait || waited++ >= TABLE_WAIT_TICKS)
+      return false;
+    osDelay(1);
+  }
+  // Nothing can reach the removed module's chain any more
+  if(retired_subscription_ != CANSubscriptions::NONE)
+  {
+    subscriptions_.RemoveAll(retired_subscription_);
+    retired_subscription_ = CANSubscriptions::NONE;
+  }
   return true;
 }
 
-bool CANDriver::RemoveRxModule(uint32_t module_id)
+void CANDriver::PublishTable(CANDispatchTable* table)
+{
+  // The old table becomes the next spare, SpareTable checks the rx task is done with it
+  // before it is written again
+  modules_.store(table, std::memory_order_seq_cst);
+}
+
+CANDispatchTable* CANDriver::AcquireTable()
+{
+  // Re-check after announcing the table, a swap in between would otherwise go unnoticed
+  CANDispatchTable* table;
+  do
+  {
+    table = modules_.load(std::memory_order_seq_cst);
+    rx_table_.store(table, std::memory_order_seq_cst);
+  } while(table != modules_.load(std::memory_order_seq_cst));
+  return table;
+}
+
+void CANDriver::ReleaseTable()
+{
+  rx_table_.store(nullptr, std::memory_order_release);
+}
+
+CANDriver::RegisterStatus CANDriver::ToRegisterStatus(CANDispatchTable::Result result)
+{
+  switch(result)
+  {
+    case CANDispatchTable::Result::Ok:
+      return RegisterStatus::Ok;
+    case CANDispatchTable::Result::Duplicate:
+      return RegisterStatus::Duplicate;
+    default:
+      return RegisterStatus::TableFull;
+  }
+}
+
+CANDriver::RegisterStatus CANDriver::AddRxId(uint32_t id, bool is_ext, bool high_priority)
 {
-  // TODO: Implement (Remove needs to be added to tree container)
-  return false;
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  bool added = filter_planner_.AddId(id, is_ext, high_priority ? priority_fifo_num_ : rx_fifo_num_);
+  if(added && started_)
+    ConfigureFilters();
+  osMutexRelease(registry_mutex_);
+  return added ? RegisterStatus::Ok : RegisterStatus::FilterFull;
+}
+
+CANDriver::RegisterStatus CANDriver::RemoveRxId(uint32_t id, bool is_ext)
+{
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  bool removed = filter_planner_.RemoveId(id, is_ext);
+  if(removed && started_)
+    ConfigureFilters();
+  osMutexRelease(registry_mutex_);
+  return removed ? RegisterStatus::Ok : RegisterStatus::NotFound;
+}
+
+void CANDriver::SetAcceptAll(bool accept_all)
+{
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  filter_planner_.SetAcceptAll(accept_all);
+  if(started_)
+    ConfigureFilters();
+  osMutexRelease(registry_mutex_);
+}
+
+bool CANDriver::SetFilterBanks(uint8_t first, uint8_t count)
+{
+  if(count == 0 || first + count > CANFilterPlanner::MAX_BANKS)
+    return false;
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  if(started_)
+  {
+    osMutexRelease(registry_mutex_);
+    return false;
+  }
+  first_filter_bank_ = first;
+  filter_planner_.SetBankLimit(count);
+  if(first == 0)
+    slave_start_filter_bank_ = count;
+  osMutexRelease(registry_mutex_);
+  return true;
+}
+
+void CANDriver::SetFrameHook(FrameHook hook)
+{
+  frame_hook_ = hook;
+}
+
+bool CANDriver::Subscribe(DataModules::DataModule* module, osThreadId_t thread, uint32_t flags,
+                          uint64_t signal_mask, uint32_t coalesce_ticks)
+{
+  return AddSubscription(module, {thread, nullptr, flags}, signal_mask, coalesce_ticks);
+}
+
+bool CANDriver::SubscribeEvent(DataModules::DataModule* module, osEventFlagsId_t event, uint32_t flags,
+                               uint64_t signal_mask, uint32_t coalesce_ticks)
+{
+  return AddSubscription(module, {nullptr, event, flags}, signal_mask, coalesce_ticks);
+}
+
+bool CANDriver::AddSubscription(DataModules::DataModule* module, const CANSubscriptions::Target& target,
+                                uint64_t signal_mask, uint32_t coalesce_ticks)
+{
+  // The rx task walks the chains without a lock, keep it out while one changes.
+  // Holding the registry mutex means the published table can't be swapped under us.
+  bool added = false;
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  // Frees a removed module's chain if the rx task is done with it, so it doesn't hold up the pool
+  ReclaimSpare(false);
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  CANDispatchTable::Entry* entry = modules_.load(std::memory_order_relaxed)->Find(module->can_id_, module->is_ext_id_);
+  if(entry != nullptr && entry->module == module)
+  {
+    uint8_t index = subscriptions_.Add(entry->subscription, target, signal_mask, coalesce_ticks);
+    if(index != CANSubscriptions::NONE)
+    {
+      entry->subscription = index;
+      added = true;
+    }
+  }
+  __set_PRIMASK(primask);
+  osMutexRelease(registry_mutex_);
+  return added;
+}
+
+bool CANDriver::Unsubscribe(DataModules::DataModule* module, const void* target)
+{
+  bool found = false;
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  CANDispatchTable::Entry* entry = modules_.load(std::memory_order_relaxed)->Find(module->can_id_, module->is_ext_id_);
+  if(entry != nullptr && entry->module == module)
+  {
+    entry->subscription = subscriptions_.Remove(entry->subscription, target);
+    found = true;
+  }
+  __set_PRIMASK(primask);
+  osMutexRelease(registry_mutex_);
+  return found;
+}
+
+CANDriver::RegisterStatus CANDriver::RemoveRxModule(uint32_t module_id, bool is_ext_id)
+{
+  osMutexAcquire(registry_mutex_, osWaitForever);
+  CANDispatchTable* table = SpareTable();
+  if(table == nullptr)
+  {
+    osMutexRelease(registry_mutex_);
+    return RegisterStatus::Busy;
+  }
+  const CANDispatchTable::Entry* entry = table->Find(module_id, is_ext_id);
+  uint8_t subscription = entry != nullptr ? entry->subscription : CANSubscriptions::NONE;
+  bool removed = table->Remove(module_id, is_ext_id);
+  if(removed)
+  {
+    PublishTable(table);
+    // The rx task can still be walking the chain from the old table
+    retired_subscription_ = subscription;
+    filter_planner_.RemoveId(module_id, is_ext_id);
+    if(started_)
+      ConfigureFilters();
+  }
+  osMutexRelease(registry_mutex_);
+  return removed ? RegisterStatus::Ok : RegisterStatus::NotFound;
+}
+
+void CANDriver::ConfigureFilters()
+{
+  // If the exact layout doesn't fit the planner falls back to passing everything
+  // and the dispatch table sorts it out in software
+  filter_planner_.Plan(rx_fifo_num_);
+  const auto& banks = filter_planner_.GetBanks();
+  uint8_t bank_count = banks.size();
+  for (uint8_t i = 0; i < bank_count; ++i)
+    ConfigureFilterBank(first_filter_bank_ + i, banks[i]);
+  // Turn off any banks left over from the previous layout
+  for (uint8_t i = bank_count; i < active_filter_banks_; ++i)
+  {
+    CAN_FilterTypeDef sFilterConfig = {};
+    sFilterConfig.FilterActivation = CAN_FILTER_DISABLE;
+    sFilterConfig.FilterBank = first_filter_bank_ + i;
+    sFilterConfig.SlaveStartFilterBank = slave_start_filter_bank_;
+    HAL_CAN_ConfigFilter(hcan_, &sFilterConfig);
+  }
+  active_filter_banks_ = bank_count;
+}
+
+void CANDriver::ConfigureFilterBank(uint32_t bank, const CANFilterBank& filter_bank)
+{
+  CAN_FilterTypeDef sFilterConfig = {};
+  sFilterConfig.FilterActivation = CAN_FILTER_ENABLE; /*Enable the filter*/
+  sFilterConfig.FilterBank = bank;
+  sFilterConfig.SlaveStartFilterBank = slave_start_filter_bank_;
+  sFilterConfig.FilterFIFOAssignment = filter_bank.fifo == CAN_RX_FIFO0 ? CAN_FILTER_FIFO0 : CAN_FILTER_FIFO1;
+  sFilterConfig.FilterMode = filter_bank.mode == CANFilterBank::Mode::IdList ? CAN_FILTERMODE_IDLIST : CAN_FILTERMODE_IDMASK;
+  if(filter_bank.scale == CANFilterBank::Scale::Bit32)
+  {
+    sFilterConfig.FilterScale = CAN_FILTERSCALE_32BIT;
+    sFilterConfig.FilterIdHigh = filter_bank.fr1 >> 16;
+    sFilterConfig.FilterIdLow = filter_bank.fr1 & 0xFFFF;
+    sFilterConfig.FilterMaskIdHigh = filter_bank.fr2 >> 16;
+    sFilterConfig.FilterMaskIdLow = filter_bank.fr2 & 0xFFFF;
+  }
+  else
+  {
+    // The HAL packs FR1 from the "Low" fields and FR2 from the "High" fields in 16 bit scale
+    sFilterConfig.FilterScale = CAN_FILTERSCALE_16BIT;
+    sFilterConfig.FilterIdLow = filter_bank.fr1 & 0xFFFF;
+    sFilterConfig.FilterMaskIdLow = filter_bank.fr1 >> 16;
+    sFilterConfig.FilterIdHigh = filter_bank.fr2 & 0xFFFF;
+    sFilterConfig.FilterMaskIdHigh = filter_bank.fr2 >> 16;
+  }
+  HAL_CAN_ConfigFilter(hcan_, &sFilterConfig);
 }
 
 void CANDriver::SetRxFlag()
 {
-  osEventFlagsSet(can_rx_event_, 0x1);
+  DrainFifo(priority_fifo_num_, rx_priority_ring_);
+  DrainFifo(rx_fifo_num_, rx_ring_);
+  osEventFlagsSet(can_rx_event_, RX_FLAG);
+}
+
+template <uint16_t SIZE>
+void CANDriver::DrainFifo(uint32_t fifo, CANFrameRing<SIZE>& ring)
+{
+  CAN_RxHeaderTypeDef pHeader;
+  while(HAL_CAN_GetRxFifoFillLevel(hcan_, fifo))
+  {
+    CANFrame* frame = ring.Claim();
+    if(frame == nullptr)
+    {
+      // Ring is full, the frame still has to leave the hardware fifo or the interrupt keeps firing
+      uint8_t aData[MAX_DATA_SIZE];
+      if(HAL_CAN_GetRxMessage(hcan_, fifo, &pHeader, aData) != HAL_OK)
+        break;
+      continue;
+    }
+    // A failed read leaves the claimed slot unused, whatever is still in the fifo raises the
+    // interrupt again
+    if(HAL_CAN_GetRxMessage(hcan_, fifo, &pHeader, frame->data) != HAL_OK)
+      break;
+    frame->is_ext = pHeader.IDE == CAN_ID_EXT;
+    frame->id = frame->is_ext ? pHeader.ExtId : pHeader.StdId;
+    frame->is_rtr = pHeader.RTR == CAN_RTR_REMOTE;
+    // Classic CAN allows DLC 9-15 on the wire and still carries 8 bytes, they must not read as FD lengths
+    frame->dlc = pHeader.DLC > MAX_DATA_SIZE ? MAX_DATA_SIZE : pHeader.DLC;
+    frame->is_fd = false;
+    frame->brs = false;
+    frame->tick = osKernelGetTickCount();
+    ring.Commit();
+  }
+}
+
+void CANDriver::HandleErrorInterrupt()
+{
+  uint32_t error = HAL_CAN_GetError(hcan_);
+  if(error & HAL_CAN_ERROR_RX_FOV0)
+    rx_fifo_overruns_[CAN_RX_FIFO0] = rx_fifo_overruns_[CAN_RX_FIFO0] + 1;
+  if(error & HAL_CAN_ERROR_RX_FOV1)
+    rx_fifo_overruns_[CAN_RX_FIFO1] = rx_fifo_overruns_[CAN_RX_FIFO1] + 1;
+  if(error & (HAL_CAN_ERROR_EWG | HAL_CAN_ERROR_EPV | HAL_CAN_ERROR_BOF))
+  {
+    ErrorState state = ReadErrorState();
+    UpdateErrorState(state);
+    if(state == ErrorState::BusOff)
+      HandleBusOff();
+  }
+  HAL_CAN_ResetError(hcan_);
+}
+
+CANDriver::ErrorState CANDriver::ReadErrorState() const
+{
+  uint32_t esr = hcan_->Instance->ESR;
+  if(esr & CAN_ESR_BOFF)
+    return ErrorState::BusOff;
+  if(esr & CAN_ESR_EPVF)
+    return ErrorState::Passive;
+  if(esr & CAN_ESR_EWGF)
+    return ErrorState::Warning;
+  return ErrorState::Active;
+}
+
+void CANDriver::UpdateErrorState(ErrorState state)
+{
+  // Called from both the error interrupt and the rx task
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if(state != error_state_)
+  {
+    ErrorTransition& transition = error_history_[error_history_next_];
+    transition.tick = osKernelGetTickCount();
+    transition.from = error_state_;
+    transition.to = state;
+    transition.tec = GetTransmitErrorCount();
+    transition.rec = GetReceiveErrorCount();
+    error_history_next_ = (error_history_next_ + 1) % ERROR_HISTORY_SIZE;
+    if(error_history_count_ < ERROR_HISTORY_SIZE)
+      ++error_history_count_;
+    ++error_state_counts_[static_cast<uint8_t>(state)];
+    error_state_ = state;
+  }
+  __set_PRIMASK(primask);
+}
+
+void CANDriver::CheckErrorState(uint32_t now)
+{
+  // Only entering the error states raises an interrupt, leaving them is picked up here
+  ErrorState state = ReadErrorState();
+  UpdateErrorState(state);
+  if(state == ErrorState::BusOff)
+  {
+    // A recovery attempt that didn't stick raises no new interrupt, so keep retrying from here
+    ArmRecovery();
+  }
+  else if(state == ErrorState::Active && error_history_count_ != 0)
+  {
+    uint32_t since = now - error_history_[(error_history_next_ + ERROR_HISTORY_SIZE - 1) % ERROR_HISTORY_SIZE].tick;
+    if(since * 1000 / osKernelGetTickFreq() >= bus_off_policy_.backoff_max_ms)
+      backoff_ms_ = bus_off_policy_.backoff_min_ms;
+  }
+}
+
+void CANDriver::ArmRecovery()
+{
+  if(!osTimerIsRunning(recovery_timer_))
+    osTimerStart(recovery_timer_, (backoff_ms_ * osKernelGetTickFreq() + 999) / 1000);
+}
+
+void CANDriver::HandleBusOff()
+{
+  if(bus_off_policy_.flush_tx)
+  {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    tx_drop_count_ += tx_queue_.size();
+    tx_queue_.clear();
+    HAL_CAN_AbortTxRequest(hcan_, CAN_TX_MAILBOX0 | CAN_TX_MAILBOX1 | CAN_TX_MAILBOX2);
+    __set_PRIMASK(primask);
+  }
+  // Timers can't be started from an interrupt, the rx task arms the recovery
+  osEventFlagsSet(can_rx_event_, BUS_OFF_FLAG);
+}
+
+void CANDriver::RecoveryTimerCallback(void* arg)
+{
+  static_cast<CANDriver*>(arg)->Recover();
+}
+
+void CANDriver::Recover()
+{
+  // Dropping into initialisation mode and back restarts the bus-off recovery sequence,
+  // the node rejoins after 128 x 11 recessive bits. Filters and interrupts are kept.
+  backoff_ms_ = backoff_ms_ * 2 > bus_off_policy_.backoff_max_ms ? bus_off_policy_.backoff_max_ms : backoff_ms_ * 2;
+  HAL_CAN_Stop(hcan_);
+  HAL_CAN_Start(hcan_);
+  HandleTxInterrupt();
+}
+
+void CANDriver::SetBusOffPolicy(const BusOffPolicy& policy)
+{
+  bus_off_policy_ = policy;
+  backoff_ms_ = policy.backoff_min_ms;
+}
+
+CANDriver::ErrorState CANDriver::GetErrorState() const
+{
+  return error_state_;
+}
+
+uint32_t CANDriver::GetErrorStateCount(ErrorState state) const
+{
+  return error_state_counts_[static_cast<uint8_t>(state)];
+}
+
+uint8_t CANDriver::GetErrorHistory(ErrorTransition* history, uint8_t max) const
+{
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  uint8_t count = max < error_history_count_ ? max : error_history_count_;
+  for (uint8_t i = 0; i < count; ++i)
+    history[i] = error_history_[(error_history_next_ + ERROR_HISTORY_SIZE - 1 - i) % ERROR_HISTORY_SIZE];
+  __set_PRIMASK(primask);
+  return count;
+}
+
+uint32_t CANDriver::GetRxOverflowCount(uint32_t fifo) const
+{
+  return fifo == priority_fifo_num_ ? rx_priority_ring_.GetOverflowCount() : rx_ring_.GetOverflowCount();
+}
+
+uint16_t CANDriver::GetRxHighWater(uint32_t fifo) const
+{
+  return fifo == priority_fifo_num_ ? rx_priority_ring_.GetHighWater() : rx_ring_.GetHighWater();
+}
+
+uint32_t CANDriver::GetRxFifoOverrunCount(uint32_t fifo) const
+{
+  return rx_fifo_overruns_[fifo & 1];
 }
 
 } /* namespace Drivers */
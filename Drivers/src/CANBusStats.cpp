@@ -0,0 +1,63 @@
+/*
+ * CANBusStats.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANBusStats.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANBusStats::CANBusStats(CANDriver* driver, uint32_t can_id, uint16_t telem_id):
+    DataModule(can_id, telem_id, Size), driver_(driver)
+{ }
+
+CANBusStats::~CANBusStats()
+{ }
+
+void CANBusStats::ToByteArray(uint8_t* buff) const
+{
+  uint32_t overruns = driver_->GetRxFifoOverrunCount(CAN_RX_FIFO0) + driver_->GetRxFifoOverrunCount(CAN_RX_FIFO1);
+  uint32_t overflows = driver_->GetRxOverflowCount(CAN_RX_FIFO0) + driver_->GetRxOverflowCount(CAN_RX_FIFO1);
+  uint16_t rx_rate = driver_->GetRxRate();
+  uint16_t tx_rate = driver_->GetTxRate();
+  uint16_t unknown = Saturate16(driver_->GetUnknownIdCount());
+  uint16_t ring_overflows = Saturate16(overflows);
+  uint16_t tx_drops = Saturate16(driver_->GetTxDropCount());
+  uint16_t max_wait = Saturate16(driver_->GetTxMaxMailboxWaitTicks());
+
+  buff[0]  = driver_->GetBusLoad();
+  buff[1]  = driver_->GetTransmitErrorCount();
+  buff[2]  = driver_->GetReceiveErrorCount();
+  buff[3]  = Saturate8(overruns);
+  buff[4]  = rx_rate & 0xFF;
+  buff[5]  = rx_rate >> 8;
+  buff[6]  = tx_rate & 0xFF;
+  buff[7]  = tx_rate >> 8;
+  buff[8]  = unknown & 0xFF;
+  buff[9]  = unknown >> 8;
+  buff[10] = ring_overflows & 0xFF;
+  buff[11] = ring_overflows >> 8;
+  buff[12] = tx_drops & 0xFF;
+  buff[13] = tx_drops >> 8;
+  buff[14] = max_wait & 0xFF;
+  buff[15] = max_wait >> 8;
+}
+
+void CANBusStats::FromByteArray(uint8_t*)
+{ }
+
+uint8_t CANBusStats::Saturate8(uint32_t value)
+{
+  return value > 0xFF ? 0xFF : value;
+}
+
+uint16_t CANBusStats::Saturate16(uint32_t value)
+{
+  return value > 0xFFFF ? 0xFFFF : value;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -0,0 +1,128 @@
+/*
+ * CANDispatch.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANDispatch.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANDispatchTable::CANDispatchTable()
+{
+  Clear();
+}
+
+CANDispatchTable::~CANDispatchTable()
+{ }
+
+CANDispatchTable::Result CANDispatchTable::Insert(DataModules::DataModule* module)
+{
+  uint32_t key = MakeKey(module->can_id_, module->is_ext_id_);
+  uint8_t i = Hash(key);
+  while(slot_entry_[i] != EMPTY)
+  {
+    if(keys_[i] == key)
+      return Result::Duplicate;
+    i = (i + 1) & (SLOT_COUNT - 1);
+  }
+  if(size_ >= MAX_MODULES)
+    return Result::Full;
+  keys_[i] = key;
+  slot_entry_[i] = size_;
+  entries_[size_] = {module, 0, 0, 0, 0, CANSubscriptions::NONE};
+  ++size_;
+  return Result::Ok;
+}
+
+bool CANDispatchTable::Remove(uint32_t id, bool is_ext)
+{
+  uint8_t i = FindSlot(MakeKey(id, is_ext));
+  if(i == EMPTY)
+    return false;
+  uint8_t removed = slot_entry_[i];
+  // Backward shift deletion, pull later entries of the probe chain into the hole
+  // so lookups never need tombstones
+  uint8_t hole = i;
+  uint8_t j = i;
+  while(true)
+  {
+    j = (j + 1) & (SLOT_COUNT - 1);
+    if(slot_entry_[j] == EMPTY)
+      break;
+    uint8_t home = Hash(keys_[j]);
+    // Entry j can move into the hole only if its home slot is not between the hole and j
+    if(((j - home) & (SLOT_COUNT - 1)) >= ((j - hole) & (SLOT_COUNT - 1)))
+    {
+      keys_[hole] = keys_[j];
+      slot_entry_[hole] = slot_entry_[j];
+      hole = j;
+    }
+  }
+  slot_entry_[hole] = EMPTY;
+  keys_[hole] = 0;
+  // Keep the entries dense by moving the last one into the gap
+  --size_;
+  if(removed != size_)
+  {
+    entries_[removed] = entries_[size_];
+    const DataModules::DataModule* moved = entries_[removed].module;
+    slot_entry_[FindSlot(MakeKey(moved->can_id_, moved->is_ext_id_))] = removed;
+  }
+  return true;
+}
+
+CANDispatchTable::Entry* CANDispatchTable::Find(uint32_t id, bool is_ext)
+{
+  uint8_t i = FindSlot(MakeKey(id, is_ext));
+  return i == EMPTY ? nullptr : &entries_[slot_entry_[i]];
+}
+
+const CANDispatchTable::Entry* CANDispatchTable::Find(uint32_t id, bool is_ext) const
+{
+  uint8_t i = FindSlot(MakeKey(id, is_ext));
+  return i == EMPTY ? nullptr : &entries_[slot_entry_[i]];
+}
+
+uint8_t CANDispatchTable::Size() const
+{
+  return size_;
+}
+
+void CANDispatchTable::Clear()
+{
+  for (uint8_t i = 0; i < SLOT_COUNT; ++i)
+  {
+    keys_[i] = 0;
+    slot_entry_[i] = EMPTY;
+  }
+  size_ = 0;
+}
+
+uint8_t CANDispatchTable::FindSlot(uint32_t key) const
+{
+  uint8_t i = Hash(key);
+  while(slot_entry_[i] != EMPTY)
+  {
+    if(keys_[i] == key)
+      return i;
+    i = (i + 1) & (SLOT_COUNT - 1);
+  }
+  return EMPTY;
+}
+
+inline uint32_t CANDispatchTable::MakeKey(uint32_t id, bool is_ext)
+{
+  return (id & ID_MASK) | (is_ext ? EXT_FLAG : 0);
+}
+
+inline uint8_t CANDispatchTable::Hash(uint32_t key)
+{
+  // Fibonacci hashing, the top bits of the product mix every bit of the ID
+  return (key * 2654435769u) >> (32 - SLOT_BITS);
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
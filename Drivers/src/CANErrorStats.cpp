@@ -0,0 +1,51 @@
+/*
+ * CANErrorStats.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANErrorStats.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANErrorStats::CANErrorStats(CANDriver* driver, uint32_t can_id, uint16_t telem_id):
+    DataModule(can_id, telem_id, Size), driver_(driver)
+{ }
+
+CANErrorStats::~CANErrorStats()
+{ }
+
+void CANErrorStats::ToByteArray(uint8_t* buff) const
+{
+  CANDriver::ErrorTransition last;
+  uint16_t since = 0xFFFF;
+  uint8_t previous = static_cast<uint8_t>(driver_->GetErrorState());
+  if(driver_->GetErrorHistory(&last, 1) != 0)
+  {
+    uint32_t seconds = (osKernelGetTickCount() - last.tick) / osKernelGetTickFreq();
+    since = seconds > 0xFFFE ? 0xFFFE : seconds;
+    previous = static_cast<uint8_t>(last.from);
+  }
+
+  buff[0] = static_cast<uint8_t>(driver_->GetErrorState()) | previous << 2;
+  buff[1] = driver_->GetTransmitErrorCount();
+  buff[2] = driver_->GetReceiveErrorCount();
+  buff[3] = Saturate8(driver_->GetErrorStateCount(CANDriver::ErrorState::Warning));
+  buff[4] = Saturate8(driver_->GetErrorStateCount(CANDriver::ErrorState::Passive));
+  buff[5] = Saturate8(driver_->GetErrorStateCount(CANDriver::ErrorState::BusOff));
+  buff[6] = since & 0xFF;
+  buff[7] = since >> 8;
+}
+
+void CANErrorStats::FromByteArray(uint8_t*)
+{ }
+
+uint8_t CANErrorStats::Saturate8(uint32_t value)
+{
+  return value > 0xFF ? 0xFF : value;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -0,0 +1,263 @@
+/*
+ * CANFilter.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANFilter.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANFilterPlanner::CANFilterPlanner():bank_limit_(DEFAULT_BANKS),accept_all_(false)
+{ }
+
+CANFilterPlanner::~CANFilterPlanner()
+{ }
+
+bool CANFilterPlanner::AddId(uint32_t id, bool is_ext, uint8_t fifo, bool is_rtr)
+{
+  for (CANFilterId& filter_id : ids_)
+  {
+    if(filter_id.id == id && filter_id.is_ext == is_ext && filter_id.is_rtr == is_rtr)
+    {
+      filter_id.fifo = fifo;
+      return true;
+    }
+  }
+  if(ids_.full())
+    return false;
+  ids_.push_back({id, is_ext, is_rtr, fifo});
+  return true;
+}
+
+bool CANFilterPlanner::RemoveId(uint32_t id, bool is_ext, bool is_rtr)
+{
+  for (auto it = ids_.begin(); it != ids_.end(); ++it)
+  {
+    if(it->id == id && it->is_ext == is_ext && it->is_rtr == is_rtr)
+    {
+      ids_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+void CANFilterPlanner::Clear()
+{
+  ids_.clear();
+  banks_.clear();
+}
+
+bool CANFilterPlanner::Plan(uint8_t bulk_fifo)
+{
+  banks_.clear();
+  if(accept_all_)
+  {
+    PlanFallback(bulk_fifo);
+    return true;
+  }
+  if(PlanFifo(0) && PlanFifo(1))
+    return true;
+  PlanFallback(bulk_fifo);
+  return false;
+}
+
+void CANFilterPlanner::SetAcceptAll(bool accept_all)
+{
+  accept_all_ = accept_all;
+}
+
+bool CANFilterPlanner::PlanFifo(uint8_t fifo)
+{
+  GroupList std_groups;
+  GroupList ext_groups;
+  for (const CANFilterId& filter_id : ids_)
+  {
+    if(filter_id.fifo != fifo)
+      continue;
+    if(filter_id.is_ext)
+      ext_groups.push_back({filter_id.id & EXT_MASK, 0, filter_id.is_rtr});
+    else
+      std_groups.push_back({filter_id.id & STD_MASK, 0, filter_id.is_rtr});
+  }
+  Merge(std_groups);
+  Merge(ext_groups);
+  return PlanStandard(std_groups, fifo) && PlanExtended(ext_groups, fifo);
+}
+
+void CANFilterPlanner::PlanFallback(uint8_t bulk_fifo)
+{
+  // A frame matching several filters takes the 32 bit, list mode one first, so priority IDs
+  // in 32 bit list banks still win over the accept everything mask bank that feeds the bulk fifo
+  uint8_t priority_fifo = bulk_fifo ^ 1;
+  banks_.clear();
+  etl::vector<uint32_t, MAX_IDS> list;
+  for (const CANFilterId& filter_id : ids_)
+  {
+    if(filter_id.fifo == priority_fifo)
+    {
+      uint32_t rtr = filter_id.is_rtr ? RTR_32 : 0;
+      list.push_back(filter_id.is_ext ? Ext32(filter_id.id, filter_id.is_rtr) : ((filter_id.id & STD_MASK) << 21) | rtr);
+    }
+  }
+  for (size_t i = 0; i < list.size(); i += 2)
+  {
+    uint32_t e0 = list[i];
+    uint32_t e1 = i + 1 < list.size() ? list[i + 1] : e0;
+    if(banks_.size() + 1 >= bank_limit_)
+    {
+      // Not even the priority IDs fit, everything goes to the bulk fifo
+      banks_.clear();
+      break;
+    }
+    AddBank(CANFilterBank::Mode::IdList, CANFilterBank::Scale::Bit32, priority_fifo, e0, e1);
+  }
+  AddBank(CANFilterBank::Mode::IdMask, CANFilterBank::Scale::Bit32, bulk_fifo, 0, 0);
+}
+
+const etl::vector<CANFilterBank, CANFilterPlanner::MAX_BANKS>& CANFilterPlanner::GetBanks() const
+{
+  return banks_;
+}
+
+void CANFilterPlanner::SetBankLimit(uint8_t limit)
+{
+  bank_limit_ = limit == 0 ? 1 : (limit > MAX_BANKS ? MAX_BANKS : limit);
+}
+
+uint8_t CANFilterPlanner::GetBankLimit() const
+{
+  return bank_limit_;
+}
+
+void CANFilterPlanner::Merge(GroupList& groups)
+{
+  // Two groups with the same don't care bits that differ in exactly one other bit
+  // cover exactly the union of their IDs, so keep merging until nothing changes.
+  // Data and remote frame groups never merge, they are different bits in the filter.
+  // Groups stay disjoint so no extra IDs are ever accepted.
+  bool merged = true;
+  while(merged)
+  {
+    merged = false;
+    for (uint8_t i = 0; i < groups.size() && !merged; ++i)
+    {
+      for (uint8_t j = i + 1; j < groups.size(); ++j)
+      {
+        if(groups[i].dont_care != groups[j].dont_care || groups[i].rtr != groups[j].rtr)
+          continue;
+        uint32_t diff = groups[i].value ^ groups[j].value;
+        if(diff & (diff - 1))
+          continue;
+        groups[i].value &= ~diff;
+        groups[i].dont_care |= diff;
+        groups.erase(groups.begin() + j);
+        merged = true;
+        break;
+      }
+    }
+  }
+}
+
+bool CANFilterPlanner::PlanStandard(GroupList& groups, uint8_t fifo)
+{
+  etl::vector<uint32_t, MAX_IDS> list;
+  etl::vector<uint32_t, MAX_IDS> masks;
+  for (const Group& group : groups)
+  {
+    if((1u << __builtin_popcount(group.dont_care)) >= MIN_MASK_GROUP)
+    {
+      // [31:16] mask, [15:0] id. IDE and RTR must match, EXID[17:15] are don't care
+      uint32_t mask = Std16(~group.dont_care & STD_MASK) | IDE_16 | RTR_16;
+      masks.push_back((mask << 16) | Std16(group.value, group.rtr));
+    }
+    else
+    {
+      // Too small to be worth a mask slot, expand back into single IDs
+      uint32_t subset = group.dont_care;
+      do
+      {
+        list.push_back(Std16(group.value | subset, group.rtr));
+        subset = (subset - 1) & group.dont_care;
+      } while(subset != group.dont_care);
+    }
+  }
+  // Four IDs per 16 bit list bank, unused slots repeat the last ID
+  for (size_t i = 0; i < list.size(); i += 4)
+  {
+    uint32_t e0 = list[i];
+    uint32_t e1 = i + 1 < list.size() ? list[i + 1] : e0;
+    uint32_t e2 = i + 2 < list.size() ? list[i + 2] : e1;
+    uint32_t e3 = i + 3 < list.size() ? list[i + 3] : e2;
+    if(!AddBank(CANFilterBank::Mode::IdList, CANFilterBank::Scale::Bit16, fifo, (e1 << 16) | e0, (e3 << 16) | e2))
+      return false;
+  }
+  // Two id/mask pairs per 16 bit mask bank
+  for (size_t i = 0; i < masks.size(); i += 2)
+  {
+    uint32_t f0 = masks[i];
+    uint32_t f1 = i + 1 < masks.size() ? masks[i + 1] : f0;
+    if(!AddBank(CANFilterBank::Mode::IdMask, CANFilterBank::Scale::Bit16, fifo, f0, f1))
+      return false;
+  }
+  return true;
+}
+
+bool CANFilterPlanner::PlanExtended(GroupList& groups, uint8_t fifo)
+{
+  etl::vector<uint32_t, MAX_IDS> list;
+  for (const Group& group : groups)
+  {
+    if((1u << __builtin_popcount(group.dont_care)) >= MIN_MASK_GROUP)
+    {
+      // One id/mask pair per 32 bit mask bank. IDE and RTR must match
+      uint32_t mask = Ext32(~group.dont_care & EXT_MASK) | RTR_32;
+      if(!AddBank(CANFilterBank::Mode::IdMask, CANFilterBank::Scale::Bit32, fifo, Ext32(group.value, group.rtr), mask))
+        return false;
+    }
+    else
+    {
+      uint32_t subset = group.dont_care;
+      do
+      {
+        list.push_back(Ext32(group.value | subset, group.rtr));
+        subset = (subset - 1) & group.dont_care;
+      } while(subset != group.dont_care);
+    }
+  }
+  // Two IDs per 32 bit list bank
+  for (size_t i = 0; i < list.size(); i += 2)
+  {
+    uint32_t e0 = list[i];
+    uint32_t e1 = i + 1 < list.size() ? list[i + 1] : e0;
+    if(!AddBank(CANFilterBank::Mode::IdList, CANFilterBank::Scale::Bit32, fifo, e0, e1))
+      return false;
+  }
+  return true;
+}
+
+bool CANFilterPlanner::AddBank(CANFilterBank::Mode mode, CANFilterBank::Scale scale, uint8_t fifo, uint32_t fr1, uint32_t fr2)
+{
+  if(banks_.size() >= bank_limit_)
+    return false;
+  banks_.push_back({mode, scale, fifo, fr1, fr2});
+  return true;
+}
+
+inline uint32_t CANFilterPlanner::Std16(uint32_t id, bool rtr)
+{
+  // STID[10:0] lives in bits [15:5] of a 16 bit filter, RTR in bit 4
+  return ((id & STD_MASK) << 5) | (rtr ? RTR_16 : 0);
+}
+
+inline uint32_t CANFilterPlanner::Ext32(uint32_t id, bool rtr)
+{
+  // STID[10:0] in [31:21] and EXID[17:0] in [20:3], which is just the 29 bit ID shifted
+  return ((id & EXT_MASK) << 3) | IDE_32 | (rtr ? RTR_32 : 0);
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -0,0 +1,195 @@
+/*
+ * CANGateway.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANGateway.hpp>
+#include "etl/algorithm.h"
+
+namespace SolarGators {
+namespace Drivers {
+
+CANGateway::CANGateway(CANDriver* port_a, CANDriver* port_b):default_action_(Action::Drop),compiled_(false)
+{
+  tables_[0].in = port_a;
+  tables_[0].out = port_b;
+  tables_[1].in = port_b;
+  tables_[1].out = port_a;
+  for (Table& table : tables_)
+  {
+    table.unrouted = 0;
+    table.max_latency = 0;
+  }
+}
+
+CANGateway::~CANGateway()
+{ }
+
+bool CANGateway::AddRoute(Port from, const Route& route)
+{
+  if(compiled_)
+    return false;
+  Table& table = tables_[static_cast<uint8_t>(from)];
+  CompiledRoute compiled = {route, 0, false, {}};
+  compiled.route.id &= route.is_ext ? ID_EXACT : 0x7FF;
+  bool exact = (route.mask & (route.is_ext ? ID_EXACT : 0x7FF)) == (route.is_ext ? ID_EXACT : 0x7FF);
+  auto& list = exact ? table.exact : table.masked;
+  if(list.full())
+    return false;
+  list.push_back(compiled);
+  return true;
+}
+
+bool CANGateway::Compile(Action default_action)
+{
+  default_action_ = default_action;
+  bool filtered = true;
+  for (uint8_t i = 0; i < 2; ++i)
+  {
+    Table& table = tables_[i];
+    filtered = CompileTable(table) && filtered;
+    table.in->SetFrameHook([this, &table](const CANFrame& frame) { return HandleFrame(table, frame); });
+  }
+  compiled_ = true;
+  return filtered;
+}
+
+bool CANGateway::CompileTable(Table& table)
+{
+  etl::sort(table.exact.begin(), table.exact.end(), [](const CompiledRoute& a, const CompiledRoute& b)
+  {
+    return Key(a.route.id, a.route.is_ext) < Key(b.route.id, b.route.is_ext);
+  });
+  // The filters only need to pass what is routed, unless masked routes or a
+  // default forward mean frames we can't list have to come through too
+  if(!table.masked.empty() || default_action_ == Action::Forward)
+  {
+    table.in->SetAcceptAll(true);
+    return true;
+  }
+  bool filtered = true;
+  for (const CompiledRoute& compiled : table.exact)
+  {
+    if((compiled.route.action == Action::Forward || compiled.route.local) &&
+       table.in->AddRxId(compiled.route.id, compiled.route.is_ext) != CANDriver::RegisterStatus::Ok)
+      filtered = false;
+  }
+  return filtered;
+}
+
+bool CANGateway::HandleFrame(Table& table, const CANFrame& frame)
+{
+  CompiledRoute* compiled = FindExact(table, Key(frame.id, frame.is_ext));
+  if(compiled == nullptr)
+  {
+    for (CompiledRoute& masked : table.masked)
+    {
+      if(masked.route.is_ext == frame.is_ext && ((frame.id ^ masked.route.id) & masked.route.mask) == 0)
+      {
+        compiled = &masked;
+        break;
+      }
+    }
+  }
+  if(compiled == nullptr)
+  {
+    ++table.unrouted;
+    if(default_action_ == Action::Forward)
+      Forward(table, nullptr, frame);
+    return true;
+  }
+  if(compiled->route.action == Action::Drop)
+    ++compiled->stats.dropped;
+  else
+    Forward(table, compiled, frame);
+  return compiled->route.local;
+}
+
+void CANGateway::Forward(Table& table, CompiledRoute* compiled, const CANFrame& frame)
+{
+  uint32_t now = osKernelGetTickCount();
+  CANFrame out = frame;
+  if(compiled != nullptr)
+  {
+    const Route& route = compiled->route;
+    if(route.min_interval != 0 && compiled->forwarded_once && now - compiled->last_forward < route.min_interval)
+    {
+      ++compiled->stats.rate_limited;
+      return;
+    }
+    if(route.remap_id != KEEP_ID)
+    {
+      out.id = route.remap_id & (route.remap_ext ? ID_EXACT : 0x7FF);
+      out.is_ext = route.remap_ext;
+    }
+  }
+  if(table.out->SendFrame(out) != CANDriver::TxStatus::Queued)
+  {
+    if(compiled != nullptr)
+      ++compiled->stats.tx_full;
+    return;
+  }
+  uint32_t latency = now - frame.tick;
+  if(latency > table.max_latency)
+    table.max_latency = latency;
+  if(compiled != nullptr)
+  {
+    compiled->last_forward = now;
+    compiled->forwarded_once = true;
+    ++compiled->stats.forwarded;
+  }
+}
+
+CANGateway::CompiledRoute* CANGateway::FindExact(Table& table, uint32_t key)
+{
+  uint8_t low = 0;
+  uint8_t high = table.exact.size();
+  while(low < high)
+  {
+    uint8_t mid = (low + high) / 2;
+    uint32_t mid_key = Key(table.exact[mid].route.id, table.exact[mid].route.is_ext);
+    if(mid_key == key)
+      return &table.exact[mid];
+    if(mid_key < key)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return nullptr;
+}
+
+const CANGateway::RouteStats* CANGateway::GetRouteStats(Port from, uint32_t id, bool is_ext) const
+{
+  Table& table = const_cast<Table&>(tables_[static_cast<uint8_t>(from)]);
+  CompiledRoute* compiled = FindExact(table, Key(id, is_ext));
+  if(compiled == nullptr)
+  {
+    for (CompiledRoute& masked : table.masked)
+    {
+      if(masked.route.is_ext == is_ext && masked.route.id == id)
+        return &masked.stats;
+    }
+    return nullptr;
+  }
+  return &compiled->stats;
+}
+
+uint32_t CANGateway::GetUnroutedCount(Port from) const
+{
+  return tables_[static_cast<uint8_t>(from)].unrouted;
+}
+
+uint32_t CANGateway::GetMaxLatency(Port from) const
+{
+  return tables_[static_cast<uint8_t>(from)].max_latency;
+}
+
+uint32_t CANGateway::Key(uint32_t id, bool is_ext)
+{
+  return (id & ID_EXACT) | (is_ext ? 0x80000000 : 0);
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -0,0 +1,370 @@
+/*
+ * CANIsoTp.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANIsoTp.hpp>
+#include <cstring>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANIsoTpChannel::CANIsoTpChannel(DataModules::DataModule* module, Direction direction, uint32_t data_id, uint32_t fc_id, bool is_ext):
+    DataModule(direction == Direction::Rx ? data_id : fc_id, 0, CANDriver::MAX_DATA_SIZE, 0, is_ext),
+    module_(module), direction_(direction), data_id_(data_id), fc_id_(fc_id), owner_(nullptr),
+    buffer_(CANIsoTp::NO_BUFFER), expected_(0), received_(0), next_sn_(0), block_left_(0), tx_pending_(false)
+{ }
+
+CANIsoTpChannel::~CANIsoTpChannel()
+{ }
+
+void CANIsoTpChannel::ToByteArray(uint8_t* buff) const
+{
+  // Never sent directly, the transport builds the frames
+  (void)buff;
+}
+
+void CANIsoTpChannel::FromByteArray(uint8_t* buff)
+{
+  if(owner_ != nullptr)
+    owner_->HandleFrame(*this, buff);
+}
+
+CANIsoTp::CANIsoTp(CANDriver* driver):driver_(driver),stats_(),tx_active_(nullptr),fc_status_(0),
+    fc_block_size_(0),fc_stmin_(0),task_handle_(nullptr)
+{
+  for (Buffer& buffer : pool_)
+    buffer.owner = nullptr;
+}
+
+CANIsoTp::~CANIsoTp()
+{ }
+
+void CANIsoTp::Init()
+{
+  task_handle_ = osThreadNew((osThreadFunc_t)&CANIsoTp::HandleTransmit, this, &task_attributes_);
+  if (task_handle_ == NULL)
+  {
+      Error_Handler();
+  }
+}
+
+bool CANIsoTp::AddChannel(CANIsoTpChannel* channel)
+{
+  if(channels_.full() || channel->module_->size_ > MAX_MESSAGE_SIZE)
+    return false;
+  channel->owner_ = this;
+  if(driver_->AddRxModule(channel) != CANDriver::RegisterStatus::Ok)
+  {
+    channel->owner_ = nullptr;
+    return false;
+  }
+  channels_.push_back(channel);
+  return true;
+}
+
+bool CANIsoTp::Send(CANIsoTpChannel* channel)
+{
+  if(channel->owner_ != this || channel->direction_ != CANIsoTpChannel::Direction::Tx || channel->tx_pending_)
+    return false;
+  channel->tx_pending_ = true;
+  osThreadFlagsSet(task_handle_, FLAG_SEND);
+  return true;
+}
+
+const CANIsoTp::Stats& CANIsoTp::GetStats() const
+{
+  return stats_;
+}
+
+// ---- Receive side, runs on the CAN rx task ---- //
+
+void CANIsoTp::HandleFrame(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  if(channel.direction_ == CANIsoTpChannel::Direction::Tx)
+  {
+    HandleFlowControl(channel, data);
+    return;
+  }
+  switch(data[0] & 0xF0)
+  {
+    case PCI_SINGLE:
+      HandleSingle(channel, data);
+      break;
+    case PCI_FIRST:
+      HandleFirst(channel, data);
+      break;
+    case PCI_CONSECUTIVE:
+      HandleConsecutive(channel, data);
+      break;
+    default:
+      break;
+  }
+}
+
+void CANIsoTp::HandleFlowControl(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  if((data[0] & 0xF0) != PCI_FLOW || tx_active_ != &channel)
+    return;
+  fc_status_ = data[0] & 0x0F;
+  fc_block_size_ = data[1];
+  fc_stmin_ = data[2];
+  osThreadFlagsSet(task_handle_, FLAG_FLOW);
+}
+
+void CANIsoTp::HandleSingle(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  // A new message always replaces one still being reassembled
+  if(channel.buffer_ != NO_BUFFER)
+    Abort(channel);
+  uint8_t len = data[0] & 0x0F;
+  if(len == 0 || len > CANDriver::MAX_DATA_SIZE - 1 || len < channel.module_->size_)
+    return;
+  Complete(channel, &data[1]);
+}
+
+void CANIsoTp::HandleFirst(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  if(channel.buffer_ != NO_BUFFER)
+    Abort(channel);
+  uint16_t len = static_cast<uint16_t>(data[0] & 0x0F) << 8 | data[1];
+  // Only lengths the module can decode are accepted, anything else is an overflow. A first
+  // frame shorter than a full frame is malformed, the message would have fit a single frame.
+  if(len < CANDriver::MAX_DATA_SIZE || len > MAX_MESSAGE_SIZE || len < channel.module_->size_)
+  {
+    SendFlowControl(channel, FLOW_OVERFLOW);
+    return;
+  }
+  uint8_t index = AllocateBuffer(channel);
+  if(index == NO_BUFFER)
+  {
+    ++stats_.pool_exhausted;
+    SendFlowControl(channel, FLOW_OVERFLOW);
+    return;
+  }
+  channel.buffer_ = index;
+  channel.expected_ = len;
+  channel.received_ = CANDriver::MAX_DATA_SIZE - 2;
+  channel.next_sn_ = 1;
+  channel.block_left_ = RX_BLOCK_SIZE;
+  memcpy(pool_[index].data, &data[2], channel.received_);
+  SendFlowControl(channel, FLOW_CTS);
+}
+
+void CANIsoTp::HandleConsecutive(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  if(channel.buffer_ == NO_BUFFER)
+    return;
+  Buffer& buffer = pool_[channel.buffer_];
+  uint32_t now = osKernelGetTickCount();
+  // received_ only ever stops short of expected_ while a buffer is held, anything else is
+  // corrupt state and the lengths below would wrap
+  if((data[0] & 0x0F) != channel.next_sn_ || now - buffer.last_tick > MsToTicks(TIMEOUT_MS) ||
+     channel.received_ >= channel.expected_ || channel.expected_ > MAX_MESSAGE_SIZE)
+  {
+    Abort(channel);
+    return;
+  }
+  buffer.last_tick = now;
+  channel.next_sn_ = (channel.next_sn_ + 1) & 0x0F;
+  uint16_t len = channel.expected_ - channel.received_;
+  if(len > CANDriver::MAX_DATA_SIZE - 1)
+    len = CANDriver::MAX_DATA_SIZE - 1;
+  memcpy(&buffer.data[channel.received_], &data[1], len);
+  channel.received_ += len;
+  if(channel.received_ == channel.expected_)
+  {
+    Complete(channel, buffer.data);
+    buffer.owner = nullptr;
+    channel.buffer_ = NO_BUFFER;
+    return;
+  }
+  if(RX_BLOCK_SIZE != 0 && --channel.block_left_ == 0)
+  {
+    channel.block_left_ = RX_BLOCK_SIZE;
+    SendFlowControl(channel, FLOW_CTS);
+  }
+}
+
+void CANIsoTp::Complete(CANIsoTpChannel& channel, const uint8_t* data)
+{
+  DataModules::DataModule* module = channel.module_;
+  module->Receive(const_cast<uint8_t*>(data), osKernelGetTickCount());
+  ++stats_.rx_messages;
+}
+
+void CANIsoTp::Abort(CANIsoTpChannel& channel)
+{
+  if(channel.buffer_ == NO_BUFFER)
+    return;
+  pool_[channel.buffer_].owner = nullptr;
+  channel.buffer_ = NO_BUFFER;
+  ++stats_.rx_aborts;
+}
+
+uint8_t CANIsoTp::AllocateBuffer(CANIsoTpChannel& channel)
+{
+  // A sender that went quiet mid message would hold its buffer forever,
+  // so anything idle for longer than N_Cr is fair game
+  uint32_t now = osKernelGetTickCount();
+  uint32_t timeout = MsToTicks(TIMEOUT_MS);
+  for (uint8_t i = 0; i < POOL_SIZE; ++i)
+  {
+    Buffer& buffer = pool_[i];
+    if(buffer.owner != nullptr && now - buffer.last_tick > timeout)
+      Abort(*buffer.owner);
+    if(buffer.owner == nullptr)
+    {
+      buffer.owner = &channel;
+      buffer.last_tick = now;
+      return i;
+    }
+  }
+  return NO_BUFFER;
+}
+
+void CANIsoTp::SendFlowControl(const CANIsoTpChannel& channel, uint8_t status)
+{
+  CANFrame frame;
+  frame.id = channel.fc_id_;
+  frame.is_ext = channel.is_ext_id_;
+  frame.is_rtr = false;
+  frame.dlc = CANDriver::MAX_DATA_SIZE;
+  memset(frame.data, PADDING, sizeof(frame.data));
+  frame.data[0] = PCI_FLOW | status;
+  frame.data[1] = RX_BLOCK_SIZE;
+  frame.data[2] = RX_STMIN;
+  driver_->SendFrame(frame);
+}
+
+// ---- Transmit side, runs on the ISO-TP task ---- //
+
+void CANIsoTp::HandleTransmit()
+{
+  while(1)
+  {
+    osThreadFlagsWait(FLAG_SEND, osFlagsWaitAny, osWaitForever);
+    bool sent = true;
+    while(sent)
+    {
+      sent = false;
+      for (CANIsoTpChannel* channel : channels_)
+      {
+        if(!channel->tx_pending_)
+          continue;
+        if(Transmit(*channel))
+          ++stats_.tx_messages;
+        else
+          ++stats_.tx_aborts;
+        channel->tx_pending_ = false;
+        sent = true;
+      }
+    }
+  }
+}
+
+bool CANIsoTp::Transmit(CANIsoTpChannel& channel)
+{
+  DataModules::DataModule* module = channel.module_;
+  uint16_t size = module->size_;
+  osMutexAcquire(module->mutex_id_, osWaitForever);
+  module->ToByteArray(tx_buffer_);
+  osMutexRelease(module->mutex_id_);
+  uint8_t frame[CANDriver::MAX_DATA_SIZE];
+  if(size <= CANDriver::MAX_DATA_SIZE - 1)
+  {
+    frame[0] = PCI_SINGLE | size;
+    memcpy(&frame[1], tx_buffer_, size);
+    return SendSegment(channel, frame, size + 1);
+  }
+  // Flow control for a previous message that showed up late must not count for this one
+  osThreadFlagsClear(FLAG_FLOW);
+  tx_active_ = &channel;
+  frame[0] = PCI_FIRST | (size >> 8);
+  frame[1] = size;
+  memcpy(&frame[2], tx_buffer_, CANDriver::MAX_DATA_SIZE - 2);
+  uint16_t offset = CANDriver::MAX_DATA_SIZE - 2;
+  uint8_t sn = 1;
+  bool ok = SendSegment(channel, frame, CANDriver::MAX_DATA_SIZE);
+  while(ok && offset < size)
+  {
+    ok = WaitForFlowControl();
+    if(!ok)
+      break;
+    uint8_t block_size = fc_block_size_;
+    uint32_t separation = MsToTicks(SeparationMs(fc_stmin_));
+    for (uint16_t block = 0; offset < size && (block_size == 0 || block < block_size); ++block)
+    {
+      uint8_t len = size - offset < CANDriver::MAX_DATA_SIZE - 1 ? size - offset : CANDriver::MAX_DATA_SIZE - 1;
+      frame[0] = PCI_CONSECUTIVE | sn;
+      memcpy(&frame[1], &tx_buffer_[offset], len);
+      if(!SendSegment(channel, frame, len + 1))
+      {
+        ok = false;
+        break;
+      }
+      offset += len;
+      sn = (sn + 1) & 0x0F;
+      if(separation != 0 && offset < size)
+        osDelay(separation);
+    }
+  }
+  tx_active_ = nullptr;
+  return ok;
+}
+
+bool CANIsoTp::WaitForFlowControl()
+{
+  for (uint8_t waits = 0; waits <= MAX_WAIT_FRAMES; ++waits)
+  {
+    if(osThreadFlagsWait(FLAG_FLOW, osFlagsWaitAny, MsToTicks(TIMEOUT_MS)) & osFlagsError)
+      return false;
+    if(fc_status_ == FLOW_CTS)
+      return true;
+    if(fc_status_ != FLOW_WAIT)
+      return false;
+  }
+  return false;
+}
+
+bool CANIsoTp::SendSegment(const CANIsoTpChannel& channel, const uint8_t* payload, uint8_t len)
+{
+  CANFrame frame;
+  frame.id = channel.data_id_;
+  frame.is_ext = channel.is_ext_id_;
+  frame.is_rtr = false;
+  frame.dlc = CANDriver::MAX_DATA_SIZE;
+  memcpy(frame.data, payload, len);
+  memset(&frame.data[len], PADDING, CANDriver::MAX_DATA_SIZE - len);
+  // With no separation time the tx queue can fill up, wait for it to drain rather than drop a segment
+  uint32_t deadline = osKernelGetTickCount() + MsToTicks(TIMEOUT_MS);
+  CANDriver::TxStatus status;
+  while((status = driver_->SendFrame(frame)) == CANDriver::TxStatus::Full)
+  {
+    if(static_cast<int32_t>(osKernelGetTickCount() - deadline) >= 0)
+      return false;
+    osDelay(1);
+  }
+  return status == CANDriver::TxStatus::Queued;
+}
+
+uint32_t CANIsoTp::MsToTicks(uint32_t ms) const
+{
+  return (ms * osKernelGetTickFreq() + 999) / 1000;
+}
+
+uint32_t CANIsoTp::SeparationMs(uint8_t stmin)
+{
+  // 0x00-0x7F are milliseconds and 0xF1-0xF9 are 100-900us, which rounds up to a millisecond.
+  // Reserved values mean the longest separation.
+  if(stmin <= 0x7F)
+    return stmin;
+  if(stmin >= 0xF1 && stmin <= 0xF9)
+    return 1;
+  return 0x7F;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
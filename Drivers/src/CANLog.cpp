@@ -0,0 +1,128 @@
+/*
+ * CANLog.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANLog.hpp>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANLogReader::CANLogReader(const uint8_t* data, size_t size):data_(data),size_(size),offset_(0),
+    started_(false),tick_(0)
+{ }
+
+CANLogReader::~CANLogReader()
+{ }
+
+void CANLogReader::Rewind()
+{
+  offset_ = 0;
+  started_ = false;
+  tick_ = 0;
+  dictionary_.clear();
+}
+
+size_t CANLogReader::GetOffset() const
+{
+  return offset_;
+}
+
+CANLogReader::Status CANLogReader::Next(CANFrame& frame, CANLog::Direction& direction)
+{
+  uint8_t header;
+  while(true)
+  {
+    if(!ReadByte(header))
+      return Status::End;
+    if(!(header & CANLog::CONTROL_FLAG))
+      break;
+    uint8_t version;
+    if(header != CANLog::START || !ReadByte(version) || version != CANLog::VERSION || !ReadWord(tick_))
+      return Status::Error;
+    dictionary_.clear();
+    started_ = true;
+  }
+  // Frames before the first session start have nothing to resolve their IDs or ticks against
+  if(!started_)
+    return Status::Error;
+  uint32_t zigzag;
+  if(!ReadVarint(zigzag))
+    return Status::Error;
+  tick_ += (zigzag >> 1) ^ (0 - (zigzag & 1));
+  uint32_t key;
+  if(header & CANLog::NEW_ID_FLAG)
+  {
+    if(!ReadWord(key))
+      return Status::Error;
+    if(!dictionary_.full())
+      dictionary_.push_back(key);
+  }
+  else
+  {
+    uint8_t index;
+    if(!ReadByte(index) || index >= dictionary_.size())
+      return Status::Error;
+    key = dictionary_[index];
+  }
+  frame.id = key & CANLog::ID_MASK;
+  frame.is_ext = key & CANLog::EXT_FLAG;
+  frame.is_rtr = header & CANLog::RTR_FLAG;
+  frame.dlc = header & CANLog::DLC_MASK;
+  frame.tick = tick_;
+  frame.is_fd = frame.dlc > 8;
+  frame.brs = false;
+  if(frame.Length() > CANFrame::MAX_DATA_SIZE)
+    return Status::Error;
+  if(!frame.is_rtr)
+  {
+    for (uint8_t i = 0; i < frame.Length(); ++i)
+    {
+      if(!ReadByte(frame.data[i]))
+        return Status::Error;
+    }
+  }
+  direction = header & CANLog::TX_FLAG ? CANLog::Direction::Tx : CANLog::Direction::Rx;
+  return Status::Frame;
+}
+
+inline bool CANLogReader::ReadByte(uint8_t& value)
+{
+  if(offset_ >= size_)
+    return false;
+  value = data_[offset_++];
+  return true;
+}
+
+bool CANLogReader::ReadVarint(uint32_t& value)
+{
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7)
+  {
+    uint8_t byte;
+    if(!ReadByte(byte))
+      return false;
+    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if(!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool CANLogReader::ReadWord(uint32_t& value)
+{
+  value = 0;
+  for (uint8_t i = 0; i < 4; ++i)
+  {
+    uint8_t byte;
+    if(!ReadByte(byte))
+      return false;
+    value |= static_cast<uint32_t>(byte) << (8 * i);
+  }
+  return true;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
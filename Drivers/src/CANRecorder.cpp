@@ -0,0 +1,175 @@
+/*
+ * CANRecorder.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANRecorder.hpp>
+#include <cmsis_os.h>
+#include "main.h"
+
+namespace SolarGators {
+namespace Drivers {
+
+CANRecorder::CANRecorder(uint8_t* buffer, uint32_t size):buffer_(buffer),mask_(size - 1),head_(0),tail_(0),
+    recording_(false),last_tick_(0),record_count_(0),drop_count_(0)
+{ }
+
+CANRecorder::~CANRecorder()
+{ }
+
+bool CANRecorder::Start()
+{
+  uint32_t tick = osKernelGetTickCount();
+  uint8_t record[CANLog::START_SIZE] = {CANLog::START, CANLog::VERSION,
+      static_cast<uint8_t>(tick), static_cast<uint8_t>(tick >> 8),
+      static_cast<uint8_t>(tick >> 16), static_cast<uint8_t>(tick >> 24)};
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  bool started = Write(record, sizeof(record));
+  if(started)
+  {
+    dictionary_.clear();
+    last_tick_ = tick;
+    recording_ = true;
+  }
+  __set_PRIMASK(primask);
+  return started;
+}
+
+void CANRecorder::Stop()
+{
+  recording_ = false;
+}
+
+bool CANRecorder::IsRecording() const
+{
+  return recording_;
+}
+
+bool CANRecorder::Record(const CANFrame& frame, Direction direction)
+{
+  if(!recording_)
+    return false;
+  uint8_t record[CANLog::MAX_RECORD_SIZE];
+  uint8_t dlc = frame.dlc & CANLog::DLC_MASK;
+  uint8_t data_len = frame.Length() > CANFrame::MAX_DATA_SIZE ? CANFrame::MAX_DATA_SIZE : frame.Length();
+  uint32_t key = (frame.id & CANLog::ID_MASK) | (frame.is_ext ? CANLog::EXT_FLAG : 0);
+  bool stored = false;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  // The dictionary and last tick are only advanced once the record is in the ring,
+  // otherwise a dropped record would leave the reader out of step
+  uint8_t header = dlc;
+  if(direction == Direction::Tx)
+    header |= CANLog::TX_FLAG;
+  if(frame.is_rtr)
+    header |= CANLog::RTR_FLAG;
+  uint8_t index = 0;
+  while(index < dictionary_.size() && dictionary_[index] != key)
+    ++index;
+  bool new_id = index == dictionary_.size();
+  if(new_id)
+    header |= CANLog::NEW_ID_FLAG;
+  uint8_t len = 0;
+  record[len++] = header;
+  int32_t delta = static_cast<int32_t>(frame.tick - last_tick_);
+  len += EncodeVarint((static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31), &record[len]);
+  if(new_id)
+  {
+    record[len++] = key;
+    record[len++] = key >> 8;
+    record[len++] = key >> 16;
+    record[len++] = key >> 24;
+  }
+  else
+  {
+    record[len++] = index;
+  }
+  if(!frame.is_rtr)
+  {
+    for (uint8_t i = 0; i < data_len; ++i)
+      record[len++] = frame.data[i];
+  }
+  if(Write(record, len))
+  {
+    if(new_id && !dictionary_.full())
+      dictionary_.push_back(key);
+    last_tick_ = frame.tick;
+    ++record_count_;
+    stored = true;
+  }
+  else
+  {
+    ++drop_count_;
+  }
+  __set_PRIMASK(primask);
+  return stored;
+}
+
+size_t CANRecorder::Flush(const Sink& sink)
+{
+  size_t total = 0;
+  while(true)
+  {
+    uint32_t head = head_;
+    uint32_t tail = tail_;
+    if(head == tail)
+      break;
+    // Hand over the contiguous run up to the end of the buffer, then loop for the wrapped part
+    uint32_t offset = tail & mask_;
+    uint32_t len = head - tail;
+    if(len > mask_ + 1 - offset)
+      len = mask_ + 1 - offset;
+    size_t taken = sink(&buffer_[offset], len);
+    if(taken > len)
+      taken = len;
+    tail_ = tail + taken;
+    total += taken;
+    if(taken < len)
+      break;
+  }
+  return total;
+}
+
+uint32_t CANRecorder::GetUsed() const
+{
+  return head_ - tail_;
+}
+
+uint32_t CANRecorder::GetRecordCount() const
+{
+  return record_count_;
+}
+
+uint32_t CANRecorder::GetDropCount() const
+{
+  return drop_count_;
+}
+
+bool CANRecorder::Write(const uint8_t* data, uint8_t len)
+{
+  uint32_t head = head_;
+  if(mask_ + 1 - (head - tail_) < len)
+    return false;
+  for (uint8_t i = 0; i < len; ++i)
+    buffer_[(head + i) & mask_] = data[i];
+  head_ = head + len;
+  return true;
+}
+
+uint8_t CANRecorder::EncodeVarint(uint32_t value, uint8_t* out)
+{
+  uint8_t len = 0;
+  while(value >= 0x80)
+  {
+    out[len++] = static_cast<uint8_t>(value) | 0x80;
+    value >>= 7;
+  }
+  out[len++] = value;
+  return len;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
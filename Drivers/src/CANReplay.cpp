@@ -0,0 +1,70 @@
+/*
+ * CANReplay.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANReplay.hpp>
+#include <cmsis_os.h>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANReplay::CANReplay()
+{ }
+
+CANReplay::~CANReplay()
+{ }
+
+bool CANReplay::AddModule(DataModules::DataModule* module)
+{
+  return modules_.Insert(module) == CANDispatchTable::Result::Ok;
+}
+
+bool CANReplay::RemoveModule(uint32_t id, bool is_ext)
+{
+  return modules_.Remove(id, is_ext);
+}
+
+CANReplay::Stats CANReplay::Run(CANLogReader& reader, uint16_t speed, bool include_tx)
+{
+  Stats stats = {};
+  CANFrame frame;
+  CANLog::Direction direction;
+  uint32_t start = osKernelGetTickCount();
+  uint32_t first_tick = 0;
+  CANLogReader::Status status;
+  while((status = reader.Next(frame, direction)) == CANLogReader::Status::Frame)
+  {
+    if(stats.frames++ == 0)
+      first_tick = frame.tick;
+    if(direction == CANLog::Direction::Tx && !include_tx)
+      continue;
+    if(speed != UNTHROTTLED)
+    {
+      // Frames recorded out of tick order just go out straight away
+      int32_t offset = static_cast<int32_t>(frame.tick - first_tick) / speed;
+      int32_t wait = offset - static_cast<int32_t>(osKernelGetTickCount() - start);
+      if(wait > 0)
+        osDelay(wait);
+    }
+    CANDispatchTable::Entry* entry = modules_.Find(frame.id, frame.is_ext);
+    if(entry == nullptr || frame.is_rtr)
+    {
+      ++stats.unknown;
+      continue;
+    }
+    ++entry->rx_count;
+    entry->last_tick = frame.tick;
+    DataModules::DataModule* module = entry->module;
+    module->Receive(frame.data, osKernelGetTickCount());
+    ++stats.decoded;
+  }
+  stats.error = status == CANLogReader::Status::Error;
+  stats.ticks = osKernelGetTickCount() - start;
+  return stats;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -0,0 +1,177 @@
+/*
+ * CANSubscriptions.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANSubscriptions.hpp>
+#include <cstring>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANSubscriptions::CANSubscriptions():free_(0),pending_count_(0),notify_count_(0),coalesced_count_(0)
+{
+  // Poll scans the whole pool, so free entries must never look pending
+  for (uint8_t i = 0; i < MAX_SUBSCRIPTIONS; ++i)
+  {
+    subscriptions_[i].next = i + 1 < MAX_SUBSCRIPTIONS ? i + 1 : NONE;
+    subscriptions_[i].pending = false;
+  }
+}
+
+CANSubscriptions::~CANSubscriptions()
+{ }
+
+uint8_t CANSubscriptions::Add(uint8_t head, const Target& target, uint64_t mask, uint32_t coalesce_ticks)
+{
+  uint8_t index = free_;
+  if(index == NONE)
+    return NONE;
+  Subscription& subscription = subscriptions_[index];
+  free_ = subscription.next;
+  subscription.target = target;
+  subscription.mask = mask;
+  subscription.coalesce_ticks = coalesce_ticks;
+  subscription.last_notify = osKernelGetTickCount() - coalesce_ticks;
+  subscription.primed = false;
+  subscription.pending = false;
+  subscription.next = head;
+  return index;
+}
+
+uint8_t CANSubscriptions::Remove(uint8_t head, const void* target)
+{
+  uint8_t* link = &head;
+  while(*link != NONE)
+  {
+    uint8_t index = *link;
+    Subscription& subscription = subscriptions_[index];
+    const void* owner = subscription.target.thread != nullptr ? subscription.target.thread : subscription.target.event;
+    if(owner != target)
+    {
+      link = &subscription.next;
+      continue;
+    }
+    if(subscription.pending)
+      --pending_count_;
+    *link = subscription.next;
+    subscription.next = free_;
+    free_ = index;
+  }
+  return head;
+}
+
+void CANSubscriptions::RemoveAll(uint8_t head)
+{
+  while(head != NONE)
+  {
+    Subscription& subscription = subscriptions_[head];
+    uint8_t next = subscription.next;
+    if(subscription.pending)
+      --pending_count_;
+    subscription.next = free_;
+    free_ = head;
+    head = next;
+  }
+}
+
+void CANSubscriptions::OnFrame(uint8_t head, const CANFrame& frame, uint32_t now)
+{
+  for (uint8_t i = head; i != NONE; i = subscriptions_[i].next)
+  {
+    Subscription& subscription = subscriptions_[i];
+    if(!Changed(subscription, frame))
+      continue;
+    if(now - subscription.last_notify >= subscription.coalesce_ticks)
+    {
+      if(subscription.pending)
+      {
+        subscription.pending = false;
+        --pending_count_;
+      }
+      Notify(subscription, now);
+    }
+    else if(!subscription.pending)
+    {
+      subscription.pending = true;
+      ++pending_count_;
+    }
+    else
+    {
+      ++coalesced_count_;
+    }
+  }
+}
+
+uint32_t CANSubscriptions::Poll(uint32_t now)
+{
+  if(pending_count_ == 0)
+    return NO_DEADLINE;
+  uint32_t next = NO_DEADLINE;
+  for (Subscription& subscription : subscriptions_)
+  {
+    if(!subscription.pending)
+      continue;
+    uint32_t elapsed = now - subscription.last_notify;
+    if(elapsed >= subscription.coalesce_ticks)
+    {
+      subscription.pending = false;
+      --pending_count_;
+      Notify(subscription, now);
+    }
+    else if(subscription.coalesce_ticks - elapsed < next)
+    {
+      next = subscription.coalesce_ticks - elapsed;
+    }
+  }
+  return next;
+}
+
+uint32_t CANSubscriptions::GetNotifyCount() const
+{
+  return notify_count_;
+}
+
+uint32_t CANSubscriptions::GetCoalescedCount() const
+{
+  return coalesced_count_;
+}
+
+bool CANSubscriptions::Changed(Subscription& subscription, const CANFrame& frame)
+{
+  uint8_t length = frame.Length();
+  bool changed = !subscription.primed || length != subscription.last_length ||
+      ((Load64(subscription.last_data, length) ^ Load64(frame.data, length)) & subscription.mask) != 0;
+  if(!changed && length > 8 && subscription.mask == ALL_SIGNALS)
+    changed = memcmp(&subscription.last_data[8], &frame.data[8], length - 8) != 0;
+  if(changed)
+  {
+    memcpy(subscription.last_data, frame.data, length);
+    subscription.last_length = length;
+    subscription.primed = true;
+  }
+  return changed;
+}
+
+void CANSubscriptions::Notify(Subscription& subscription, uint32_t now)
+{
+  subscription.last_notify = now;
+  ++notify_count_;
+  if(subscription.target.thread != nullptr)
+    osThreadFlagsSet(subscription.target.thread, subscription.target.flags);
+  else
+    osEventFlagsSet(subscription.target.event, subscription.target.flags);
+}
+
+uint64_t CANSubscriptions::Load64(const uint8_t* data, uint8_t length)
+{
+  uint64_t value = 0;
+  for (uint8_t i = 0; i < length && i < 8; ++i)
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  return value;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
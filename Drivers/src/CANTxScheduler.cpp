@@ -0,0 +1,193 @@
+/*
+ * CANTxScheduler.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <CANTxScheduler.hpp>
+#include <string.h>
+
+namespace SolarGators {
+namespace Drivers {
+
+CANTxScheduler::CANTxScheduler(CANDriver* driver):driver_(driver),epoch_(0),timer_(nullptr)
+{
+  mutex_id_ = osMutexNew(&mutex_attributes_);
+}
+
+CANTxScheduler::~CANTxScheduler()
+{ }
+
+void CANTxScheduler::Init()
+{
+  epoch_ = osKernelGetTickCount();
+  osMutexAcquire(mutex_id_, osWaitForever);
+  for (Entry& entry : entries_)
+    entry.next_due = epoch_ + entry.phase;
+  osMutexRelease(mutex_id_);
+  timer_ = osTimerNew(&CANTxScheduler::TimerCallback, osTimerPeriodic, this, &timer_attributes_);
+  if (timer_ == NULL)
+  {
+      Error_Handler();
+  }
+  osTimerStart(timer_, 1);
+}
+
+bool CANTxScheduler::AddModule(DataModules::DataModule* module, uint32_t period, uint32_t phase, bool send_on_change)
+{
+  if(period == 0 || module->size_ > driver_->GetMaxPayload())
+    return false;
+  osMutexAcquire(mutex_id_, osWaitForever);
+  if(entries_.full())
+  {
+    osMutexRelease(mutex_id_);
+    return false;
+  }
+  Entry entry = {};
+  entry.module = module;
+  entry.period = period;
+  entry.phase = (phase == AUTO_PHASE ? PickPhase(period) : phase) % period;
+  entry.send_on_change = send_on_change;
+  // First slot on this entry's grid that is not in the past
+  uint32_t elapsed = osKernelGetTickCount() - epoch_;
+  entry.next_due = epoch_ + entry.phase;
+  if(elapsed > entry.phase)
+    entry.next_due += ((elapsed - entry.phase + period - 1) / period) * period;
+  entries_.push_back(entry);
+  osMutexRelease(mutex_id_);
+  return true;
+}
+
+bool CANTxScheduler::RemoveModule(DataModules::DataModule* module)
+{
+  bool removed = false;
+  osMutexAcquire(mutex_id_, osWaitForever);
+  for (auto it = entries_.begin(); it != entries_.end(); ++it)
+  {
+    if(it->module == module)
+    {
+      entries_.erase(it);
+      removed = true;
+      break;
+    }
+  }
+  osMutexRelease(mutex_id_);
+  return removed;
+}
+
+bool CANTxScheduler::GetStats(DataModules::DataModule* module, Stats& stats) const
+{
+  bool found = false;
+  osMutexAcquire(mutex_id_, osWaitForever);
+  for (const Entry& entry : entries_)
+  {
+    if(entry.module == module)
+    {
+      stats = entry.stats;
+      found = true;
+      break;
+    }
+  }
+  osMutexRelease(mutex_id_);
+  return found;
+}
+
+void CANTxScheduler::Tick()
+{
+  // Don't stall the timer task behind a table update, anything due is sent next tick
+  if(osMutexAcquire(mutex_id_, 0) != osOK)
+    return;
+  uint32_t now = osKernelGetTickCount();
+  for (Entry& entry : entries_)
+  {
+    bool due = static_cast<int32_t>(now - entry.next_due) >= 0;
+    if(!due && !entry.send_on_change)
+      continue;
+    CANFrame frame;
+    frame.id = entry.module->can_id_;
+    frame.is_ext = entry.module->is_ext_id_;
+    frame.is_rtr = entry.module->is_rtr_;
+    frame.is_fd = entry.module->size_ > 8 || entry.module->is_brs_;
+    frame.brs = entry.module->is_brs_;
+    frame.dlc = CANFrame::LengthToDlc(entry.module->size_);
+    memset(frame.data, 0, frame.Length());
+    // This runs on the timer task, which also drives bus-off recovery, so never wait for a
+    // module another task is updating. The entry stays due and is tried again next tick.
+    if(osMutexAcquire(entry.module->mutex_id_, 0) != osOK)
+    {
+      if(due)
+        ++entry.stats.busy;
+      continue;
+    }
+    entry.module->ToByteArray(frame.data);
+    osMutexRelease(entry.module->mutex_id_);
+    bool changed = memcmp(frame.data, entry.last_data, entry.module->size_) != 0;
+    if(!due && !changed)
+      continue;
+    if(driver_->SendFrame(frame) != CANDriver::TxStatus::Queued)
+    {
+      ++entry.stats.deferred;
+      continue;
+    }
+    memcpy(entry.last_data, frame.data, entry.module->size_);
+    ++entry.stats.sent;
+    if(!due)
+    {
+      ++entry.stats.changes;
+      continue;
+    }
+    uint32_t jitter = now - entry.next_due;
+    entry.stats.total_jitter += jitter;
+    if(jitter > entry.stats.max_jitter)
+      entry.stats.max_jitter = jitter;
+    // Stay on the grid, skipping any periods that were missed entirely
+    entry.next_due += entry.period;
+    if(static_cast<int32_t>(now - entry.next_due) >= 0)
+      entry.next_due += ((now - entry.next_due) / entry.period + 1) * entry.period;
+  }
+  osMutexRelease(mutex_id_);
+}
+
+void CANTxScheduler::TimerCallback(void* arg)
+{
+  static_cast<CANTxScheduler*>(arg)->Tick();
+}
+
+uint32_t CANTxScheduler::PickPhase(uint32_t period) const
+{
+  // Two entries collide at some point iff their phases are equal modulo the gcd of their
+  // periods, so pick the phase that collides with the fewest existing entries
+  uint32_t best_phase = 0;
+  uint8_t best_collisions = 0xFF;
+  for (uint32_t phase = 0; phase < period && best_collisions != 0; ++phase)
+  {
+    uint8_t collisions = 0;
+    for (const Entry& entry : entries_)
+    {
+      uint32_t gcd = Gcd(period, entry.period);
+      if(phase % gcd == entry.phase % gcd)
+        ++collisions;
+    }
+    if(collisions < best_collisions)
+    {
+      best_collisions = collisions;
+      best_phase = phase;
+    }
+  }
+  return best_phase;
+}
+
+uint32_t CANTxScheduler::Gcd(uint32_t a, uint32_t b)
+{
+  while(b != 0)
+  {
+    uint32_t t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
@@ -22,6 +22,8 @@ PitComms::~PitComms()
 
 void PitComms::SendDataModule(SolarGators::DataModules::DataModule& data_module)
 {
+  if(data_module.size_ > MAX_MODULE_SIZE)
+    return;
   // Start Condition
   radio_->SendByte(START_CHAR);
   // Only Sending one Datamodule
@@ -30,8 +32,8 @@ void PitComms::SendDataModule(SolarGators::DataModules::DataModule& data_module)
   radio_->SendByte(data_module.instance_id_);
   radio_->SendByte(data_module.size_);
   // Temporary buffer
-  uint8_t buff[16];
-  data_module.ToByteArray(buff);
+  uint8_t buff[MAX_MODULE_SIZE];
+  data_module.Snapshot(buff);
   // Send Buffer
   for (uint16_t i = 0; i < data_module.size_; ++i) {
     EscapeData(buff[i]);
@@ -41,6 +43,22 @@ void PitComms::SendDataModule(SolarGators::DataModules::DataModule& data_module)
   radio_->SendByte(END_CHAR);
 }
 
+void PitComms::SendBytes(uint8_t telem_id, const uint8_t* data, uint8_t len)
+{
+  // Start Condition
+  radio_->SendByte(START_CHAR);
+  radio_->SendByte(1);
+  radio_->SendByte(telem_id);
+  radio_->SendByte(0);
+  radio_->SendByte(len);
+  for (uint16_t i = 0; i < len; ++i) {
+    EscapeData(data[i]);
+    radio_->SendByte(data[i]);
+  }
+  // End condition
+  radio_->SendByte(END_CHAR);
+}
+
 inline void PitComms::EscapeData(uint8_t data)
 {
   if(data == START_CHAR || data == END_CHAR || data == ESC_CHAR)
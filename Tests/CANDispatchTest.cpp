@@ -0,0 +1,220 @@
+/*
+ * CANDispatchTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Insert, lookup and erase on CANDispatchTable with IDs chosen to share hash slots,
+ *               random operations checked against a reference map, and a lookup timing against
+ *               the etl::map the table replaced.
+ */
+
+#include <CANDispatch.hpp>
+#include "Test.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+#include "etl/map.h"
+
+using namespace SolarGators::Drivers;
+using SolarGators::DataModules::DataModule;
+
+namespace {
+  class TestModule final : public DataModule {
+  public:
+    TestModule(uint32_t can_id, bool is_ext):
+      DataModule(can_id, 0, 8, 0, is_ext)
+    {}
+    void ToByteArray(uint8_t*) const {}
+    void FromByteArray(uint8_t*) {}
+  };
+
+  // Same hash as the table, so the test can pick IDs that land on the same home slot
+  uint8_t Home(uint32_t id, bool is_ext)
+  {
+    uint32_t key = (id & 0x1FFFFFFF) | (is_ext ? 0x80000000 : 0);
+    return (key * 2654435769u) >> 25;
+  }
+
+  std::vector<std::unique_ptr<TestModule>> modules;
+
+  TestModule* Make(uint32_t id, bool is_ext)
+  {
+    modules.emplace_back(new TestModule(id, is_ext));
+    return modules.back().get();
+  }
+
+  // Extended IDs whose home slot is slot, walking up from start
+  std::vector<uint32_t> Colliding(uint8_t slot, uint32_t start, uint8_t count)
+  {
+    std::vector<uint32_t> ids;
+    for (uint32_t id = start; ids.size() < count; ++id)
+    {
+      if(Home(id, true) == slot)
+        ids.push_back(id);
+    }
+    return ids;
+  }
+
+  bool Found(const CANDispatchTable& table, const DataModule* module)
+  {
+    const CANDispatchTable::Entry* entry = table.Find(module->can_id_, module->is_ext_id_);
+    return entry != nullptr && entry->module == module;
+  }
+
+  // Every entry reachable by Find and by ForEach exactly once
+  void CheckConsistent(CANDispatchTable& table, const std::map<uint32_t, DataModule*>& expected)
+  {
+    CHECK(table.Size() == expected.size());
+    for (const auto& item : expected)
+      CHECK(Found(table, item.second));
+    size_t walked = 0;
+    table.ForEach([&](CANDispatchTable::Entry& entry) {
+      uint32_t key = entry.module->can_id_ | (entry.module->is_ext_id_ ? 0x80000000 : 0);
+      auto it = expected.find(key);
+      CHECK(it != expected.end() && it->second == entry.module);
+      ++walked;
+    });
+    CHECK(walked == expected.size());
+  }
+
+  // A long probe chain on one slot, with the chain running past the end of the slot array,
+  // then deletes from the front, middle and back so backward shift has to move entries
+  void TestCollisions()
+  {
+    CANDispatchTable table;
+    std::map<uint32_t, DataModule*> expected;
+    std::vector<DataModule*> chain;
+    for (uint32_t id : Colliding(CANDispatchTable::SLOT_COUNT - 2, 0x1000, 6))
+      chain.push_back(Make(id, true));
+    // Entries homed on the slots the chain spills into
+    std::vector<DataModule*> spill;
+    for (uint8_t slot : {0, 1})
+    {
+      for (uint32_t id : Colliding(slot, 0x2000, 2))
+        spill.push_back(Make(id, true));
+    }
+    for (DataModule* module : chain)
+      CHECK(table.Insert(module) == CANDispatchTable::Result::Ok);
+    for (DataModule* module : spill)
+      CHECK(table.Insert(module) == CANDispatchTable::Result::Ok);
+    for (DataModule* module : chain)
+      expected[module->can_id_ | 0x80000000] = module;
+    for (DataModule* module : spill)
+      expected[module->can_id_ | 0x80000000] = module;
+    CheckConsistent(table, expected);
+
+    // A standard ID with the same bits is a different key
+    CHECK(table.Find(chain[0]->can_id_ & 0x7FF, false) == nullptr);
+    CHECK(table.Insert(Make(chain[2]->can_id_, true)) == CANDispatchTable::Result::Duplicate);
+
+    for (size_t index : {size_t(0), size_t(3), size_t(5)})
+    {
+      CHECK(table.Remove(chain[index]->can_id_, true));
+      CHECK(!table.Remove(chain[index]->can_id_, true));
+      expected.erase(chain[index]->can_id_ | 0x80000000);
+      CHECK(!Found(table, chain[index]));
+      CheckConsistent(table, expected);
+    }
+    // Entries removed from the chain can come back
+    CHECK(table.Insert(chain[3]) == CANDispatchTable::Result::Ok);
+    expected[chain[3]->can_id_ | 0x80000000] = chain[3];
+    CheckConsistent(table, expected);
+    table.Clear();
+    CHECK(table.Size() == 0);
+    CHECK(!Found(table, chain[1]));
+  }
+
+  void TestFull()
+  {
+    CANDispatchTable table;
+    for (uint32_t id = 0; id < CANDispatchTable::MAX_MODULES; ++id)
+      CHECK(table.Insert(Make(0x100 + id, false)) == CANDispatchTable::Result::Ok);
+    CHECK(table.Insert(Make(0x700, false)) == CANDispatchTable::Result::Full);
+    // A duplicate is still reported as a duplicate when full
+    CHECK(table.Insert(Make(0x100, false)) == CANDispatchTable::Result::Duplicate);
+    CHECK(table.Remove(0x120, false));
+    CHECK(table.Insert(Make(0x700, false)) == CANDispatchTable::Result::Ok);
+  }
+
+  // Random inserts and removes drawn from a small ID pool so chains form and break up
+  void TestRandom()
+  {
+    std::vector<DataModule*> pool;
+    for (uint8_t slot = 0; slot < 8; ++slot)
+    {
+      for (uint32_t id : Colliding(slot * 16, 0x18000000, 6))
+        pool.push_back(Make(id, true));
+    }
+    for (uint32_t id = 0; id < 40; ++id)
+      pool.push_back(Make(id * 37, false));
+    CANDispatchTable table;
+    std::map<uint32_t, DataModule*> expected;
+    srand(3);
+    for (int step = 0; step < 20000; ++step)
+    {
+      DataModule* module = pool[rand() % pool.size()];
+      uint32_t key = module->can_id_ | (module->is_ext_id_ ? 0x80000000 : 0);
+      bool present = expected.count(key) != 0;
+      if(rand() % 2)
+      {
+        CANDispatchTable::Result result = table.Insert(module);
+        if(present)
+          CHECK(result == CANDispatchTable::Result::Duplicate);
+        else if(expected.size() >= CANDispatchTable::MAX_MODULES)
+          CHECK(result == CANDispatchTable::Result::Full);
+        else if(CHECK(result == CANDispatchTable::Result::Ok))
+          expected[key] = module;
+      }
+      else
+      {
+        CHECK(table.Remove(module->can_id_, module->is_ext_id_) == present);
+        expected.erase(key);
+      }
+      if(step % 64 == 0)
+        CheckConsistent(table, expected);
+    }
+    CheckConsistent(table, expected);
+  }
+
+  // Not a pass/fail check, timings on the host only hint at the target
+  void BenchmarkLookup()
+  {
+    constexpr uint32_t MODULES = 15;
+    constexpr uint32_t LOOKUPS = 2000000;
+    CANDispatchTable table;
+    etl::map<uint16_t, DataModule*, MODULES> map;
+    std::vector<uint16_t> ids;
+    for (uint32_t i = 0; i < MODULES; ++i)
+    {
+      DataModule* module = Make(0x200 + i * 0x41, false);
+      table.Insert(module);
+      map.insert(etl::make_pair(static_cast<uint16_t>(module->can_id_), module));
+      ids.push_back(module->can_id_);
+    }
+    uintptr_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOOKUPS; ++i)
+      sink += reinterpret_cast<uintptr_t>(table.Find(ids[i % MODULES], false)->module);
+    auto middle = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < LOOKUPS; ++i)
+      sink += reinterpret_cast<uintptr_t>(map.find(ids[i % MODULES])->second);
+    auto end = std::chrono::steady_clock::now();
+    auto ns = [](auto duration) {
+      return std::chrono::duration<double, std::nano>(duration).count() / LOOKUPS;
+    };
+    printf("CANDispatchTest: lookup %.1f ns, etl::map %.1f ns (%u)\n",
+           ns(middle - start), ns(end - middle), static_cast<unsigned>(sink & 1));
+  }
+}
+
+int main()
+{
+  TestCollisions();
+  TestFull();
+  TestRandom();
+  BenchmarkLookup();
+  return Test::Finish("CANDispatchTest");
+}
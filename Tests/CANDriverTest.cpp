@@ -0,0 +1,596 @@
+/*
+ * CANDriverTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Runs the real CANDriver against the fake bxCAN in stubs/HostCan. Checks the
+ *               planned filters reach the peripheral and route frames into the right fifo, the
+ *               priority fifo is decoded first and queued frames leave in CAN ID order.
+ */
+
+#include <CANBusStats.hpp>
+#include <CANErrorStats.hpp>
+#include <CANRecorder.hpp>
+#include "HostNode.hpp"
+#include "Test.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using SolarGators::Drivers::CANBusStats;
+using SolarGators::Drivers::CANDriver;
+using SolarGators::Drivers::CANErrorStats;
+using SolarGators::Drivers::CANFrame;
+using SolarGators::Drivers::CANLogReader;
+using SolarGators::Drivers::CANRecorder;
+using SolarGators::DataModules::DataModule;
+using HostCan::Peripheral;
+using Test::Frame;
+using Test::HostNode;
+using Test::WaitFor;
+
+namespace {
+  class BytesModule final : public DataModule {
+  public:
+    BytesModule(uint32_t can_id, bool is_ext = false): DataModule(can_id, 0, 8, 0, is_ext), bytes{} {}
+    void ToByteArray(uint8_t* buff) const override { memcpy(buff, bytes, sizeof(bytes)); }
+    void FromByteArray(uint8_t* buff) override { memcpy(bytes, buff, sizeof(bytes)); }
+    uint8_t bytes[8];
+  };
+
+  // Modules and anything a hook uses are static, the drivers and their rx tasks outlive the tests
+
+  // Registered IDs pass the filters into the fifo for their priority and get decoded,
+  // everything else is stopped in hardware
+  void TestFilterRouting()
+  {
+    HostNode node;
+    static BytesModule bulk(0x123);
+    static BytesModule urgent(0x010);
+    static BytesModule extended(0x18FF50E5, true);
+    node.driver.Init();
+    CHECK(node.driver.AddRxModule(&bulk) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.AddRxModule(&urgent, true) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.AddRxModule(&extended) == CANDriver::RegisterStatus::Ok);
+
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    CHECK(node.can.Receive(Frame(0x123, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(node.can.Receive(Frame(0x010, false, 8, data)) == CAN_RX_FIFO1);
+    CHECK(node.can.Receive(Frame(0x18FF50E5, true, 8, data)) == CAN_RX_FIFO0);
+    CHECK(node.can.Receive(Frame(0x124, false, 8, data)) == Peripheral::NOT_ACCEPTED);
+    CHECK(node.can.Receive(Frame(0x123, true, 8, data)) == Peripheral::NOT_ACCEPTED);
+    CHECK(WaitFor([&]() { return node.driver.GetRxFrameCount() == 3; }));
+    CHECK(bulk.GetSequence() == 1 && urgent.GetSequence() == 1 && extended.GetSequence() == 1);
+    CHECK(memcmp(bulk.bytes, data, sizeof(data)) == 0);
+    CHECK(node.driver.GetUnknownIdCount() == 0);
+
+    // Removing a module takes its ID out of the filters again
+    CHECK(node.driver.RemoveRxModule(0x123) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.can.Receive(Frame(0x123, false, 8, data)) == Peripheral::NOT_ACCEPTED);
+    CHECK(node.can.Receive(Frame(0x010, false, 8, data)) == CAN_RX_FIFO1);
+    CHECK(WaitFor([&]() { return urgent.GetSequence() == 2; }));
+  }
+
+  // Frames waiting in both hardware fifos, the priority one is handed over first
+  void TestPriorityFirst()
+  {
+    HostNode node;
+    static BytesModule bulk(0x300);
+    static BytesModule urgent(0x301);
+    static std::mutex mutex;
+    static std::vector<uint32_t> order;
+    node.driver.SetFrameHook([&](const CANFrame& frame) {
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(frame.id);
+      return true;
+    });
+    CHECK(node.driver.AddRxModule(&bulk) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.AddRxModule(&urgent, true) == CANDriver::RegisterStatus::Ok);
+    node.driver.Init();
+
+    // Hold the interrupt back so both fifos fill before the driver sees either
+    node.can.on_rx = nullptr;
+    CHECK(node.can.Receive(Frame(0x300, false, 8)) == CAN_RX_FIFO0);
+    CHECK(node.can.Receive(Frame(0x300, false, 8)) == CAN_RX_FIFO0);
+    CHECK(node.can.Receive(Frame(0x301, false, 8)) == CAN_RX_FIFO1);
+    HostIrq::Interrupt([&]() { node.driver.SetRxFlag(); });
+    CHECK(WaitFor([&]() { return node.driver.GetRxFrameCount() == 3; }));
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(order == std::vector<uint32_t>({0x301, 0x300, 0x300}));
+  }
+
+  // A failed HAL read leaves the frame in the fifo, nothing half read reaches the rx task and the
+  // next interrupt picks the frame up
+  void TestFailedRead()
+  {
+    HostNode node;
+    static BytesModule module(0x222);
+    CHECK(node.driver.AddRxModule(&module) == CANDriver::RegisterStatus::Ok);
+    node.driver.Init();
+    uint8_t first[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+    uint8_t second[8] = {2, 2, 2, 2, 2, 2, 2, 2};
+    node.can.FailRxReads(1);
+    CHECK(node.can.Receive(Frame(0x222, false, 8, first)) == CAN_RX_FIFO0);
+    osDelay(20);
+    CHECK(node.driver.GetRxFrameCount() == 0);
+    CHECK(node.can.GetRxFifoFillLevel(CAN_RX_FIFO0) == 1);
+    CHECK(node.can.Receive(Frame(0x222, false, 8, second)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return node.driver.GetRxFrameCount() == 2; }));
+    osDelay(20);
+    CHECK(node.driver.GetRxFrameCount() == 2);
+    CHECK(node.driver.GetUnknownIdCount() == 0);
+    CHECK(module.GetSequence() == 2);
+    CHECK(memcmp(module.bytes, second, sizeof(second)) == 0);
+  }
+
+  // Bus load over the first one second window. Each node gets a bit rate that puts the load
+  // near 85%, so one bit per frame more or less moves it by about a percent.
+  struct LoadCase {
+    CANFrame frame;
+    uint32_t frame_bits;                           // Worked out by hand from the frame layout
+    bool tx;                                       // Counted on the way out instead of in
+    HostNode* node;
+    uint32_t bit_rate;
+  };
+  constexpr uint32_t LOAD_FRAMES = 100;
+
+  // The window length isn't known exactly, the rate over the same window pins it down
+  bool LoadMatches(const LoadCase& load_case, uint16_t rate, uint8_t load)
+  {
+    if(rate == 0)
+      return false;
+    uint64_t bits = static_cast<uint64_t>(LOAD_FRAMES) * load_case.frame_bits * 1000 * 100;
+    uint64_t longest = (LOAD_FRAMES * 1000 + rate - 1) / rate;
+    uint64_t shortest = LOAD_FRAMES * 1000 / (rate + 1);
+    return load >= bits / (load_case.bit_rate * longest) && load <= bits / (load_case.bit_rate * shortest);
+  }
+
+  void TestBusLoad()
+  {
+    uint8_t data[8] = {};
+    CANFrame remote = Frame(0x120, false, 8);
+    remote.is_rtr = true;
+    // 47 fixed bits for a standard frame and 67 for an extended one, plus the data, plus one
+    // stuff bit per 8 bits up to the CRC
+    LoadCase cases[] = {
+      {Frame(0x120, false, 8, data), 47 + 64 + (34 + 64 - 1) / 8, false},
+      {Frame(0x18FF50E5, true, 8, data), 67 + 64 + (54 + 64 - 1) / 8, false},
+      {remote, 47 + (34 - 1) / 8, false},          // A remote frame has a DLC but no data
+      {Frame(0x18FF50E5, true, 2, data), 67 + 16 + (54 + 16 - 1) / 8, true},
+    };
+    for (LoadCase& load_case : cases)
+    {
+      load_case.node = new HostNode;
+      uint32_t prescaler = Peripheral::PCLK1 / 16 * 85 / (100 * LOAD_FRAMES * load_case.frame_bits);
+      load_case.bit_rate = Peripheral::PCLK1 / (prescaler * 16);
+      load_case.node->can.Handle()->Instance->BTR = (prescaler - 1) << CAN_BTR_BRP_Pos | 12 << CAN_BTR_TS1_Pos | 1 << CAN_BTR_TS2_Pos;
+      load_case.node->driver.SetAcceptAll(true);
+      load_case.node->driver.Init();
+    }
+    for (LoadCase& load_case : cases)
+    {
+      CANDriver& driver = load_case.node->driver;
+      for (uint32_t i = 0; i < LOAD_FRAMES; ++i)
+      {
+        if(load_case.tx)
+        {
+          CHECK(driver.SendFrame(load_case.frame) == CANDriver::TxStatus::Queued);
+          CHECK(load_case.node->can.Transmit() == 1);
+        }
+        else
+        {
+          CHECK(load_case.node->can.Receive(load_case.frame) == CAN_RX_FIFO0);
+          // Keep well inside the rx ring
+          if(i % 16 == 15)
+            CHECK(WaitFor([&]() { return driver.GetRxFrameCount() == i + 1; }));
+        }
+      }
+    }
+    for (LoadCase& load_case : cases)
+    {
+      CANDriver& driver = load_case.node->driver;
+      CHECK(WaitFor([&]() { return driver.GetBusLoad() != 0; }, 2000));
+      uint16_t rate = load_case.tx ? driver.GetTxRate() : driver.GetRxRate();
+      CHECK(LoadMatches(load_case, rate, driver.GetBusLoad()));
+      CHECK(driver.GetRxOverflowCount(CAN_RX_FIFO0) == 0);
+      // The pit sees the same numbers
+      CANBusStats stats(&driver, 0x7F0, 0);
+      uint8_t buff[CANBusStats::Size];
+      stats.ToByteArray(buff);
+      CHECK(buff[0] == driver.GetBusLoad());
+      CHECK((buff[4] | buff[5] << 8) == driver.GetRxRate());
+      CHECK((buff[6] | buff[7] << 8) == driver.GetTxRate());
+    }
+  }
+
+  // Classic frames can carry DLC 9-15 on the wire, they still only hold 8 bytes and have to
+  // reach subscriptions and the recorder as 8 byte frames
+  void TestLongDlc()
+  {
+    HostNode node;
+    static BytesModule module(0x333);
+    static uint8_t log[1024];
+    static CANRecorder recorder(log, sizeof(log));
+    osEventFlagsId_t event = osEventFlagsNew(nullptr);
+    CHECK(node.driver.AddRxModule(&module) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.SubscribeEvent(&module, event, 0x1));
+    CHECK(recorder.Start());
+    node.driver.SetRecorder(&recorder);
+    node.driver.Init();
+    for (uint8_t dlc = 9; dlc <= 15; ++dlc)
+    {
+      uint8_t data[8];
+      for (uint8_t i = 0; i < 8; ++i)
+        data[i] = dlc * 16 + i;
+      CHECK(node.can.Receive(Frame(0x333, false, 8, data)) == CAN_RX_FIFO0);
+      // Frame copies the 8 data bytes, then the header says more
+      CANFrame frame = Frame(0x333, false, 8, data);
+      frame.dlc = dlc;
+      CHECK(node.can.Receive(frame) == CAN_RX_FIFO0);
+      CHECK(WaitFor([&]() { return module.GetSequence() == (dlc - 8u) * 2; }));
+      CHECK(memcmp(module.bytes, data, sizeof(data)) == 0);
+      // The same 8 bytes twice is no change
+      CHECK(osEventFlagsWait(event, 0x1, osFlagsWaitAny, 0) == 0x1);
+      CHECK(osEventFlagsWait(event, 0x1, osFlagsWaitAny, 0) == osFlagsErrorTimeout);
+    }
+    node.driver.SetRecorder(nullptr);
+    std::vector<uint8_t> recorded;
+    recorder.Flush([&](const uint8_t* data, size_t len) {
+      recorded.insert(recorded.end(), data, data + len);
+      return len;
+    });
+    CANLogReader reader(recorded.data(), recorded.size());
+    CANFrame frame;
+    SolarGators::Drivers::CANLog::Direction direction;
+    uint32_t frames = 0;
+    while(reader.Next(frame, direction) == CANLogReader::Status::Frame)
+    {
+      CHECK(frame.dlc == 8);
+      ++frames;
+    }
+    CHECK(frames == 14);
+    CHECK(reader.Next(frame, direction) == CANLogReader::Status::End);
+  }
+
+  // Entering warning, passive and bus-off raises the error interrupt, leaving them only shows in
+  // the status register and is picked up by the rx task
+  void TestErrorStates()
+  {
+    using State = CANDriver::ErrorState;
+    HostNode node;
+    node.driver.Init();
+    node.can.SetErrorCounters(100, 20);
+    CHECK(node.driver.GetErrorState() == State::Warning);
+    node.can.SetErrorCounters(110, 130);
+    CHECK(node.driver.GetErrorState() == State::Passive);
+    CHECK(node.driver.GetTransmitErrorCount() == 110 && node.driver.GetReceiveErrorCount() == 130);
+    node.can.SetErrorCounters(90, 10);
+    CHECK(node.driver.GetErrorState() == State::Passive);
+    CHECK(WaitFor([&]() { return node.driver.GetErrorState() == State::Active; }));
+    CHECK(node.driver.GetErrorStateCount(State::Warning) == 1);
+    CHECK(node.driver.GetErrorStateCount(State::Passive) == 1);
+    CHECK(node.driver.GetErrorStateCount(State::Active) == 1);
+    CHECK(node.driver.GetErrorStateCount(State::BusOff) == 0);
+
+    CANDriver::ErrorTransition history[4];
+    CHECK(node.driver.GetErrorHistory(history, 4) == 3);
+    CHECK(history[0].from == State::Passive && history[0].to == State::Active);
+    CHECK(history[0].tec == 90 && history[0].rec == 10);
+    CHECK(history[1].from == State::Warning && history[1].to == State::Passive);
+    CHECK(history[1].tec == 110 && history[1].rec == 130);
+    CHECK(history[2].from == State::Active && history[2].to == State::Warning);
+    CHECK(history[2].tec == 100 && history[2].rec == 20);
+
+    CANErrorStats stats(&node.driver, 0x7F1, 0);
+    uint8_t buff[CANErrorStats::Size];
+    stats.ToByteArray(buff);
+    CHECK(buff[0] == (static_cast<uint8_t>(State::Active) | static_cast<uint8_t>(State::Passive) << 2));
+    CHECK(buff[1] == 90 && buff[2] == 10);
+    CHECK(buff[3] == 1 && buff[4] == 1 && buff[5] == 0);
+    CHECK((buff[6] | buff[7] << 8) == 0);
+  }
+
+  // Ticks from start until the peripheral has been restarted count more times
+  uint32_t WaitForRestart(HostNode& node, uint32_t count, uint32_t start)
+  {
+    CHECK(WaitFor([&]() { return node.can.GetStartCount() >= count; }, 2000));
+    return osKernelGetTickCount() - start;
+  }
+
+  // Each recovery attempt on a broken bus waits twice as long as the last, up to the maximum.
+  // Queued frames go out once the node is back and the backoff starts over after a quiet spell.
+  void TestBusOffRecovery()
+  {
+    using State = CANDriver::ErrorState;
+    constexpr uint32_t MIN_MS = 25;
+    constexpr uint32_t MAX_MS = 200;
+    // A failed attempt is retried by the rx task, which can take up to a stale check to notice
+    constexpr uint32_t SLACK = CANDriver::STALE_CHECK_TICKS + 50;
+    // The next attempt can be armed before the poll here notices the last one
+    constexpr uint32_t POLL_SLACK = 2;
+    HostNode node;
+    node.driver.SetBusOffPolicy({MIN_MS, MAX_MS, false});
+    node.driver.Init();
+    CHECK(node.can.GetStartCount() == 1);
+    for (uint32_t id : {0x100u, 0x101u, 0x102u, 0x103u})
+      CHECK(node.driver.SendFrame(Frame(id, false, 1)) == CANDriver::TxStatus::Queued);
+    node.can.SetBusFault(true);
+    uint32_t start = osKernelGetTickCount();
+    node.can.SetErrorCounters(256, 0);
+    CHECK(node.driver.GetErrorState() == State::BusOff);
+    CHECK(node.can.Transmit() == 0);
+    uint32_t backoff = MIN_MS;
+    for (uint32_t attempt = 1; attempt <= 5; ++attempt)
+    {
+      uint32_t waited = WaitForRestart(node, attempt + 1, start);
+      CHECK(waited + POLL_SLACK >= backoff);
+      CHECK(waited <= backoff + SLACK);
+      CHECK(node.driver.GetErrorState() == State::BusOff);
+      start = osKernelGetTickCount();
+      backoff = backoff * 2 > MAX_MS ? MAX_MS : backoff * 2;
+    }
+    // The bus is fixed, the next attempt sticks
+    node.can.SetBusFault(false);
+    WaitForRestart(node, 7, start);
+    CHECK(WaitFor([&]() { return node.driver.GetErrorState() == State::Active; }));
+    CHECK(node.driver.GetErrorStateCount(State::BusOff) == 1);
+    CHECK(node.can.Transmit() == 4);
+    CHECK(node.can.TakeSent().size() == 4);
+    CHECK(node.driver.GetTxDropCount() == 0);
+
+    // After MAX_MS error active the first attempt is back to MIN_MS
+    osDelay(MAX_MS + CANDriver::STALE_CHECK_TICKS + 50);
+    start = osKernelGetTickCount();
+    node.can.SetErrorCounters(256, 0);
+    uint32_t waited = WaitForRestart(node, 8, start);
+    CHECK(waited + POLL_SLACK >= MIN_MS && waited <= MIN_MS + SLACK);
+    CHECK(WaitFor([&]() { return node.driver.GetErrorState() == State::Active; }));
+    CHECK(node.driver.GetErrorStateCount(State::BusOff) == 2);
+  }
+
+  // With flush_tx the queue and mailboxes are emptied on bus-off and nothing new is taken
+  void TestBusOffFlush()
+  {
+    HostNode node;
+    node.driver.SetBusOffPolicy({1000, 1000, true});
+    node.driver.Init();
+    for (uint32_t id : {0x100u, 0x101u, 0x102u, 0x103u, 0x104u})
+      CHECK(node.driver.SendFrame(Frame(id, false, 1)) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.GetTxQueueDepth() == 2);
+    node.can.SetErrorCounters(256, 0);
+    CHECK(node.driver.GetTxQueueDepth() == 0);
+    CHECK(node.driver.GetTxDropCount() == 2);
+    CHECK(node.can.GetAbortCount() == 1);
+    CHECK(node.can.GetPendingMailboxes() == 0);
+    CHECK(node.driver.SendFrame(Frame(0x105, false, 1)) == CANDriver::TxStatus::Dropped);
+    CHECK(node.driver.GetTxDropCount() == 3);
+  }
+
+  // A remote frame is answered from the rx task, which never waits on a module another task is
+  // writing. That request is dropped and frames behind it are still decoded.
+  void TestRemoteFrameBusyModule()
+  {
+    HostNode node;
+    static BytesModule responder(0x050);
+    static BytesModule other(0x051);
+    CHECK(node.driver.AddRtrResponder(&responder) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.AddRxModule(&other) == CANDriver::RegisterStatus::Ok);
+    node.driver.Init();
+    for (uint8_t i = 0; i < 8; ++i)
+      responder.bytes[i] = 0x50 + i;
+    CANFrame request = Frame(0x050, false, 8);
+    request.is_rtr = true;
+
+    osMutexAcquire(responder.mutex_id_, osWaitForever);
+    CHECK(node.can.Receive(request) == CAN_RX_FIFO0);
+    CHECK(node.can.Receive(Frame(0x051, false, 8)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return other.GetSequence() == 1; }));
+    CHECK(node.driver.GetRtrResponderStats(0x050, false)->rx_count == 1);
+    CHECK(node.driver.GetTxDropCount() == 1);
+    CHECK(node.can.GetPendingMailboxes() == 0);
+    osMutexRelease(responder.mutex_id_);
+
+    CHECK(node.can.Receive(request) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return node.can.GetPendingMailboxes() == 1; }));
+    CHECK(node.can.Transmit() == 1);
+    std::vector<CANFrame> sent = node.can.TakeSent();
+    CHECK(sent.size() == 1 && sent[0].id == 0x050 && !sent[0].is_rtr && sent[0].dlc == 8);
+    CHECK(sent.size() == 1 && memcmp(sent[0].data, responder.bytes, sizeof(responder.bytes)) == 0);
+    CHECK(node.driver.GetTxDropCount() == 1);
+  }
+
+  // bxCAN sends the lowest ID of the loaded mailboxes, the driver refills them from its queue in
+  // ID order. Frames queued behind three full mailboxes overtake the ones already loaded.
+  void TestTxOrder()
+  {
+    HostNode node;
+    node.driver.Init();
+    for (uint32_t id : {0x500u, 0x400u, 0x300u, 0x200u, 0x100u})
+      CHECK(node.driver.SendFrame(Frame(id, false, 2)) == CANDriver::TxStatus::Queued);
+    CHECK(node.can.GetPendingMailboxes() == 3);
+    CHECK(node.driver.GetTxQueueDepth() == 2);
+    CHECK(node.can.Transmit() == 5);
+    std::vector<uint32_t> ids;
+    for (const CANFrame& frame : node.can.TakeSent())
+      ids.push_back(frame.id);
+    CHECK(ids == std::vector<uint32_t>({0x300, 0x100, 0x200, 0x400, 0x500}));
+    CHECK(node.driver.GetTxFrameCount() == 5);
+    CHECK(node.driver.GetTxQueueDepth() == 0);
+  }
+
+  // Two nodes on one bus, a module sent by one is decoded by the other
+  void TestTwoNodes()
+  {
+    HostNode a;
+    HostNode b;
+    a.can.Connect(&b.can);
+    static BytesModule tx(0x0A5);
+    static BytesModule rx(0x0A5);
+    CHECK(b.driver.AddRxModule(&rx) == CANDriver::RegisterStatus::Ok);
+    a.driver.Init();
+    b.driver.Init();
+    for (uint8_t i = 0; i < 8; ++i)
+      tx.bytes[i] = 0xA0 + i;
+    CHECK(a.driver.Send(&tx) == CANDriver::TxStatus::Queued);
+    CHECK(a.can.Transmit() == 1);
+    CHECK(WaitFor([&]() { return rx.GetSequence() == 1; }));
+    CHECK(memcmp(rx.bytes, tx.bytes, sizeof(rx.bytes)) == 0);
+  }
+  // Registry changes while the rx task is part way through a batch. The rx task finishes the
+  // batch on the table it started with, the change after that has to wait for it and a removed
+  // module's subscriptions stay put until nothing can walk them.
+  void TestTablePublish()
+  {
+    HostNode node;
+    static BytesModule first(0x111);
+    static BytesModule second(0x222);
+    static BytesModule third(0x333);
+    static BytesModule fourth(0x444);
+    static std::atomic<bool> hold(false);
+    static std::atomic<bool> held(false);
+    static std::atomic<bool> change_from_hook(false);
+    static CANDriver::RegisterStatus hook_status[2];
+    static CANDriver* driver = &node.driver;
+    CHECK(node.driver.AddRxModule(&first) == CANDriver::RegisterStatus::Ok);
+    CHECK(node.driver.AddRxModule(&second) == CANDriver::RegisterStatus::Ok);
+    node.driver.SetFrameHook([](const CANFrame& frame)
+    {
+      if(frame.id == 0x111 && hold)
+      {
+        held = true;
+        while(hold)
+          osDelay(1);
+      }
+      // Only the first change of a batch can go through on the rx task
+      if(frame.id == 0x222 && change_from_hook.exchange(false))
+      {
+        hook_status[0] = driver->AddRxModule(&fourth);
+        hook_status[1] = driver->RemoveRxModule(0x333);
+      }
+      return true;
+    });
+    node.driver.Init();
+    osEventFlagsId_t first_event = osEventFlagsNew(nullptr);
+    osEventFlagsId_t second_event = osEventFlagsNew(nullptr);
+    CHECK(node.driver.SubscribeEvent(&first, first_event, 0x1));
+
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    hold = true;
+    CHECK(node.can.Receive(Frame(0x111, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return held.load(); }));
+    // The spare table is free, the change goes in and the rx task's table becomes the spare
+    CHECK(node.driver.RemoveRxModule(0x111) == CANDriver::RegisterStatus::Ok);
+    uint32_t start = osKernelGetTickCount();
+    CHECK(node.driver.AddRxModule(&third) == CANDriver::RegisterStatus::Busy);
+    CHECK(osKernelGetTickCount() - start >= CANDriver::TABLE_WAIT_TICKS);
+    // The removed chain isn't back in the pool yet, a new subscription can't land on it
+    CHECK(node.driver.SubscribeEvent(&second, second_event, 0x1));
+    hold = false;
+    // The held frame is decoded on the old table, module and subscriber included
+    CHECK(WaitFor([&]() { return first.GetSequence() == 1; }));
+    CHECK(osEventFlagsWait(first_event, 0x1, osFlagsWaitAny, 1000) == 0x1);
+    CHECK(osEventFlagsWait(second_event, 0x1, osFlagsWaitAny, 0) & osFlagsError);
+
+    // Once the batch is over the next change goes through
+    CHECK(WaitFor([&]() { return node.driver.AddRxModule(&third) == CANDriver::RegisterStatus::Ok; }));
+    CHECK(node.can.Receive(Frame(0x111, false, 8, data)) == Peripheral::NOT_ACCEPTED);
+    CHECK(node.can.Receive(Frame(0x222, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(osEventFlagsWait(second_event, 0x1, osFlagsWaitAny, 1000) == 0x1);
+    CHECK(osEventFlagsWait(first_event, 0x1, osFlagsWaitAny, 0) & osFlagsError);
+    CHECK(second.GetSequence() == 1);
+
+    // On the rx task the second change in a batch doesn't wait, the rx task would never let go
+    change_from_hook = true;
+    CHECK(node.can.Receive(Frame(0x222, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return second.GetSequence() == 2; }));
+    CHECK(hook_status[0] == CANDriver::RegisterStatus::Ok);
+    CHECK(hook_status[1] == CANDriver::RegisterStatus::Busy);
+    CHECK(WaitFor([&]() { return node.driver.RemoveRxModule(0x333) == CANDriver::RegisterStatus::Ok; }));
+    CHECK(node.can.Receive(Frame(0x444, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return fourth.GetSequence() == 1; }));
+    CHECK(node.can.Receive(Frame(0x333, false, 8, data)) == Peripheral::NOT_ACCEPTED);
+  }
+  // With a tx policy unchanged bytes are only sent again for the heartbeat or an urgent send.
+  // A frame the queue had no room for doesn't count, the same bytes go out on the next try.
+  void TestTxPolicy()
+  {
+    constexpr uint32_t HEARTBEAT = 100;
+    HostNode node;
+    static BytesModule module(0x150);
+    static BytesModule quiet(0x151);
+    static BytesModule filler(0x152);
+    node.driver.Init();
+    CHECK(node.driver.SetTxPolicy(&module, HEARTBEAT));
+    CHECK(node.driver.SetTxPolicy(&quiet, 0));
+    CANDriver::TxPolicyStats stats = {};
+    CHECK(!node.driver.GetTxPolicyStats(&filler, stats));
+
+    uint32_t start = osKernelGetTickCount();
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Suppressed);
+    module.bytes[7] = 1;
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Suppressed);
+    CHECK(node.driver.Send(&module, true) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Suppressed);
+    bool in_heartbeat = osKernelGetTickCount() - start < HEARTBEAT;
+    CHECK(node.driver.Send(&quiet) == CANDriver::TxStatus::Queued);
+    osDelay(HEARTBEAT + 5);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&quiet) == CANDriver::TxStatus::Suppressed);
+    CHECK(node.driver.GetTxPolicyStats(&module, stats));
+    CHECK(stats.sent == 4 && stats.urgent == 1);
+    // Only exact if nothing above took longer than the heartbeat
+    if(in_heartbeat)
+      CHECK(stats.suppressed == 3);
+    CHECK(node.can.Transmit() == 5);
+    node.can.TakeSent();
+
+    // Fill the mailboxes and the queue, then the change that didn't fit is tried again
+    uint8_t queued = 0;
+    while(node.driver.SendFrame(Frame(0x152, false, 8)) == CANDriver::TxStatus::Queued)
+      ++queued;
+    CHECK(queued == CANDriver::TX_QUEUE_SIZE + Peripheral::MAILBOXES);
+    module.bytes[7] = 2;
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Full);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Full);
+    CHECK(node.can.Transmit(1) == 1);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Suppressed);
+    CHECK(node.can.Transmit() == queued);
+    std::vector<CANFrame> sent = node.can.TakeSent();
+    CHECK(sent.size() == queued + 1u);
+    uint32_t changes = 0;
+    for (const CANFrame& frame : sent)
+      changes += frame.id == 0x150 && frame.data[7] == 2;
+    CHECK(changes == 1);
+
+    // Without a policy every send goes out
+    CHECK(node.driver.RemoveTxPolicy(&module));
+    CHECK(!node.driver.RemoveTxPolicy(&module));
+    CHECK(!node.driver.GetTxPolicyStats(&module, stats));
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.Send(&module) == CANDriver::TxStatus::Queued);
+    CHECK(node.driver.GetTxPolicyStats(&quiet, stats));
+    CHECK(stats.sent == 1 && stats.suppressed == 1 && stats.urgent == 0);
+  }
+}
+
+int main()
+{
+  TestFilterRouting();
+  TestPriorityFirst();
+  TestFailedRead();
+  TestLongDlc();
+  TestTxOrder();
+  TestTwoNodes();
+  TestBusLoad();
+  TestErrorStates();
+  TestBusOffRecovery();
+  TestBusOffFlush();
+  TestRemoteFrameBusyModule();
+  TestTablePublish();
+  TestTxPolicy();
+  Test::Exit("CANDriverTest");
+}
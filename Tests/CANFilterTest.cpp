@@ -0,0 +1,262 @@
+/*
+ * CANFilterTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Runs CANFilterPlanner layouts through a model of the bxCAN filter match logic
+ *               and checks which frames each layout accepts and which fifo they land in.
+ */
+
+#include <CANFilter.hpp>
+#include "Test.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace SolarGators::Drivers;
+
+namespace {
+  constexpr int REJECTED = -1;
+
+  struct Id {
+    uint32_t id;
+    bool is_ext;
+    bool is_rtr;
+    uint8_t fifo;
+  };
+
+  uint32_t Word32(uint32_t id, bool is_ext, bool is_rtr)
+  {
+    uint32_t rtr = is_rtr ? 1 << 1 : 0;
+    return is_ext ? (id << 3) | (1 << 2) | rtr : (id << 21) | rtr;
+  }
+
+  uint32_t Word16(uint32_t id, bool is_ext, bool is_rtr)
+  {
+    uint32_t rtr = is_rtr ? 1 << 4 : 0;
+    if(is_ext)
+      return (((id >> 18) & 0x7FF) << 5) | rtr | (1 << 3) | ((id >> 15) & 0x7);
+    return (id << 5) | rtr;
+  }
+
+  bool BankMatches(const CANFilterBank& bank, uint32_t id, bool is_ext, bool is_rtr)
+  {
+    bool list = bank.mode == CANFilterBank::Mode::IdList;
+    if(bank.scale == CANFilterBank::Scale::Bit32)
+    {
+      uint32_t word = Word32(id, is_ext, is_rtr);
+      return list ? word == bank.fr1 || word == bank.fr2 : ((word ^ bank.fr1) & bank.fr2) == 0;
+    }
+    uint32_t word = Word16(id, is_ext, is_rtr);
+    uint32_t halves[] = {bank.fr1 & 0xFFFF, bank.fr1 >> 16, bank.fr2 & 0xFFFF, bank.fr2 >> 16};
+    if(list)
+      return word == halves[0] || word == halves[1] || word == halves[2] || word == halves[3];
+    return ((word ^ halves[0]) & halves[1]) == 0 || ((word ^ halves[2]) & halves[3]) == 0;
+  }
+
+  // The fifo the hardware puts the frame in, or REJECTED. When several banks match, 32 bit
+  // beats 16 bit, then list beats mask, then the lower bank wins.
+  int Route(const CANFilterPlanner& planner, uint32_t id, bool is_ext, bool is_rtr)
+  {
+    int best = -1;
+    int best_rank = 0;
+    const auto& banks = planner.GetBanks();
+    for (size_t i = 0; i < banks.size(); ++i)
+    {
+      if(!BankMatches(banks[i], id, is_ext, is_rtr))
+        continue;
+      int rank = (banks[i].scale == CANFilterBank::Scale::Bit32 ? 2 : 0) +
+                 (banks[i].mode == CANFilterBank::Mode::IdList ? 1 : 0);
+      if(best < 0 || rank > best_rank)
+      {
+        best = i;
+        best_rank = rank;
+      }
+    }
+    return best < 0 ? REJECTED : banks[best].fifo;
+  }
+
+  bool Registered(const std::vector<Id>& ids, uint32_t id, bool is_ext, bool is_rtr)
+  {
+    for (const Id& entry : ids)
+    {
+      if(entry.id == id && entry.is_ext == is_ext && entry.is_rtr == is_rtr)
+        return true;
+    }
+    return false;
+  }
+
+  void Add(CANFilterPlanner& planner, const std::vector<Id>& ids)
+  {
+    for (const Id& entry : ids)
+      CHECK(planner.AddId(entry.id, entry.is_ext, entry.fifo, entry.is_rtr));
+  }
+
+  void CheckRegisteredRouted(const CANFilterPlanner& planner, const std::vector<Id>& ids)
+  {
+    for (const Id& entry : ids)
+      CHECK(Route(planner, entry.id, entry.is_ext, entry.is_rtr) == entry.fifo);
+  }
+
+  // Exact layouts accept the registered IDs and nothing else
+  void TestExactLayout()
+  {
+    std::vector<Id> ids;
+    // A block of 8 that merges into one mask, a pair that doesn't reach a mask and scattered IDs
+    for (uint32_t id = 0x200; id < 0x208; ++id)
+      ids.push_back({id, false, false, 0});
+    ids.push_back({0x300, false, false, 0});
+    ids.push_back({0x301, false, false, 0});
+    for (uint32_t id : {0x0A5u, 0x13Cu, 0x4F1u, 0x6FFu, 0x7EFu})
+      ids.push_back({id, false, false, 0});
+    // Remote frames for an ID that also has data frames registered
+    ids.push_back({0x0A5, false, true, 0});
+    // High priority IDs, one of them extended
+    ids.push_back({0x010, false, false, 1});
+    ids.push_back({0x011, false, false, 1});
+    ids.push_back({0x18FF50E5, true, false, 1});
+    // Extended bulk IDs, four of them merge into a mask
+    for (uint32_t id = 0x0CF00400; id < 0x0CF00404; ++id)
+      ids.push_back({id, true, false, 0});
+    ids.push_back({0x1ABCDEF0, true, false, 0});
+
+    CANFilterPlanner planner;
+    Add(planner, ids);
+    CHECK(planner.Plan(0));
+    CHECK(planner.GetBanks().size() <= planner.GetBankLimit());
+    CheckRegisteredRouted(planner, ids);
+    for (uint32_t id = 0; id <= 0x7FF; ++id)
+    {
+      for (bool rtr : {false, true})
+      {
+        if(!Registered(ids, id, false, rtr))
+          CHECK(Route(planner, id, false, rtr) == REJECTED);
+      }
+    }
+    // Extended IDs around the registered ones, and ones sharing their 16 bit filter bits
+    for (const Id& entry : ids)
+    {
+      if(!entry.is_ext)
+        continue;
+      for (uint32_t id = entry.id - 8; id <= entry.id + 8; ++id)
+      {
+        if(!Registered(ids, id, true, false))
+          CHECK(Route(planner, id, true, false) == REJECTED);
+      }
+      uint32_t alias = entry.id ^ 0x1;
+      if(!Registered(ids, alias, true, false))
+        CHECK(Route(planner, alias, true, false) == REJECTED);
+    }
+    // A standard ID never matches an extended filter with the same bits
+    CHECK(Route(planner, 0x18FF50E5 >> 18, false, false) == REJECTED);
+
+    // Removing an ID takes it out of the next plan
+    CHECK(planner.RemoveId(0x4F1, false));
+    CHECK(!planner.RemoveId(0x4F1, false));
+    CHECK(planner.Plan(0));
+    CHECK(Route(planner, 0x4F1, false, false) == REJECTED);
+    CHECK(Route(planner, 0x6FF, false, false) == 0);
+  }
+
+  // More scattered IDs than the banks hold falls back to accepting everything,
+  // with the priority IDs still in the priority fifo
+  void TestFallback()
+  {
+    std::vector<Id> ids;
+    srand(1);
+    for (int i = 0; i < 60; ++i)
+    {
+      uint32_t id = ((rand() & 0x7FFF) << 14) | (rand() & 0x3FFF);
+      if(!Registered(ids, id, true, false))
+        ids.push_back({id, true, false, static_cast<uint8_t>(i < 6 ? 1 : 0)});
+    }
+    CANFilterPlanner planner;
+    Add(planner, ids);
+    CHECK(!planner.Plan(0));
+    CHECK(planner.GetBanks().size() <= planner.GetBankLimit());
+    CheckRegisteredRouted(planner, ids);
+    CHECK(Route(planner, 0x123, false, false) == 0);
+    CHECK(Route(planner, 0x1FFFFFFF, true, false) == 0);
+    // The bulk fifo can be either one
+    CHECK(!planner.Plan(1));
+    for (const Id& entry : ids)
+      CHECK(Route(planner, entry.id, entry.is_ext, entry.is_rtr) == 1);
+  }
+
+  // With too many priority IDs for the list banks everything goes to the bulk fifo
+  void TestFallbackPriorityOverflow()
+  {
+    CANFilterPlanner planner;
+    for (uint32_t i = 0; i < 30; ++i)
+      CHECK(planner.AddId(0x10000000 | (i * 0x12345), true, 1));
+    CHECK(!planner.Plan(0));
+    CHECK(planner.GetBanks().size() <= planner.GetBankLimit());
+    for (uint32_t i = 0; i < 30; ++i)
+      CHECK(Route(planner, 0x10000000 | (i * 0x12345), true, false) == 0);
+  }
+
+  void TestAcceptAll()
+  {
+    CANFilterPlanner planner;
+    CHECK(planner.AddId(0x100, false, 1));
+    planner.SetAcceptAll(true);
+    CHECK(planner.Plan(0));
+    CHECK(Route(planner, 0x100, false, false) == 1);
+    CHECK(Route(planner, 0x555, false, false) == 0);
+    CHECK(Route(planner, 0x1234567, true, true) == 0);
+    planner.SetAcceptAll(false);
+    CHECK(planner.Plan(0));
+    CHECK(Route(planner, 0x555, false, false) == REJECTED);
+  }
+
+  // A driver given part of the banks on a dual CAN part plans within its share,
+  // and the full set on those parts fits layouts the STM32F0 can't
+  void TestBankLimit()
+  {
+    CANFilterPlanner planner;
+    CHECK(planner.GetBankLimit() == CANFilterPlanner::DEFAULT_BANKS);
+    std::vector<Id> ids;
+    for (uint32_t i = 0; i < 12; ++i)
+      ids.push_back({0x10000000 | (i * 0x12345), true, false, static_cast<uint8_t>(i < 4 ? 1 : 0)});
+    Add(planner, ids);
+    CHECK(planner.Plan(0));
+    CHECK(planner.GetBanks().size() == 6);
+    planner.SetBankLimit(4);
+    CHECK(!planner.Plan(0));
+    CHECK(planner.GetBanks().size() == 3);
+    CheckRegisteredRouted(planner, ids);
+    // Only room for the accept everything bank, priority IDs go to the bulk fifo
+    planner.SetBankLimit(0);
+    CHECK(planner.GetBankLimit() == 1);
+    CHECK(!planner.Plan(0));
+    CHECK(planner.GetBanks().size() == 1);
+    CHECK(Route(planner, ids[0].id, true, false) == 0);
+
+    CANFilterPlanner dual;
+    dual.SetBankLimit(CANFilterPlanner::MAX_BANKS + 1);
+    CHECK(dual.GetBankLimit() == CANFilterPlanner::MAX_BANKS);
+    for (uint32_t i = 0; i < 30; ++i)
+      CHECK(dual.AddId(0x10000000 | (i * 0x12345), true, 1));
+    CHECK(dual.Plan(0));
+    CHECK(dual.GetBanks().size() == 15);
+  }
+
+  void TestEmpty()
+  {
+    CANFilterPlanner planner;
+    CHECK(planner.Plan(0));
+    CHECK(planner.GetBanks().empty());
+    CHECK(Route(planner, 0x100, false, false) == REJECTED);
+  }
+}
+
+int main()
+{
+  TestExactLayout();
+  TestFallback();
+  TestFallbackPriorityOverflow();
+  TestAcceptAll();
+  TestBankLimit();
+  TestEmpty();
+  return Test::Finish("CANFilterTest");
+}
@@ -0,0 +1,156 @@
+/*
+ * CANFrameRingTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Full, empty and index wrap checks for CANFrameRing, and a producer/consumer stress
+ *               run where every frame must arrive once and in order or be counted as an overflow.
+ */
+
+#include <CANFrameRing.hpp>
+#include "Test.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace SolarGators::Drivers;
+
+namespace {
+  CANFrame MakeFrame(uint32_t sequence)
+  {
+    CANFrame frame = {};
+    frame.id = sequence & 0x7FF;
+    frame.tick = sequence;
+    frame.dlc = 8;
+    for (uint8_t i = 0; i < 8; ++i)
+      frame.data[i] = static_cast<uint8_t>(sequence >> (i % 4 * 8));
+    return frame;
+  }
+
+  bool Matches(const CANFrame& frame, uint32_t sequence)
+  {
+    CANFrame expected = MakeFrame(sequence);
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+      if(frame.data[i] != expected.data[i])
+        return false;
+    }
+    return frame.tick == sequence && frame.id == expected.id;
+  }
+
+  void TestFullAndEmpty()
+  {
+    CANFrameRing<8> ring;
+    CANFrame frame;
+    CHECK(ring.Available() == 0);
+    CHECK(!ring.Pop(frame));
+    for (uint32_t i = 0; i < 8; ++i)
+      CHECK(ring.Push(MakeFrame(i)));
+    CHECK(ring.Available() == 8);
+    CHECK(ring.Claim() == nullptr);
+    CHECK(!ring.Push(MakeFrame(8)));
+    CHECK(ring.GetOverflowCount() == 2);
+    CHECK(ring.GetHighWater() == 8);
+    // Peek walks the batch without consuming it
+    for (uint16_t i = 0; i < 8; ++i)
+      CHECK(Matches(ring.Peek(i), i));
+    ring.Release(3);
+    CHECK(ring.Available() == 5);
+    CHECK(ring.Push(MakeFrame(8)));
+    for (uint32_t i = 3; i <= 8; ++i)
+    {
+      CHECK(ring.Pop(frame));
+      CHECK(Matches(frame, i));
+    }
+    CHECK(ring.Available() == 0);
+    CHECK(!ring.Pop(frame));
+    CHECK(ring.GetOverflowCount() == 2);
+  }
+
+  // The 16 bit head and tail wrap long before the frame count does
+  void TestIndexWrap()
+  {
+    CANFrameRing<4> ring;
+    CANFrame frame;
+    uint32_t next_in = 0;
+    uint32_t next_out = 0;
+    for (uint32_t round = 0; round < 100000; ++round)
+    {
+      uint32_t burst = round % 4 + 1;
+      for (uint32_t i = 0; i < burst; ++i)
+        CHECK(ring.Push(MakeFrame(next_in++)));
+      CHECK(ring.Available() == burst);
+      while(ring.Pop(frame))
+      {
+        if(!Matches(frame, next_out++))
+        {
+          CHECK(false);
+          return;
+        }
+      }
+    }
+    CHECK(next_out == next_in);
+    CHECK(next_in > 0x20000);
+    CHECK(ring.GetOverflowCount() == 0);
+    CHECK(ring.GetHighWater() == 4);
+  }
+
+  // Producer and consumer on separate threads, as the ISR and rx task are on target
+  void TestConcurrent()
+  {
+    constexpr uint32_t FRAMES = 2000000;
+    CANFrameRing<32> ring;
+    std::atomic<bool> done(false);
+    uint32_t lost = 0;
+    std::thread producer([&]() {
+      for (uint32_t i = 0; i < FRAMES; ++i)
+      {
+        CANFrame* slot = ring.Claim();
+        if(slot == nullptr)
+        {
+          ++lost;
+          continue;
+        }
+        *slot = MakeFrame(i);
+        ring.Commit();
+      }
+      done = true;
+    });
+    uint32_t received = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    bool intact = true;
+    while(true)
+    {
+      bool finished = done;
+      uint16_t count = ring.Available();
+      for (uint16_t i = 0; i < count; ++i)
+      {
+        const CANFrame& frame = ring.Peek(i);
+        if(received != 0 && frame.tick <= last)
+          ordered = false;
+        if(!Matches(frame, frame.tick))
+          intact = false;
+        last = frame.tick;
+        ++received;
+      }
+      ring.Release(count);
+      if(finished && ring.Available() == 0)
+        break;
+    }
+    producer.join();
+    CHECK(ordered);
+    CHECK(intact);
+    CHECK(received + lost == FRAMES);
+    CHECK(ring.GetOverflowCount() == lost);
+    CHECK(ring.GetHighWater() <= 32);
+  }
+}
+
+int main()
+{
+  TestFullAndEmpty();
+  TestIndexWrap();
+  TestConcurrent();
+  return Test::Finish("CANFrameRingTest");
+}
@@ -0,0 +1,237 @@
+/*
+ * CANGatewayTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Bridges two real CANDrivers on fake bxCAN peripherals with a CANGateway. Frames
+ *               put on one port's bus are checked on the other port's mailboxes: routed, dropped,
+ *               remapped and rate limited, and what happens when the other port can't keep up.
+ *               Also times forwarding on the host.
+ */
+
+#include <CANGateway.hpp>
+#include "HostNode.hpp"
+#include "Test.hpp"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using SolarGators::Drivers::CANDriver;
+using SolarGators::Drivers::CANFrame;
+using SolarGators::Drivers::CANGateway;
+using SolarGators::DataModules::DataModule;
+using HostCan::Peripheral;
+using Test::Frame;
+using Test::HostNode;
+using Test::WaitFor;
+
+namespace {
+  class BytesModule final : public DataModule {
+  public:
+    explicit BytesModule(uint32_t can_id): DataModule(can_id, 0, 8, 0, false), bytes{} {}
+    void ToByteArray(uint8_t* buff) const override { memcpy(buff, bytes, sizeof(bytes)); }
+    void FromByteArray(uint8_t* buff) override { memcpy(bytes, buff, sizeof(bytes)); }
+    uint8_t bytes[8];
+  };
+
+  CANGateway::Route MakeRoute(uint32_t id, CANGateway::Action action, uint32_t remap_id = CANGateway::KEEP_ID,
+                              bool remap_ext = false, uint32_t min_interval = 0, bool local = false)
+  {
+    return {id, CANGateway::ID_EXACT, false, action, remap_id, remap_ext, min_interval, local};
+  }
+
+  // Frames the route has finished with, whatever happened to them
+  uint32_t Handled(const CANGateway::RouteStats* stats)
+  {
+    return stats->forwarded + stats->dropped + stats->rate_limited + stats->tx_full;
+  }
+
+  // Everything the gateway and the drivers hold on to lives as long as the rx tasks
+  struct Bridge {
+    Bridge(): a(), b(), gateway(*new CANGateway(&a.driver, &b.driver)) {}
+    HostNode a;
+    HostNode b;
+    CANGateway& gateway;
+  };
+
+  // Exact, masked and remapped routes, drops and the default action
+  void TestRouting()
+  {
+    Bridge bridge;
+    CANGateway& gateway = bridge.gateway;
+    static BytesModule local(0x101);
+    CHECK(bridge.a.driver.AddRxModule(&local) == CANDriver::RegisterStatus::Ok);
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x100, CANGateway::Action::Forward)));
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x101, CANGateway::Action::Forward, CANGateway::KEEP_ID,
+                                                          false, 0, true)));
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x200, CANGateway::Action::Drop)));
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x300, CANGateway::Action::Forward, 0x18FF0001, true)));
+    // 0x400-0x40F, except the exact route for 0x405 which is matched first
+    CHECK(gateway.AddRoute(CANGateway::Port::A, {0x400, 0x7F0, false, CANGateway::Action::Forward, 0x010, false, 0, false}));
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x405, CANGateway::Action::Drop)));
+    // Port B only has exact routes, so only they pass its filters
+    CHECK(gateway.AddRoute(CANGateway::Port::B, MakeRoute(0x500, CANGateway::Action::Forward, 0x501)));
+    CHECK(gateway.Compile());
+    CHECK(!gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x600, CANGateway::Action::Forward)));
+    bridge.a.driver.Init();
+    bridge.b.driver.Init();
+
+    uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    for (uint32_t id : {0x100u, 0x101u, 0x200u, 0x300u, 0x40Au, 0x405u, 0x123u})
+      CHECK(bridge.a.can.Receive(Frame(id, false, 8, data)) == CAN_RX_FIFO0);
+    CHECK(bridge.b.can.Receive(Frame(0x500, false, 3, data)) == CAN_RX_FIFO0);
+    CHECK(bridge.b.can.Receive(Frame(0x502, false, 8, data)) == Peripheral::NOT_ACCEPTED);
+    CHECK(WaitFor([&]() { return gateway.GetUnroutedCount(CANGateway::Port::A) == 1 &&
+                                 Handled(gateway.GetRouteStats(CANGateway::Port::B, 0x500, false)) == 1; }));
+
+    // The remapped ones go out under their new IDs. The first three filled the mailboxes,
+    // 0x010 waits for one to free up and then beats the rest.
+    CHECK(bridge.b.can.Transmit() == 4);
+    std::vector<CANFrame> sent = bridge.b.can.TakeSent();
+    CHECK(sent.size() == 4);
+    if(sent.size() == 4)
+    {
+      CHECK(sent[0].id == 0x100 && !sent[0].is_ext);
+      CHECK(sent[1].id == 0x010 && !sent[1].is_ext);
+      CHECK(sent[2].id == 0x101 && !sent[2].is_ext);
+      CHECK(sent[3].id == 0x18FF0001 && sent[3].is_ext);
+      CHECK(sent[3].dlc == 8 && memcmp(sent[3].data, data, 8) == 0);
+    }
+    CHECK(bridge.a.can.Transmit() == 1);
+    sent = bridge.a.can.TakeSent();
+    CHECK(sent.size() == 1 && sent[0].id == 0x501 && sent[0].dlc == 3 && memcmp(sent[0].data, data, 3) == 0);
+
+    CHECK(gateway.GetRouteStats(CANGateway::Port::A, 0x100, false)->forwarded == 1);
+    CHECK(gateway.GetRouteStats(CANGateway::Port::A, 0x200, false)->dropped == 1);
+    CHECK(gateway.GetRouteStats(CANGateway::Port::A, 0x405, false)->dropped == 1);
+    CHECK(gateway.GetRouteStats(CANGateway::Port::A, 0x400, false)->forwarded == 1);
+    CHECK(gateway.GetRouteStats(CANGateway::Port::A, 0x300, true) == nullptr);
+    // Only the local route reaches this port's modules
+    CHECK(WaitFor([&]() { return local.GetSequence() == 1; }));
+    CHECK(memcmp(local.bytes, data, 8) == 0);
+    CHECK(gateway.GetMaxLatency(CANGateway::Port::A) <= 5);
+  }
+
+  // A rate limited route forwards the first frame and drops the rest until the interval has passed
+  void TestRateLimit()
+  {
+    constexpr uint32_t INTERVAL = 50;
+    Bridge bridge;
+    CANGateway& gateway = bridge.gateway;
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x0C0, CANGateway::Action::Forward, CANGateway::KEEP_ID,
+                                                          false, INTERVAL)));
+    CHECK(gateway.Compile());
+    bridge.a.driver.Init();
+    bridge.b.driver.Init();
+    const CANGateway::RouteStats* stats = gateway.GetRouteStats(CANGateway::Port::A, 0x0C0, false);
+
+    uint32_t start = osKernelGetTickCount();
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+      CHECK(bridge.a.can.Receive(Frame(0x0C0, false, 1)) == CAN_RX_FIFO0);
+      CHECK(WaitFor([&]() { return Handled(stats) == i + 1; }));
+    }
+    // Only meaningful if the burst fit in the interval, which it does unless the host stalls
+    if(osKernelGetTickCount() - start < INTERVAL)
+    {
+      CHECK(stats->forwarded == 1);
+      CHECK(stats->rate_limited == 4);
+    }
+    osDelay(INTERVAL + 5);
+    CHECK(bridge.a.can.Receive(Frame(0x0C0, false, 1)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return Handled(stats) == 6; }));
+    CHECK(stats->forwarded >= 2);
+    CHECK(bridge.b.can.Transmit() == stats->forwarded);
+  }
+
+  // When the other port's bus is stuck the tx queue fills and the rest are counted, not blocked on
+  void TestSaturation()
+  {
+    constexpr uint32_t FRAMES = 40;
+    Bridge bridge;
+    CANGateway& gateway = bridge.gateway;
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x0D0, CANGateway::Action::Forward)));
+    CHECK(gateway.Compile());
+    bridge.a.driver.Init();
+    bridge.b.driver.Init();
+    const CANGateway::RouteStats* stats = gateway.GetRouteStats(CANGateway::Port::A, 0x0D0, false);
+
+    for (uint32_t i = 0; i < FRAMES; ++i)
+    {
+      CHECK(bridge.a.can.Receive(Frame(0x0D0, false, 1)) == CAN_RX_FIFO0);
+      CHECK(WaitFor([&]() { return Handled(stats) == i + 1; }));
+    }
+    uint32_t capacity = CANDriver::TX_QUEUE_SIZE + Peripheral::MAILBOXES;
+    CHECK(stats->forwarded == capacity);
+    CHECK(stats->tx_full == FRAMES - capacity);
+    // Everything that was queued still goes out once the bus moves
+    CHECK(bridge.b.can.Transmit() == capacity);
+    CHECK(bridge.a.can.Receive(Frame(0x0D0, false, 1)) == CAN_RX_FIFO0);
+    CHECK(WaitFor([&]() { return stats->forwarded == capacity + 1; }));
+  }
+
+  // Time from a frame landing in port A's fifo to it sitting in a port B mailbox, one at a time
+  // and with port B draining as fast as the gateway fills it. Not a pass/fail check, timings on
+  // the host only hint at the target.
+  void BenchmarkForwarding()
+  {
+    using Clock = std::chrono::steady_clock;
+    constexpr uint32_t FRAMES = 2000;
+    Bridge bridge;
+    CANGateway& gateway = bridge.gateway;
+    CHECK(gateway.AddRoute(CANGateway::Port::A, MakeRoute(0x0E0, CANGateway::Action::Forward, 0x0E1)));
+    CHECK(gateway.Compile());
+    bridge.a.driver.Init();
+    bridge.b.driver.Init();
+    const CANGateway::RouteStats* stats = gateway.GetRouteStats(CANGateway::Port::A, 0x0E0, false);
+
+    double total_ns = 0;
+    double worst_ns = 0;
+    for (uint32_t i = 0; i < FRAMES; ++i)
+    {
+      auto start = Clock::now();
+      bridge.a.can.Receive(Frame(0x0E0, false, 8));
+      while(bridge.b.can.GetPendingMailboxes() == 0)
+        std::this_thread::yield();
+      double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+      total_ns += ns;
+      worst_ns = ns > worst_ns ? ns : worst_ns;
+      bridge.b.can.Transmit();
+    }
+    bridge.b.can.TakeSent();
+
+    // Saturated: keep port A's rx ring topped up, port B sends whatever is queued in between
+    constexpr uint32_t IN_FLIGHT = CANDriver::RX_RING_SIZE / 2;
+    uint32_t injected = 0;
+    uint32_t sent = 0;
+    uint32_t base = Handled(stats);
+    auto start = Clock::now();
+    while(sent < FRAMES)
+    {
+      while(injected < FRAMES && injected - (Handled(stats) - base) < IN_FLIGHT)
+      {
+        bridge.a.can.Receive(Frame(0x0E0, false, 8));
+        ++injected;
+      }
+      sent += bridge.b.can.Transmit();
+      if(Handled(stats) - base == FRAMES && bridge.b.can.GetPendingMailboxes() == 0)
+        break;
+      std::this_thread::yield();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    printf("CANGatewayTest: forward %.0f ns mean, %.0f ns worst; saturated %.0f frames/s, %u tx full, %u rx overflow\n",
+           total_ns / FRAMES, worst_ns, sent / seconds, static_cast<unsigned>(stats->tx_full),
+           static_cast<unsigned>(bridge.a.driver.GetRxOverflowCount(CAN_RX_FIFO0)));
+    CHECK(Handled(stats) - base == FRAMES);
+  }
+}
+
+int main()
+{
+  TestRouting();
+  TestRateLimit();
+  TestSaturation();
+  BenchmarkForwarding();
+  Test::Exit("CANGatewayTest");
+}
@@ -0,0 +1,304 @@
+/*
+ * CANIsoTpTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Two CANIsoTp nodes on a fake bus segmenting and reassembling modules of several
+ *               sizes, then hand built first and consecutive frames that are short, too long, out
+ *               of sequence or carry more data than they announced.
+ */
+
+#include <CANIsoTp.hpp>
+#include "Test.hpp"
+
+#include <chrono>
+#include <functional>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+using namespace SolarGators::Drivers;
+using SolarGators::DataModules::DataModule;
+
+namespace {
+  class BlobModule final : public DataModule {
+  public:
+    BlobModule(uint32_t can_id, uint32_t size):
+      DataModule(can_id, 0, size),
+      data_(size, 0), frames_(0)
+    {}
+    void ToByteArray(uint8_t* buff) const
+    {
+      for (size_t i = 0; i < data_.size(); ++i)
+        buff[i] = data_[i];
+    }
+    void FromByteArray(uint8_t* buff)
+    {
+      for (size_t i = 0; i < data_.size(); ++i)
+        data_[i] = buff[i];
+      ++frames_;
+    }
+    void Fill(uint8_t seed)
+    {
+      for (size_t i = 0; i < data_.size(); ++i)
+        data_[i] = static_cast<uint8_t>(seed + i * 13);
+    }
+    std::vector<uint8_t> data_;
+    volatile uint32_t frames_;
+  };
+
+  // Delivers frames as the rx task would until done returns true
+  bool Pump(CANDriver& bus, const std::function<bool()>& done)
+  {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while(!done())
+    {
+      if(std::chrono::steady_clock::now() > deadline)
+        return false;
+      if(!bus.Deliver())
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+  }
+
+  void Inject(CANDriver& bus, uint32_t id, std::initializer_list<uint8_t> bytes)
+  {
+    CANFrame frame = {};
+    frame.id = id;
+    frame.dlc = CANDriver::MAX_DATA_SIZE;
+    uint8_t i = 0;
+    for (uint8_t byte : bytes)
+      frame.data[i++] = byte;
+    while(i < CANDriver::MAX_DATA_SIZE)
+      frame.data[i++] = 0xCC;
+    bus.SendFrame(frame);
+    while(bus.Deliver())
+      ;
+  }
+
+  // First byte of the last flow control sent on fc_id, 0 if there was none
+  uint8_t LastFlowControl(CANDriver& bus, uint32_t fc_id)
+  {
+    std::vector<CANFrame> sent = bus.GetSent();
+    for (auto it = sent.rbegin(); it != sent.rend(); ++it)
+    {
+      if(it->id == fc_id)
+        return it->data[0];
+    }
+    return 0;
+  }
+
+  constexpr uint8_t FC_CTS = 0x30;
+  constexpr uint8_t FC_OVERFLOW = 0x32;
+
+  CANDriver bus;
+  CANIsoTp sender(&bus);
+  CANIsoTp receiver(&bus);
+
+  // Sizes that take a single frame, a first frame only just short of a consecutive frame,
+  // a few consecutive frames, and enough to wrap the sequence number several times
+  struct Link {
+    BlobModule source;
+    BlobModule sink;
+    CANIsoTpChannel tx;
+    CANIsoTpChannel rx;
+    Link(uint32_t data_id, uint32_t size):
+      source(0, size), sink(0, size),
+      tx(&source, CANIsoTpChannel::Direction::Tx, data_id, data_id + 1),
+      rx(&sink, CANIsoTpChannel::Direction::Rx, data_id, data_id + 1)
+    {}
+  };
+  Link links[] = {{0x600, 5}, {0x610, 8}, {0x620, 20}, {0x630, 200}};
+
+  // 3 bytes like Steering, FF_DL 3 to 7 used to leave received_ past expected_
+  BlobModule small(0, 3);
+  CANIsoTpChannel small_rx(&small, CANIsoTpChannel::Direction::Rx, 0x700, 0x701);
+  BlobModule medium(0, 10);
+  CANIsoTpChannel medium_rx(&medium, CANIsoTpChannel::Direction::Rx, 0x710, 0x711);
+
+  void TestLoopback()
+  {
+    for (uint8_t round = 0; round < 3; ++round)
+    {
+      for (Link& link : links)
+      {
+        link.source.Fill(round * 31 + link.source.size_);
+        uint32_t frames = link.sink.frames_;
+        CHECK(sender.Send(&link.tx));
+        CHECK(Pump(bus, [&]() { return link.sink.frames_ == frames + 1; }));
+        CHECK(link.sink.data_ == link.source.data_);
+      }
+    }
+    CHECK(Pump(bus, [&]() { return sender.GetStats().tx_messages == 12; }));
+    CHECK(sender.GetStats().tx_aborts == 0);
+    CHECK(receiver.GetStats().rx_messages == 12);
+    CHECK(receiver.GetStats().rx_aborts == 0);
+    // A queue that only takes a couple of frames at a time holds the sender back, nothing is lost
+    bus.SetQueueLimit(2);
+    links[3].source.Fill(99);
+    CHECK(sender.Send(&links[3].tx));
+    CHECK(Pump(bus, [&]() { return links[3].sink.frames_ == 4; }));
+    CHECK(links[3].sink.data_ == links[3].source.data_);
+    bus.SetQueueLimit(16);
+  }
+
+  void TestShortFirstFrame()
+  {
+    uint32_t messages = receiver.GetStats().rx_messages;
+    for (uint8_t len : {0, 1, 3, 5, 6, 7})
+    {
+      bus.ClearSent();
+      Inject(bus, 0x700, {0x10, len, 1, 2, 3, 4, 5, 6});
+      CHECK(LastFlowControl(bus, 0x701) == FC_OVERFLOW);
+      // Consecutive frames for the refused message go nowhere
+      for (uint8_t sn = 1; sn < 40; ++sn)
+        Inject(bus, 0x700, {static_cast<uint8_t>(0x20 | (sn & 0x0F)), 1, 2, 3, 4, 5, 6, 7});
+      CHECK(small.frames_ == 0);
+    }
+    CHECK(receiver.GetStats().rx_messages == messages);
+
+    // The shortest valid first frame carries 8 bytes for a 3 byte module
+    Inject(bus, 0x700, {0x10, 8, 0xA1, 0xA2, 0xA3, 4, 5, 6});
+    CHECK(LastFlowControl(bus, 0x701) == FC_CTS);
+    Inject(bus, 0x700, {0x21, 7, 8, 9, 9, 9, 9, 9});
+    CHECK(small.frames_ == 1);
+    CHECK(small.data_ == std::vector<uint8_t>({0xA1, 0xA2, 0xA3}));
+    // Anything after the message completed is ignored
+    Inject(bus, 0x700, {0x22, 1, 2, 3, 4, 5, 6, 7});
+    CHECK(small.frames_ == 1);
+    // A single frame is how a 3 byte message should arrive
+    Inject(bus, 0x700, {0x03, 0xB1, 0xB2, 0xB3});
+    CHECK(small.frames_ == 2);
+    CHECK(small.data_ == std::vector<uint8_t>({0xB1, 0xB2, 0xB3}));
+  }
+
+  void TestMalformed()
+  {
+    uint32_t aborts = receiver.GetStats().rx_aborts;
+    // Longer than any module can be, and shorter than this module
+    Inject(bus, 0x710, {0x11, 0x2C, 1, 2, 3, 4, 5, 6});
+    CHECK(LastFlowControl(bus, 0x711) == FC_OVERFLOW);
+    Inject(bus, 0x710, {0x10, 9, 1, 2, 3, 4, 5, 6});
+    CHECK(LastFlowControl(bus, 0x711) == FC_OVERFLOW);
+
+    // Sequence number skipped
+    Inject(bus, 0x710, {0x10, 10, 1, 2, 3, 4, 5, 6});
+    CHECK(LastFlowControl(bus, 0x711) == FC_CTS);
+    Inject(bus, 0x710, {0x22, 7, 8, 9, 10});
+    CHECK(receiver.GetStats().rx_aborts == aborts + 1);
+    Inject(bus, 0x710, {0x21, 7, 8, 9, 10});
+    CHECK(medium.frames_ == 0);
+
+    // A new first frame restarts a message in progress
+    Inject(bus, 0x710, {0x10, 10, 9, 9, 9, 9, 9, 9});
+    Inject(bus, 0x710, {0x10, 10, 1, 2, 3, 4, 5, 6});
+    CHECK(receiver.GetStats().rx_aborts == aborts + 2);
+    // The last consecutive frame has more bytes than the message has left
+    Inject(bus, 0x710, {0x21, 7, 8, 9, 10, 0xEE, 0xEE, 0xEE});
+    CHECK(medium.frames_ == 1);
+    CHECK(medium.data_ == std::vector<uint8_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    Inject(bus, 0x710, {0x22, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE});
+    CHECK(medium.frames_ == 1);
+
+    // Single frames that are empty, too long for a frame or too short for the module
+    Inject(bus, 0x710, {0x00});
+    Inject(bus, 0x710, {0x08, 1, 2, 3, 4, 5, 6, 7});
+    Inject(bus, 0x710, {0x07, 1, 2, 3, 4, 5, 6, 7});
+    CHECK(medium.frames_ == 1);
+    // Unknown frame types are ignored
+    Inject(bus, 0x710, {0x40, 1, 2, 3});
+    CHECK(medium.frames_ == 1);
+  }
+
+  // The test plays the receiver so it can hand out any block size and separation time
+  BlobModule timed(0, 200);
+  CANIsoTpChannel timed_tx(&timed, CANIsoTpChannel::Direction::Tx, 0x720, 0x721);
+
+  // The first frame carries 6 bytes, every consecutive frame 7
+  const uint32_t TIMED_CONSECUTIVE = (200 - 6 + 7 - 1) / 7;
+
+  struct Timing {
+    double transfer_us;                            // Send to the last consecutive frame queued
+    double bytes_per_s;
+    uint32_t flow_controls;
+  };
+
+  Timing TimeTransfers(uint8_t block_size, uint8_t stmin, uint32_t transfers)
+  {
+    using Clock = std::chrono::steady_clock;
+    Timing timing = {};
+    Clock::duration total = Clock::duration::zero();
+    for (uint32_t t = 0; t < transfers; ++t)
+    {
+      bus.ClearSent();
+      uint32_t seen = 0;
+      uint32_t frames = 0;
+      uint32_t messages = sender.GetStats().tx_messages;
+      auto start = Clock::now();
+      CHECK(sender.Send(&timed_tx));
+      bool ok = Pump(bus, [&]() {
+        std::vector<CANFrame> sent = bus.GetSent();
+        for (; seen < sent.size(); ++seen)
+        {
+          if(sent[seen].id != 0x720)
+            continue;
+          uint8_t pci = sent[seen].data[0] & 0xF0;
+          if(pci == 0x20)
+            ++frames;
+          if(pci == 0x10 || (pci == 0x20 && block_size != 0 && frames % block_size == 0 && frames < TIMED_CONSECUTIVE))
+          {
+            Inject(bus, 0x721, {FC_CTS, block_size, stmin});
+            ++timing.flow_controls;
+          }
+        }
+        return frames == TIMED_CONSECUTIVE;
+      });
+      total += Clock::now() - start;
+      CHECK(ok);
+      CHECK(Pump(bus, [&]() { return sender.GetStats().tx_messages == messages + 1; }));
+    }
+    double seconds = std::chrono::duration<double>(total).count();
+    timing.transfer_us = seconds * 1e6 / transfers;
+    timing.bytes_per_s = timed.size_ * transfers / seconds;
+    timing.flow_controls /= transfers;
+    return timing;
+  }
+
+  // Throughput and latency of a 200 byte module. Not a pass/fail check beyond the protocol,
+  // timings on the host only hint at the target, but the separation time is a lower bound.
+  void BenchmarkTransfers()
+  {
+    struct Setting {
+      uint8_t block_size;
+      uint8_t stmin;
+    };
+    for (Setting setting : {Setting{0, 0}, Setting{4, 0}, Setting{0, 1}, Setting{8, 2}})
+    {
+      Timing timing = TimeTransfers(setting.block_size, setting.stmin, setting.stmin == 0 ? 20 : 3);
+      uint32_t blocks = setting.block_size == 0 ? 1 : (TIMED_CONSECUTIVE + setting.block_size - 1) / setting.block_size;
+      CHECK(timing.flow_controls == blocks);
+      CHECK(timing.transfer_us >= (TIMED_CONSECUTIVE - 1) * setting.stmin * 1000.0);
+      printf("CANIsoTpTest: %u bytes BS %u STmin %u ms, %.0f us per transfer, %.0f bytes/s\n",
+             static_cast<unsigned>(timed.size_), setting.block_size, setting.stmin, timing.transfer_us, timing.bytes_per_s);
+    }
+  }
+}
+
+int main()
+{
+  for (Link& link : links)
+  {
+    CHECK(sender.AddChannel(&link.tx));
+    CHECK(receiver.AddChannel(&link.rx));
+  }
+  CHECK(receiver.AddChannel(&small_rx));
+  CHECK(receiver.AddChannel(&medium_rx));
+  CHECK(sender.AddChannel(&timed_tx));
+  sender.Init();
+  receiver.Init();
+  TestLoopback();
+  TestShortFirstFrame();
+  TestMalformed();
+  BenchmarkTransfers();
+  return Test::Finish("CANIsoTpTest");
+}
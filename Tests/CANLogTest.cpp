@@ -0,0 +1,298 @@
+/*
+ * CANLogTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Records frames with CANRecorder and reads them back with CANLogReader, covering
+ *               negative and large tick deltas, dictionary overflow, restarted sessions, truncated
+ *               and corrupt logs. Then replays a log through CANReplay into a DataModule.
+ */
+
+#include <CANLog.hpp>
+#include <CANRecorder.hpp>
+#include <CANReplay.hpp>
+#include "Test.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace SolarGators::Drivers;
+using SolarGators::DataModules::DataModule;
+
+namespace {
+  struct Recorded {
+    CANFrame frame;
+    CANLog::Direction direction;
+  };
+
+  CANFrame MakeFrame(uint32_t id, bool is_ext, uint32_t tick, uint8_t dlc, bool is_rtr = false)
+  {
+    CANFrame frame = {};
+    frame.id = id;
+    frame.is_ext = is_ext;
+    frame.is_rtr = is_rtr;
+    frame.tick = tick;
+    frame.dlc = dlc;
+    for (uint8_t i = 0; i < dlc; ++i)
+      frame.data[i] = static_cast<uint8_t>(id * 7 + tick + i);
+    return frame;
+  }
+
+  std::vector<uint8_t> Drain(CANRecorder& recorder)
+  {
+    std::vector<uint8_t> log;
+    recorder.Flush([&](const uint8_t* data, size_t len) {
+      log.insert(log.end(), data, data + len);
+      return len;
+    });
+    return log;
+  }
+
+  bool Same(const CANFrame& a, const CANFrame& b)
+  {
+    if(a.id != b.id || a.is_ext != b.is_ext || a.is_rtr != b.is_rtr || a.tick != b.tick || a.dlc != b.dlc)
+      return false;
+    for (uint8_t i = 0; !a.is_rtr && i < a.Length(); ++i)
+    {
+      if(a.data[i] != b.data[i])
+        return false;
+    }
+    return true;
+  }
+
+  // Reads the whole log, returns the record end offsets
+  std::vector<size_t> CheckLog(const std::vector<uint8_t>& log, const std::vector<Recorded>& expected)
+  {
+    std::vector<size_t> boundaries;
+    CANLogReader reader(log.data(), log.size());
+    CANFrame frame;
+    CANLog::Direction direction;
+    for (const Recorded& record : expected)
+    {
+      if(!CHECK(reader.Next(frame, direction) == CANLogReader::Status::Frame))
+        return boundaries;
+      CHECK(Same(frame, record.frame));
+      CHECK(direction == record.direction);
+      boundaries.push_back(reader.GetOffset());
+    }
+    CHECK(reader.Next(frame, direction) == CANLogReader::Status::End);
+    CHECK(reader.GetOffset() == log.size());
+    return boundaries;
+  }
+
+  // Ticks jumping back and far forward, both ID kinds, remote frames and every classic length,
+  // with more IDs than the dictionary holds
+  void TestRoundTrip()
+  {
+    static uint8_t buffer[8192];
+    CANRecorder recorder(buffer, sizeof(buffer));
+    CHECK(recorder.Start());
+    uint32_t start = osKernelGetTickCount();
+    std::vector<Recorded> expected;
+    srand(7);
+    uint32_t tick = start;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+      bool is_ext = i % 3 == 0;
+      // 80 distinct IDs, reused so most records go through the dictionary
+      uint32_t id = is_ext ? 0x18FF0000 | (i % 80) << 4 : 0x100 + i % 80;
+      if(i % 50 == 49)
+        tick += 0x40000000;
+      else
+        tick += rand() % 40 - 10;
+      Recorded record = {MakeFrame(id, is_ext, tick, i % 9, i % 17 == 0),
+                         i % 4 == 0 ? CANLog::Direction::Tx : CANLog::Direction::Rx};
+      CHECK(recorder.Record(record.frame, record.direction));
+      expected.push_back(record);
+    }
+    CHECK(recorder.GetRecordCount() == expected.size());
+    CHECK(recorder.GetDropCount() == 0);
+    std::vector<uint8_t> log = Drain(recorder);
+    CHECK(recorder.GetUsed() == 0);
+    std::vector<size_t> boundaries = CheckLog(log, expected);
+
+    // Cut anywhere: on a record boundary it is a clean end, anywhere else an error
+    for (size_t cut = CANLog::START_SIZE; cut < log.size(); ++cut)
+    {
+      CANLogReader reader(log.data(), cut);
+      CANFrame frame;
+      CANLog::Direction direction;
+      size_t frames = 0;
+      CANLogReader::Status status;
+      while((status = reader.Next(frame, direction)) == CANLogReader::Status::Frame)
+        ++frames;
+      bool boundary = cut == CANLog::START_SIZE;
+      for (size_t end : boundaries)
+        boundary = boundary || end == cut;
+      CHECK(status == (boundary ? CANLogReader::Status::End : CANLogReader::Status::Error));
+      if(status == CANLogReader::Status::Error)
+        continue;
+      CHECK(frames == 0 || boundaries[frames - 1] == cut);
+    }
+  }
+
+  // A second Start resets the dictionary, and a reader rewound or joining there keeps up
+  void TestRestart()
+  {
+    static uint8_t buffer[1024];
+    CANRecorder recorder(buffer, sizeof(buffer));
+    CHECK(recorder.Start());
+    uint32_t tick = osKernelGetTickCount();
+    std::vector<Recorded> expected;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+      expected.push_back({MakeFrame(0x200 + i % 2, false, tick + i, 8), CANLog::Direction::Rx});
+      CHECK(recorder.Record(expected.back().frame, CANLog::Direction::Rx));
+    }
+    size_t first_session = recorder.GetUsed();
+    CHECK(recorder.Start());
+    tick = osKernelGetTickCount();
+    std::vector<Recorded> second;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+      // The dictionary starts with a different ID at index 0
+      second.push_back({MakeFrame(0x201 - i % 2, false, tick + i, 2), CANLog::Direction::Rx});
+      CHECK(recorder.Record(second.back().frame, CANLog::Direction::Rx));
+    }
+    std::vector<uint8_t> log = Drain(recorder);
+    expected.insert(expected.end(), second.begin(), second.end());
+    CheckLog(log, expected);
+    std::vector<uint8_t> tail(log.begin() + first_session, log.end());
+    CheckLog(tail, second);
+
+    CANLogReader reader(log.data(), log.size());
+    CANFrame frame;
+    CANLog::Direction direction;
+    while(reader.Next(frame, direction) == CANLogReader::Status::Frame)
+      ;
+    reader.Rewind();
+    CHECK(reader.Next(frame, direction) == CANLogReader::Status::Frame);
+    CHECK(Same(frame, expected[0].frame));
+
+    // A full ring drops whole records and the log still reads back
+    recorder.Stop();
+    CHECK(!recorder.Record(expected[0].frame, CANLog::Direction::Rx));
+    CHECK(recorder.Start());
+    uint32_t recorded = 0;
+    while(recorder.Record(MakeFrame(0x300, false, tick, 8), CANLog::Direction::Rx))
+      ++recorded;
+    CHECK(recorder.GetDropCount() == 1);
+    log = Drain(recorder);
+    CHECK(CheckLog(log, std::vector<Recorded>(recorded, {MakeFrame(0x300, false, tick, 8),
+                                                         CANLog::Direction::Rx})).size() == recorded);
+  }
+
+  CANLogReader::Status ReadAll(const std::vector<uint8_t>& log)
+  {
+    CANLogReader reader(log.data(), log.size());
+    CANFrame frame;
+    CANLog::Direction direction;
+    CANLogReader::Status status;
+    while((status = reader.Next(frame, direction)) == CANLogReader::Status::Frame)
+      ;
+    return status;
+  }
+
+  void TestCorrupt()
+  {
+    const std::vector<uint8_t> start = {CANLog::START, CANLog::VERSION, 0, 0, 0, 0};
+    // A std frame with a new ID and two data bytes
+    const std::vector<uint8_t> frame = {CANLog::NEW_ID_FLAG | 2, 0x02, 0x23, 0x01, 0, 0, 0xAA, 0xBB};
+    std::vector<uint8_t> log = start;
+    log.insert(log.end(), frame.begin(), frame.end());
+    CHECK(ReadAll(log) == CANLogReader::Status::End);
+    CHECK(ReadAll({}) == CANLogReader::Status::End);
+    // Frames before any session start
+    CHECK(ReadAll(frame) == CANLogReader::Status::Error);
+    // Unknown version and unknown control record
+    log[1] = CANLog::VERSION + 1;
+    CHECK(ReadAll(log) == CANLogReader::Status::Error);
+    log[1] = CANLog::VERSION;
+    log[0] = CANLog::START | 1;
+    CHECK(ReadAll(log) == CANLogReader::Status::Error);
+    log[0] = CANLog::START;
+    // Dictionary index past the IDs seen so far
+    std::vector<uint8_t> indexed = log;
+    indexed.insert(indexed.end(), {0x00, 0x00, 0x01});
+    CHECK(ReadAll(indexed) == CANLogReader::Status::Error);
+    indexed.back() = 0x00;
+    CHECK(ReadAll(indexed) == CANLogReader::Status::End);
+    // A varint that never ends
+    std::vector<uint8_t> varint = start;
+    varint.insert(varint.end(), {CANLog::NEW_ID_FLAG, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 0, 0, 0});
+    CHECK(ReadAll(varint) == CANLogReader::Status::Error);
+#ifndef SOLARGATORS_CAN_FD
+    // An FD length on a classic build
+    std::vector<uint8_t> fd = start;
+    fd.insert(fd.end(), {CANLog::NEW_ID_FLAG | 9, 0x00, 0x23, 0x01, 0, 0});
+    fd.insert(fd.end(), 12, 0);
+    CHECK(ReadAll(fd) == CANLogReader::Status::Error);
+#endif
+  }
+
+  class CountModule final : public DataModule {
+  public:
+    CountModule(uint32_t can_id):
+      DataModule(can_id, 0, 2),
+      value_(0), frames_(0)
+    {}
+    void ToByteArray(uint8_t* buff) const
+    {
+      buff[0] = value_;
+      buff[1] = value_ >> 8;
+    }
+    void FromByteArray(uint8_t* buff)
+    {
+      value_ = buff[0] | (buff[1] << 8);
+      ++frames_;
+    }
+    uint16_t value_;
+    uint32_t frames_;
+  };
+
+  // The replayer decodes a log on the host with the same modules the car runs
+  void TestReplay()
+  {
+    static uint8_t buffer[1024];
+    CANRecorder recorder(buffer, sizeof(buffer));
+    CHECK(recorder.Start());
+    uint32_t tick = osKernelGetTickCount();
+    for (uint16_t i = 1; i <= 20; ++i)
+    {
+      CANFrame frame = MakeFrame(i % 2 ? 0x400 : 0x401, false, tick + i, 2);
+      frame.data[0] = i;
+      frame.data[1] = 0;
+      recorder.Record(frame, i % 5 == 0 ? CANLog::Direction::Tx : CANLog::Direction::Rx);
+    }
+    recorder.Record(MakeFrame(0x400, false, tick + 21, 0, true), CANLog::Direction::Rx);
+    std::vector<uint8_t> log = Drain(recorder);
+    CountModule odd(0x400);
+    CANReplay replay;
+    CHECK(replay.AddModule(&odd));
+    CANLogReader reader(log.data(), log.size());
+    CANReplay::Stats stats = replay.Run(reader, CANReplay::UNTHROTTLED);
+    CHECK(!stats.error);
+    CHECK(stats.frames == 21);
+    CHECK(stats.decoded == 8);                     // Odd frames not sent by this node
+    CHECK(stats.unknown == 9);                     // Even rx frames and the remote frame
+    CHECK(odd.frames_ == 8);
+    CHECK(odd.value_ == 19);
+    reader.Rewind();
+    stats = replay.Run(reader, CANReplay::UNTHROTTLED, true);
+    CHECK(stats.decoded == 10);
+    CHECK(odd.frames_ == 18);
+    // Real time replay waits out the 21 recorded ticks
+    reader.Rewind();
+    stats = replay.Run(reader, 1);
+    CHECK(stats.ticks >= 20);
+  }
+}
+
+int main()
+{
+  TestRoundTrip();
+  TestRestart();
+  TestCorrupt();
+  TestReplay();
+  return Test::Finish("CANLogTest");
+}
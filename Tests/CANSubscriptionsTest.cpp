@@ -0,0 +1,182 @@
+/*
+ * CANSubscriptionsTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Feeds frames to CANSubscriptions with hand picked ticks and checks which ones
+ *               notify, which are masked out and how changes inside a coalescing window fold
+ *               into one notification at the end of it.
+ */
+
+#include <CANSubscriptions.hpp>
+#include "Test.hpp"
+
+#include <initializer_list>
+
+using SolarGators::Drivers::CANFrame;
+using SolarGators::Drivers::CANSubscriptions;
+
+namespace {
+  CANFrame Frame(std::initializer_list<uint8_t> bytes)
+  {
+    CANFrame frame = {};
+    frame.id = 0x123;
+    for (uint8_t byte : bytes)
+      frame.data[frame.dlc++] = byte;
+    return frame;
+  }
+
+  // True if the flag was set since the last call
+  bool Notified(osEventFlagsId_t event, uint32_t flag = 0x1)
+  {
+    return osEventFlagsWait(event, flag, osFlagsWaitAny, 0) == flag;
+  }
+
+  // Only bits inside the mask count as a change, the first frame always does
+  void TestMask()
+  {
+    CANSubscriptions subscriptions;
+    osEventFlagsId_t event = osEventFlagsNew(nullptr);
+    uint32_t now = osKernelGetTickCount();
+    uint8_t head = subscriptions.Add(CANSubscriptions::NONE, {nullptr, event, 0x1}, CANSubscriptions::SignalMask(8, 12), 0);
+    CHECK(head != CANSubscriptions::NONE);
+    subscriptions.OnFrame(head, Frame({1, 2, 3, 4}), now);
+    CHECK(Notified(event));
+    // Byte 0 and the top nibble of byte 2 are outside the mask
+    subscriptions.OnFrame(head, Frame({9, 2, 0x33, 4}), now);
+    subscriptions.OnFrame(head, Frame({9, 2, 0xF3, 7}), now);
+    CHECK(!Notified(event));
+    // Lowest and highest bit of the signal
+    subscriptions.OnFrame(head, Frame({9, 3, 0xF3, 7}), now);
+    CHECK(Notified(event));
+    subscriptions.OnFrame(head, Frame({9, 3, 0xFB, 7}), now);
+    CHECK(Notified(event));
+    // A different length is a different frame
+    subscriptions.OnFrame(head, Frame({9, 3, 0xFB}), now);
+    CHECK(Notified(event));
+    CHECK(subscriptions.GetNotifyCount() == 4);
+    CHECK(subscriptions.GetCoalescedCount() == 0);
+    CHECK(subscriptions.Poll(now) == CANSubscriptions::NO_DEADLINE);
+  }
+
+  // A change inside the window is held until the window ends, later ones fold into it
+  void TestCoalescing()
+  {
+    constexpr uint32_t WINDOW = 10;
+    CANSubscriptions subscriptions;
+    osEventFlagsId_t event = osEventFlagsNew(nullptr);
+    uint32_t t0 = osKernelGetTickCount();
+    uint8_t head = subscriptions.Add(CANSubscriptions::NONE, {nullptr, event, 0x1}, CANSubscriptions::ALL_SIGNALS, WINDOW);
+    subscriptions.OnFrame(head, Frame({1}), t0);
+    CHECK(Notified(event));
+    subscriptions.OnFrame(head, Frame({2}), t0 + 2);
+    CHECK(!Notified(event));
+    CHECK(subscriptions.Poll(t0 + 3) == WINDOW - 3);
+    subscriptions.OnFrame(head, Frame({3}), t0 + 5);
+    subscriptions.OnFrame(head, Frame({4}), t0 + 6);
+    // Unchanged frames don't count as coalesced
+    subscriptions.OnFrame(head, Frame({4}), t0 + 7);
+    CHECK(subscriptions.GetCoalescedCount() == 2);
+    CHECK(subscriptions.Poll(t0 + 9) == 1);
+    CHECK(!Notified(event));
+    CHECK(subscriptions.Poll(t0 + WINDOW) == CANSubscriptions::NO_DEADLINE);
+    CHECK(Notified(event));
+    CHECK(subscriptions.GetNotifyCount() == 2);
+
+    // The window runs from the coalesced notification
+    subscriptions.OnFrame(head, Frame({5}), t0 + 12);
+    CHECK(!Notified(event));
+    CHECK(subscriptions.Poll(t0 + 12) == 8);
+    CHECK(subscriptions.Poll(t0 + 2 * WINDOW) == CANSubscriptions::NO_DEADLINE);
+    CHECK(Notified(event));
+    // A change after a quiet window goes straight out
+    subscriptions.OnFrame(head, Frame({6}), t0 + 35);
+    CHECK(Notified(event));
+    // A held change goes out with the next changed frame past the window, Poll doesn't have to run first
+    subscriptions.OnFrame(head, Frame({7}), t0 + 40);
+    subscriptions.OnFrame(head, Frame({8}), t0 + 46);
+    CHECK(Notified(event));
+    CHECK(subscriptions.Poll(t0 + 46) == CANSubscriptions::NO_DEADLINE);
+    CHECK(subscriptions.GetNotifyCount() == 5);
+  }
+
+  // Several subscribers on one module each get their own mask and window
+  void TestChain()
+  {
+    CANSubscriptions subscriptions;
+    osEventFlagsId_t fast = osEventFlagsNew(nullptr);
+    osEventFlagsId_t slow = osEventFlagsNew(nullptr);
+    osEventFlagsId_t byte1 = osEventFlagsNew(nullptr);
+    uint32_t t0 = osKernelGetTickCount();
+    uint8_t head = CANSubscriptions::NONE;
+    head = subscriptions.Add(head, {nullptr, fast, 0x1}, CANSubscriptions::ALL_SIGNALS, 0);
+    head = subscriptions.Add(head, {nullptr, slow, 0x2}, CANSubscriptions::ALL_SIGNALS, 50);
+    head = subscriptions.Add(head, {nullptr, byte1, 0x4}, CANSubscriptions::SignalMask(8, 8), 0);
+    subscriptions.OnFrame(head, Frame({1, 1}), t0);
+    CHECK(Notified(fast) && Notified(slow, 0x2) && Notified(byte1, 0x4));
+    subscriptions.OnFrame(head, Frame({2, 1}), t0 + 1);
+    CHECK(Notified(fast) && !Notified(slow, 0x2) && !Notified(byte1, 0x4));
+    CHECK(subscriptions.Poll(t0 + 1) == 49);
+    // Removing the pending subscriber drops its notification
+    head = subscriptions.Remove(head, slow);
+    CHECK(subscriptions.Poll(t0 + 1) == CANSubscriptions::NO_DEADLINE);
+    subscriptions.OnFrame(head, Frame({2, 2}), t0 + 2);
+    CHECK(Notified(fast) && Notified(byte1, 0x4));
+    CHECK(!Notified(slow, 0x2));
+    subscriptions.RemoveAll(head);
+    CHECK(subscriptions.Poll(t0 + 100) == CANSubscriptions::NO_DEADLINE);
+  }
+
+  // Thread targets get thread flags
+  void TestThreadTarget()
+  {
+    CANSubscriptions subscriptions;
+    osThreadId_t self = osThreadGetId();
+    osThreadFlagsClear(0x8);
+    uint8_t head = subscriptions.Add(CANSubscriptions::NONE, {self, nullptr, 0x8}, CANSubscriptions::ALL_SIGNALS, 0);
+    subscriptions.OnFrame(head, Frame({1}), osKernelGetTickCount());
+    CHECK(osThreadFlagsWait(0x8, osFlagsWaitAny, 0) == 0x8);
+    head = subscriptions.Remove(head, self);
+    CHECK(head == CANSubscriptions::NONE);
+  }
+
+  // Removed and retired chains go back to the pool
+  void TestPool()
+  {
+    CANSubscriptions subscriptions;
+    osEventFlagsId_t event = osEventFlagsNew(nullptr);
+    osEventFlagsId_t other = osEventFlagsNew(nullptr);
+    for (uint8_t round = 0; round < 3; ++round)
+    {
+      uint8_t head = CANSubscriptions::NONE;
+      for (uint8_t i = 0; i < CANSubscriptions::MAX_SUBSCRIPTIONS; ++i)
+      {
+        uint8_t index = subscriptions.Add(head, {nullptr, i % 2 ? event : other, 0x1}, CANSubscriptions::ALL_SIGNALS, 5);
+        CHECK(index != CANSubscriptions::NONE);
+        head = index;
+      }
+      CHECK(subscriptions.Add(head, {nullptr, event, 0x1}, CANSubscriptions::ALL_SIGNALS, 0) == CANSubscriptions::NONE);
+      // Half the chain goes, the other half is retired with changes pending
+      head = subscriptions.Remove(head, event);
+      uint8_t single = subscriptions.Add(CANSubscriptions::NONE, {nullptr, event, 0x1}, CANSubscriptions::ALL_SIGNALS, 0);
+      CHECK(single != CANSubscriptions::NONE);
+      uint32_t now = osKernelGetTickCount();
+      subscriptions.OnFrame(head, Frame({round}), now);
+      subscriptions.OnFrame(head, Frame({static_cast<uint8_t>(round + 1)}), now + 1);
+      CHECK(subscriptions.Poll(now + 1) == 4);
+      subscriptions.RemoveAll(head);
+      CHECK(subscriptions.Poll(now + 1) == CANSubscriptions::NO_DEADLINE);
+      subscriptions.RemoveAll(single);
+    }
+  }
+}
+
+int main()
+{
+  TestMask();
+  TestCoalescing();
+  TestChain();
+  TestThreadTarget();
+  TestPool();
+  return Test::Finish("CANSubscriptionsTest");
+}
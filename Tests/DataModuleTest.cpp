@@ -0,0 +1,519 @@
+/*
+ * DataModuleTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: One writer decoding frames while reader threads copy the module out through Read
+ *               and Snapshot. Every copy must come from a single frame and frames never go
+ *               backwards. Also checks lazy modules serialise the last frame, runs PowerSignal
+ *               getters against a recomputing Update task, checks the derived power signals
+ *               against hand computed values and times float getters against the integer ones.
+ */
+
+#include <DataModule.hpp>
+#include <DerivedSignals.hpp>
+#include <Mitsuba.hpp>
+#include <OrionBMS.hpp>
+#include <Proton1.hpp>
+#include "Test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using SolarGators::DataModules::DataModule;
+using SolarGators::DataModules::DerivedSignalEngine;
+using SolarGators::DataModules::MotorPower;
+using SolarGators::DataModules::PackPower;
+using SolarGators::DataModules::PowerSignal;
+using SolarGators::DataModules::SolarPower;
+using SolarGators::DataModules::MitsubaRx0;
+using SolarGators::DataModules::MitsubaRx1;
+using SolarGators::DataModules::OrionBMSRx0;
+using SolarGators::DataModules::OrionBMSRx2;
+using SolarGators::DataModules::OrionBMSRx3;
+using SolarGators::DataModules::Proton1;
+namespace Units = SolarGators::DataModules::Units;
+
+namespace {
+  // Stretches the time between stores and loads, the way preemption would on target
+  void Spin(uint32_t count)
+  {
+    for (volatile uint32_t i = 0; i < count; i = i + 1)
+      ;
+  }
+
+  // Every member is decoded from the same 32 bit counter, with separate stores so a reader
+  // that lands in the middle of a decode sees them disagree
+  class CounterModule final : public DataModule {
+  public:
+    CounterModule():
+      DataModule(0x100, 0, 8),
+      low_(0), high_(0), inverse_(~0u), wide_(0)
+    {}
+    void ToByteArray(uint8_t* buff) const
+    {
+      for (uint8_t i = 0; i < 4; ++i)
+      {
+        buff[i] = low_ >> (8 * i);
+        buff[4 + i] = inverse_ >> (8 * i);
+      }
+    }
+    void FromByteArray(uint8_t* buff)
+    {
+      uint32_t value = buff[0] | (buff[1] << 8) | (buff[2] << 16) | (static_cast<uint32_t>(buff[3]) << 24);
+      low_ = value;
+      Spin(20);
+      wide_ = static_cast<uint64_t>(value) << 32 | value;
+      inverse_ = ~value;
+      high_ = value;
+    }
+    uint32_t GetValue() const { Sync(); return low_; }
+    volatile uint32_t low_;
+    volatile uint32_t high_;
+    volatile uint32_t inverse_;
+    volatile uint64_t wide_;
+  };
+
+  void Encode(uint32_t value, uint8_t* buff)
+  {
+    for (uint8_t i = 0; i < 8; ++i)
+      buff[i] = (i < 4 ? value : ~value) >> (8 * (i % 4));
+  }
+
+  void TestSeqlock()
+  {
+    constexpr uint32_t FRAMES = 1000000;
+    constexpr uint8_t READERS = 3;
+    CounterModule module;
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+    std::atomic<uint32_t> reads(0);
+    std::vector<std::thread> readers;
+    for (uint8_t r = 0; r < READERS; ++r)
+    {
+      readers.emplace_back([&, r]() {
+        uint32_t last = 0;
+        uint32_t count = 0;
+        while(!done)
+        {
+          uint32_t low;
+          uint32_t high;
+          uint32_t inverse;
+          uint64_t wide;
+          if(r == 0)
+          {
+            // Snapshot only sees the serialised form
+            uint8_t buff[8];
+            module.Snapshot(buff);
+            low = high = buff[0] | (buff[1] << 8) | (buff[2] << 16) | (static_cast<uint32_t>(buff[3]) << 24);
+            inverse = buff[4] | (buff[5] << 8) | (buff[6] << 16) | (static_cast<uint32_t>(buff[7]) << 24);
+            wide = static_cast<uint64_t>(low) << 32 | low;
+          }
+          else
+          {
+            module.Read([&]() {
+              low = module.low_;
+              Spin(20);
+              wide = module.wide_;
+              inverse = module.inverse_;
+              high = module.high_;
+            });
+          }
+          if(low != high || inverse != ~low || wide != (static_cast<uint64_t>(low) << 32 | low))
+            ++torn;
+          if(low < last)
+            ++backwards;
+          last = low;
+          ++count;
+        }
+        reads += count;
+      });
+    }
+    uint8_t buff[8];
+    for (uint32_t i = 1; i <= FRAMES; ++i)
+    {
+      Encode(i, buff);
+      module.Receive(buff, i);
+    }
+    done = true;
+    for (std::thread& reader : readers)
+      reader.join();
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(reads > 0);
+    CHECK(module.GetSequence() == FRAMES);
+    CHECK(module.GetRxTick() == FRAMES);
+    CHECK(module.GetValue() == FRAMES);
+  }
+
+  // In lazy mode the first getter after a frame decodes it, from whichever task calls first
+  void TestLazy()
+  {
+    constexpr uint32_t FRAMES = 200000;
+    CounterModule module;
+    CHECK(module.SetLazy(true));
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> backwards(0);
+    std::thread reader([&]() {
+      uint32_t last = 0;
+      while(!done)
+      {
+        uint32_t value = module.GetValue();
+        if(value < last)
+          ++backwards;
+        last = value;
+      }
+    });
+    uint8_t buff[8];
+    for (uint32_t i = 1; i <= FRAMES; ++i)
+    {
+      Encode(i, buff);
+      module.Receive(buff, i);
+    }
+    done = true;
+    reader.join();
+    CHECK(backwards == 0);
+    CHECK(module.GetValue() == FRAMES);
+    CHECK(module.low_ == FRAMES && module.high_ == FRAMES && module.inverse_ == ~FRAMES);
+    uint8_t snapshot[8];
+    module.Snapshot(snapshot);
+    CHECK(memcmp(snapshot, buff, sizeof(buff)) == 0);
+  }
+
+  // A lazy module serialised straight after a frame, before any getter ran, has to encode
+  // that frame. Compared against the same module decoding eagerly.
+  void CheckLazyEncode(DataModule& eager, DataModule& lazy)
+  {
+    CHECK(lazy.SetLazy(true));
+    for (uint8_t round = 1; round <= 3; ++round)
+    {
+      uint8_t payload[8];
+      for (uint8_t i = 0; i < 8; ++i)
+        payload[i] = static_cast<uint8_t>(round * 59 + i * 23);
+      eager.Receive(payload, round);
+      uint8_t expected[8] = {};
+      eager.ToByteArray(expected);
+      lazy.Receive(payload, round);
+      uint8_t encoded[8] = {};
+      lazy.ToByteArray(encoded);
+      CHECK(memcmp(encoded, expected, eager.size_) == 0);
+    }
+  }
+
+  void TestLazyEncode()
+  {
+    MitsubaRx0 mitsuba_eager(0x08F89540, 0);
+    MitsubaRx0 mitsuba_lazy(0x08F89540, 0);
+    CheckLazyEncode(mitsuba_eager, mitsuba_lazy);
+    OrionBMSRx0 orion_eager(0x6B0, 0);
+    OrionBMSRx0 orion_lazy(0x6B0, 0);
+    CheckLazyEncode(orion_eager, orion_lazy);
+    Proton1 proton_eager(0x600);
+    Proton1 proton_lazy(0x600);
+    CheckLazyEncode(proton_eager, proton_lazy);
+  }
+
+  // Power from a counter module's value
+  class CounterPower final : public PowerSignal {
+  public:
+    CounterPower(const CounterModule& input):
+      PowerSignal(0x200, 0),
+      input_(input)
+    {
+      AddInput(input_);
+    }
+  protected:
+    Units::Deciwatts ComputePower() const
+    {
+      uint32_t value;
+      input_.Read([&]() { value = input_.low_; });
+      return Units::Deciwatts(static_cast<int32_t>(value % 2 ? 36000 : 18000));
+    }
+  private:
+    const CounterModule& input_;
+  };
+
+  // Energy read on another task while Update recomputes only ever grows
+  void TestPowerSignal()
+  {
+    constexpr uint32_t FRAMES = 200000;
+    CounterModule input;
+    CounterPower power(input);
+    power.SetMaxGap(FRAMES);
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> errors(0);
+    std::thread reader([&]() {
+      int32_t last = 0;
+      while(!done)
+      {
+        int32_t energy = power.GetEnergyOut().Count();
+        int32_t watts = power.GetPower().Count();
+        if(energy < last || power.GetEnergyIn().Count() != 0 || (watts != 0 && watts != 18000 && watts != 36000))
+          ++errors;
+        last = energy;
+      }
+    });
+    uint8_t buff[8];
+    for (uint32_t i = 1; i <= FRAMES; ++i)
+    {
+      Encode(i, buff);
+      input.Receive(buff, i);
+      power.Update();
+    }
+    done = true;
+    reader.join();
+    CHECK(errors == 0);
+    CHECK(power.GetSequence() == FRAMES);
+    // 2.7kW on average over FRAMES - 1 ms
+    int64_t expected = 2700ll * (FRAMES - 1) / 3600;
+    CHECK(power.GetEnergyOut().Count() >= expected - 1 && power.GetEnergyOut().Count() <= expected);
+  }
+
+  // Pack sum voltage in centivolts and pack current in signed deciamps, both big endian
+  void SendPack(OrionBMSRx0& voltage, uint16_t centivolts, uint32_t tick)
+  {
+    uint8_t buff[OrionBMSRx0::Size] = {0, 0, 0, 0, 0, 0, static_cast<uint8_t>(centivolts >> 8),
+                                       static_cast<uint8_t>(centivolts)};
+    voltage.Receive(buff, tick);
+  }
+
+  void SendPack(OrionBMSRx2& current, int16_t deciamps, uint32_t tick)
+  {
+    uint8_t buff[OrionBMSRx2::Size] = {0, 0, 0, 0, static_cast<uint8_t>(deciamps >> 8),
+                                       static_cast<uint8_t>(deciamps), 0, 0};
+    current.Receive(buff, tick);
+  }
+
+  // Energy worked out by hand from the power samples, the host tick is 1ms
+  void TestPackPower()
+  {
+    OrionBMSRx0 voltage(0x6B0, 0);
+    OrionBMSRx2 current(0x6B2, 0);
+    PackPower power(voltage, current, 0x210, 0);
+    DerivedSignalEngine engine;
+    CHECK(engine.Add(power));
+    CHECK(engine.Update() == 0);
+
+    // 100.00V at 3.6A is 360W, both frames together are one recompute at the newest tick
+    SendPack(voltage, 10000, 999);
+    SendPack(current, 36, 1000);
+    CHECK(engine.Update() == 1);
+    CHECK(engine.Update() == 0);
+    CHECK(power.GetPower().Count() == 3600);
+    CHECK(power.GetRxTick() == 1000);
+    CHECK(power.GetEnergyOut().Count() == 0);
+    // 360W falling to -360W over 2s crosses zero half way, 180J each way is 50mWh
+    SendPack(current, -36, 3000);
+    CHECK(engine.Update() == 1);
+    CHECK(power.GetPower().Count() == -3600);
+    CHECK(power.GetEnergyOut().Count() == 50);
+    CHECK(power.GetEnergyIn().Count() == 50);
+    // A repeated frame still integrates, 360W in for 1s is 100mWh
+    SendPack(current, -36, 4000);
+    CHECK(engine.Update() == 1);
+    CHECK(power.GetEnergyIn().Count() == 150);
+    // 6s is past the default 2s gap, nothing is integrated across it
+    SendPack(current, 250, 10000);
+    CHECK(engine.Update() == 1);
+    CHECK(power.GetPower().Count() == 25000);
+    CHECK(power.GetEnergyOut().Count() == 50);
+    // 2500W for 1s is 694.4mWh, on top of the 50 the area adds up exactly to 744.4
+    SendPack(current, 250, 11000);
+    CHECK(engine.Update() == 1);
+    CHECK(power.GetEnergyOut().Count() == 744);
+    CHECK(power.GetEnergyIn().Count() == 150);
+
+    uint8_t buff[PowerSignal::Size];
+    power.ToByteArray(buff);
+    const uint8_t expected[PowerSignal::Size] = {0xA8, 0x61, 0, 0, 0xE8, 0x02, 0, 0, 0x96, 0, 0, 0};
+    CHECK(memcmp(buff, expected, sizeof(buff)) == 0);
+    // Nothing to decode, a received word doesn't overwrite the computed one
+    uint8_t zero[PowerSignal::Size] = {};
+    power.FromByteArray(zero);
+    power.ToByteArray(buff);
+    CHECK(memcmp(buff, expected, sizeof(buff)) == 0);
+    power.ResetEnergy();
+    CHECK(power.GetEnergyOut().Count() == 0 && power.GetEnergyIn().Count() == 0);
+    CHECK(power.GetPower().Count() == 25000);
+  }
+
+  // 100V at 5A plus 90V at 2.5A is 725W, the motor's 100V at 30A is 3kW either way
+  void TestSolarAndMotorPower()
+  {
+    Proton1 left(0x600);
+    Proton1 right(0x610);
+    uint8_t left_frame[Proton1::Mppt_Size] = {0x10, 0x27, 0xF4, 0x01, 0, 0, 0, 0};
+    uint8_t right_frame[Proton1::Mppt_Size] = {0x28, 0x23, 0xFA, 0x00, 0, 0, 0, 0};
+    left.Receive(left_frame, 5);
+    SolarPower solar(0x220, 0);
+    CHECK(solar.AddMppt(left));
+    CHECK(solar.AddMppt(right));
+    // Frames from before the MPPT was added don't count
+    CHECK(!solar.Update());
+    right.Receive(right_frame, 10);
+    CHECK(solar.Update());
+    CHECK(solar.GetPower().Count() == 7250);
+
+    MitsubaRx0 mitsuba(0x08F89540, 0);
+    MotorPower motor(mitsuba, 0x230, 0);
+    // 200 half volts in bits 0-9, 30A in bits 10-18, direction in bit 19
+    uint8_t driving[MitsubaRx0::Rx0_Size] = {0xC8, 0x78, 0x00, 0, 0, 0, 0, 0};
+    uint8_t charging[MitsubaRx0::Rx0_Size] = {0xC8, 0x78, 0x08, 0, 0, 0, 0, 0};
+    mitsuba.Receive(driving, 20);
+    CHECK(motor.Update());
+    CHECK(motor.GetPower().Count() == 30000);
+    mitsuba.Receive(charging, 520);
+    CHECK(motor.Update());
+    CHECK(motor.GetPower().Count() == -30000);
+    // Crossing at 250ms, 3kW falling to zero over it is 375J, 104.2mWh
+    CHECK(motor.GetEnergyOut().Count() == 104);
+    CHECK(motor.GetEnergyIn().Count() == 104);
+  }
+
+  struct RxTiming {
+    double frame_ns;                               // Rx task time per frame
+    double read_ns;                                // Average time a reader waits for a consistent copy
+    double read_max_ns;
+  };
+
+  // One writer decoding FRAMES while readers copy the module out back to back. The mutex scheme
+  // is the one the seqlock replaced: decode and copy both under the module's mutex.
+  template <typename Decode, typename Copy>
+  RxTiming TimeRxPath(uint8_t readers, Decode decode, Copy copy)
+  {
+    constexpr uint32_t FRAMES = 500000;
+    using Clock = std::chrono::steady_clock;
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> read_ns(0);
+    std::atomic<uint64_t> read_max_ns(0);
+    std::atomic<uint64_t> read_count(0);
+    std::vector<std::thread> threads;
+    for (uint8_t r = 0; r < readers; ++r)
+    {
+      threads.emplace_back([&]() {
+        uint64_t total = 0;
+        uint64_t longest = 0;
+        uint64_t count = 0;
+        uint8_t buff[8];
+        while(!done)
+        {
+          auto start = Clock::now();
+          copy(buff);
+          uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+          total += ns;
+          longest = ns > longest ? ns : longest;
+          ++count;
+        }
+        read_ns += total;
+        read_count += count;
+        uint64_t max = read_max_ns;
+        while(longest > max && !read_max_ns.compare_exchange_weak(max, longest))
+          ;
+      });
+    }
+    uint8_t buff[8];
+    auto start = Clock::now();
+    for (uint32_t i = 1; i <= FRAMES; ++i)
+    {
+      Encode(i, buff);
+      decode(buff, i);
+    }
+    auto end = Clock::now();
+    done = true;
+    for (std::thread& thread : threads)
+      thread.join();
+    RxTiming timing;
+    timing.frame_ns = std::chrono::duration<double, std::nano>(end - start).count() / FRAMES;
+    timing.read_ns = read_count != 0 ? static_cast<double>(read_ns) / read_count : 0;
+    timing.read_max_ns = read_max_ns;
+    return timing;
+  }
+
+  // Not a pass/fail check, timings on the host only hint at the target
+  void BenchmarkRxPath()
+  {
+    MitsubaRx0 module(0x08F89540, 0);
+    auto seqlock_decode = [&](uint8_t* buff, uint32_t tick) { module.Receive(buff, tick); };
+    auto seqlock_copy = [&](uint8_t* buff) { module.Snapshot(buff); };
+    auto mutex_decode = [&](uint8_t* buff, uint32_t) {
+      osMutexAcquire(module.mutex_id_, osWaitForever);
+      module.FromByteArray(buff);
+      osMutexRelease(module.mutex_id_);
+    };
+    auto mutex_copy = [&](uint8_t* buff) {
+      osMutexAcquire(module.mutex_id_, osWaitForever);
+      module.ToByteArray(buff);
+      osMutexRelease(module.mutex_id_);
+    };
+    for (uint8_t readers : {0, 2})
+    {
+      RxTiming seqlock = TimeRxPath(readers, seqlock_decode, seqlock_copy);
+      RxTiming mutex = TimeRxPath(readers, mutex_decode, mutex_copy);
+      printf("DataModuleTest: %u readers, rx seqlock %.1f ns, mutex %.1f ns", readers, seqlock.frame_ns, mutex.frame_ns);
+      if(readers != 0)
+        printf(", read seqlock %.1f ns (max %.0f), mutex %.1f ns (max %.0f)",
+               seqlock.read_ns, seqlock.read_max_ns, mutex.read_ns, mutex.read_max_ns);
+      printf("\n");
+    }
+  }
+  // Average ns per call of get over CALLS calls, summed so the calls can't be dropped
+  template <typename Get>
+  double TimeGetter(Get get)
+  {
+    constexpr uint32_t CALLS = 2000000;
+    using Clock = std::chrono::steady_clock;
+    volatile double sink = 0;
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < CALLS; ++i)
+      sink = sink + get();
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / CALLS;
+  }
+
+  // Not a pass/fail check, timings on the host only hint at the target. The host has an FPU,
+  // the float path costs more on a target that emulates it.
+  void BenchmarkFixedGetters()
+  {
+    uint8_t payload[8] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0x0F};
+    Proton1 proton(0x600);
+    proton.Receive(payload, 1);
+    OrionBMSRx0 orion_volts(0x6B0, 0);
+    orion_volts.Receive(payload, 1);
+    OrionBMSRx3 orion_res(0x6B3, 0);
+    orion_res.Receive(payload, 1);
+    MitsubaRx1 mitsuba(0x08F99540, 0);
+    mitsuba.Receive(payload, 1);
+    struct {
+      const char* name;
+      double float_ns;
+      double fixed_ns;
+    } rows[] = {
+      {"Proton1 array voltage", TimeGetter([&]() { return proton.getArrayVoltage(); }),
+                                TimeGetter([&]() { return proton.getArrayVoltageFixed().Count(); })},
+      {"OrionBMSRx0 pack sum", TimeGetter([&]() { return orion_volts.getPackSumVolt(); }),
+                               TimeGetter([&]() { return orion_volts.getPackSumVoltFixed().Count(); })},
+      {"OrionBMSRx3 pack res", TimeGetter([&]() { return orion_res.getPackRes(); }),
+                               TimeGetter([&]() { return orion_res.getPackResFixed().Count(); })},
+      {"MitsubaRx1 target", TimeGetter([&]() { return mitsuba.GetOutTargetVal(); }),
+                            TimeGetter([&]() { return mitsuba.GetOutTargetCurrentFixed().Count(); })},
+    };
+    for (const auto& row : rows)
+      printf("DataModuleTest: %s, float %.1f ns, fixed %.1f ns\n", row.name, row.float_ns, row.fixed_ns);
+  }
+}
+
+int main()
+{
+  TestSeqlock();
+  TestLazy();
+  TestLazyEncode();
+  TestPowerSignal();
+  TestPackPower();
+  TestSolarAndMotorPower();
+  BenchmarkRxPath();
+  BenchmarkFixedGetters();
+  return Test::Finish("DataModuleTest");
+}
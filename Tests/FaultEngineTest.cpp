@@ -0,0 +1,260 @@
+/*
+ * FaultEngineTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Feeds BMS, motor controller and steering frames to FaultEngine and checks the
+ *               active word, the raised/cleared events each change produces, latching and
+ *               acknowledge, severities and readers that fall behind the event ring.
+ */
+
+#include <FaultEngine.hpp>
+#include "Test.hpp"
+
+#include <cstring>
+
+using SolarGators::DataModules::FaultEngine;
+using SolarGators::DataModules::MitsubaRx2;
+using SolarGators::DataModules::OrionBMSRx4;
+using SolarGators::DataModules::Steering;
+using Severity = FaultEngine::Severity;
+
+namespace {
+  // The sources as they come off the bus
+  void SendBms(FaultEngine& engine, OrionBMSRx4& bms, uint32_t faults, uint32_t tick)
+  {
+    uint8_t buff[OrionBMSRx4::Size] = {static_cast<uint8_t>(faults), static_cast<uint8_t>(faults >> 8),
+                                       static_cast<uint8_t>(faults >> 16), 100};
+    bms.Receive(buff, tick);
+    engine.Update(bms, tick);
+  }
+
+  void SendMotor(FaultEngine& engine, MitsubaRx2& motor, uint32_t faults, uint8_t overheat, uint32_t tick)
+  {
+    uint8_t buff[MitsubaRx2::Rx2_Size] = {static_cast<uint8_t>(faults), static_cast<uint8_t>(faults >> 8),
+                                          static_cast<uint8_t>(faults >> 16), static_cast<uint8_t>(faults >> 24),
+                                          overheat};
+    motor.Receive(buff, tick);
+    engine.Update(motor, tick);
+  }
+
+  void SendSteering(FaultEngine& engine, Steering& steering, bool bps_fault, uint32_t tick)
+  {
+    uint8_t buff[Steering::Size] = {static_cast<uint8_t>(bps_fault << 3), 0, 0};
+    steering.Receive(buff, tick);
+    engine.Update(steering, tick);
+  }
+
+  // True if the next event is exactly this one
+  bool NextEvent(const FaultEngine& engine, uint32_t& cursor, uint64_t raised, uint64_t cleared, uint32_t tick)
+  {
+    FaultEngine::Event event;
+    bool dropped;
+    return engine.ReadEvent(cursor, event, dropped) && !dropped && event.raised == raised &&
+        event.cleared == cleared && event.tick == tick;
+  }
+
+  // SetSeverity stamps the kernel tick, which may move on during the call
+  bool NextEventAfter(const FaultEngine& engine, uint32_t& cursor, uint64_t raised, uint64_t cleared, uint32_t tick)
+  {
+    FaultEngine::Event event;
+    bool dropped;
+    return engine.ReadEvent(cursor, event, dropped) && !dropped && event.raised == raised &&
+        event.cleared == cleared && event.tick - tick < 1000;
+  }
+
+  bool NoEvent(const FaultEngine& engine, uint32_t& cursor)
+  {
+    FaultEngine::Event event;
+    bool dropped;
+    return !engine.ReadEvent(cursor, event, dropped) && !dropped;
+  }
+
+  // Each source only replaces its own bits, and only a change in the word makes an event
+  void TestEdgeEvents()
+  {
+    FaultEngine engine(0x700, 0);
+    OrionBMSRx4 bms(0x6B4, 0);
+    MitsubaRx2 motor(0x08F89540, 0);
+    Steering steering;
+    uint32_t cursor = engine.GetEventHead();
+    constexpr uint64_t WEAK_CELL = FaultEngine::Bit(OrionBMSRx4::Fault::WeakCell);
+    constexpr uint64_t PACK_HOT = FaultEngine::Bit(OrionBMSRx4::Fault::PackTooHot);
+    constexpr uint64_t FET_THERM = FaultEngine::Bit(MitsubaRx2::Fault::FetTherm);
+    constexpr uint64_t OVERHEAT = static_cast<uint64_t>(1) << FaultEngine::MOTOR_OVERHEAT_BIT;
+
+    SendBms(engine, bms, OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::WeakCell), 10);
+    CHECK(engine.GetActive() == WEAK_CELL);
+    CHECK(NextEvent(engine, cursor, WEAK_CELL, 0, 10));
+    // The same frame again is not a change
+    SendBms(engine, bms, OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::WeakCell), 11);
+    CHECK(NoEvent(engine, cursor));
+    // One frame raising and clearing gives one event with both
+    SendBms(engine, bms, OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::PackTooHot), 12);
+    CHECK(NextEvent(engine, cursor, PACK_HOT, WEAK_CELL, 12));
+
+    SendMotor(engine, motor, MitsubaRx2::Faults::Mask(MitsubaRx2::Fault::FetTherm), 2, 20);
+    CHECK(NextEvent(engine, cursor, FET_THERM | OVERHEAT, 0, 20));
+    SendSteering(engine, steering, true, 30);
+    CHECK(NextEvent(engine, cursor, FaultEngine::BPS_FAULT, 0, 30));
+    CHECK(engine.GetActive() == (PACK_HOT | FET_THERM | OVERHEAT | FaultEngine::BPS_FAULT));
+
+    // A clean BMS frame leaves the other sources alone
+    SendBms(engine, bms, 0, 40);
+    CHECK(NextEvent(engine, cursor, 0, PACK_HOT, 40));
+    CHECK(engine.GetActive() == (FET_THERM | OVERHEAT | FaultEngine::BPS_FAULT));
+    SendMotor(engine, motor, 0, 0, 41);
+    SendSteering(engine, steering, false, 42);
+    CHECK(NextEvent(engine, cursor, 0, FET_THERM | OVERHEAT, 41));
+    CHECK(NextEvent(engine, cursor, 0, FaultEngine::BPS_FAULT, 42));
+    CHECK(NoEvent(engine, cursor));
+    CHECK(engine.GetActive() == 0);
+    CHECK(engine.GetHighestSeverity() == Severity::None);
+  }
+
+  // A latched fault outlives its source until acknowledged, acknowledging a live fault does nothing
+  void TestLatching()
+  {
+    FaultEngine engine(0x700, 0);
+    OrionBMSRx4 bms(0x6B4, 0);
+    constexpr uint32_t HOT = OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::PackTooHot);
+    constexpr uint32_t WEAK = OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::WeakCell);
+    constexpr uint64_t PACK_HOT = FaultEngine::FromBms(HOT);
+    constexpr uint64_t WEAK_CELL = FaultEngine::FromBms(WEAK);
+    engine.SetLatching(FaultEngine::FromBms(OrionBMSRx4::THERMAL_FAULTS), true);
+    uint32_t cursor = engine.GetEventHead();
+
+    SendBms(engine, bms, HOT | WEAK, 10);
+    CHECK(NextEvent(engine, cursor, PACK_HOT | WEAK_CELL, 0, 10));
+    CHECK(engine.GetLatched() == 0);
+    // Source still reporting, the acknowledge is dropped rather than remembered
+    engine.Acknowledge(PACK_HOT, 11);
+    CHECK(NoEvent(engine, cursor));
+    SendBms(engine, bms, 0, 12);
+    CHECK(NextEvent(engine, cursor, 0, WEAK_CELL, 12));
+    CHECK(engine.GetActive() == PACK_HOT);
+    CHECK(engine.GetLatched() == PACK_HOT);
+    // Acknowledging something else releases nothing
+    engine.Acknowledge(WEAK_CELL, 13);
+    CHECK(NoEvent(engine, cursor));
+    engine.Acknowledge(PACK_HOT, 14);
+    CHECK(NextEvent(engine, cursor, 0, PACK_HOT, 14));
+    CHECK(engine.GetActive() == 0 && engine.GetLatched() == 0);
+
+    // Raised again it latches again, and a second raise while latched isn't an event
+    SendBms(engine, bms, HOT, 20);
+    SendBms(engine, bms, 0, 21);
+    SendBms(engine, bms, HOT, 22);
+    CHECK(NextEvent(engine, cursor, PACK_HOT, 0, 20));
+    CHECK(NoEvent(engine, cursor));
+    // Turning latching off doesn't release a fault already latched
+    engine.SetLatching(PACK_HOT, false);
+    SendBms(engine, bms, 0, 23);
+    CHECK(engine.GetLatched() == PACK_HOT);
+    engine.Acknowledge(FaultEngine::ALL_FAULTS, 24);
+    CHECK(NextEvent(engine, cursor, 0, PACK_HOT, 24));
+    // and new ones clear with their source
+    SendBms(engine, bms, HOT, 25);
+    SendBms(engine, bms, 0, 26);
+    CHECK(NextEvent(engine, cursor, PACK_HOT, 0, 25));
+    CHECK(NextEvent(engine, cursor, 0, PACK_HOT, 26));
+  }
+
+  // Faults at None never show, moving a live fault to or from None is an edge
+  void TestSeverity()
+  {
+    FaultEngine engine(0x700, 0);
+    OrionBMSRx4 bms(0x6B4, 0);
+    constexpr uint32_t WEAK = OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::WeakCell);
+    constexpr uint32_t BALANCING = OrionBMSRx4::Faults::Mask(OrionBMSRx4::Fault::CellBalancingStuckOff);
+    constexpr uint64_t WEAK_CELL = FaultEngine::FromBms(WEAK);
+    constexpr uint64_t STUCK = FaultEngine::FromBms(BALANCING);
+    CHECK(engine.GetSeverity(FaultEngine::BPS_FAULT_BIT) == Severity::Info);
+    engine.SetSeverity(FaultEngine::BPS_FAULT, Severity::Shutdown);
+    engine.SetSeverity(WEAK_CELL, Severity::Warning);
+    engine.SetSeverity(STUCK, Severity::None);
+    CHECK(engine.GetSeverity(FaultEngine::BPS_FAULT_BIT) == Severity::Shutdown);
+    CHECK(engine.GetSeverity(FaultEngine::MOTOR_OVERHEAT_BIT) == Severity::Info);
+    uint32_t cursor = engine.GetEventHead();
+
+    SendBms(engine, bms, WEAK | BALANCING, 10);
+    CHECK(NextEvent(engine, cursor, WEAK_CELL, 0, 10));
+    CHECK(engine.GetActive() == WEAK_CELL);
+    CHECK(engine.GetActive(Severity::Warning) == WEAK_CELL);
+    CHECK(engine.GetActive(Severity::Info) == 0);
+    CHECK(engine.GetHighestSeverity() == Severity::Warning);
+
+    uint32_t now = osKernelGetTickCount();
+    engine.SetSeverity(STUCK, Severity::Critical);
+    CHECK(NextEventAfter(engine, cursor, STUCK, 0, now));
+    CHECK(engine.GetHighestSeverity() == Severity::Critical);
+    engine.SetSeverity(WEAK_CELL | STUCK, Severity::None);
+    CHECK(NextEventAfter(engine, cursor, 0, WEAK_CELL | STUCK, now));
+    CHECK(engine.GetActive() == 0 && engine.GetHighestSeverity() == Severity::None);
+    // Still hidden while the source keeps reporting
+    SendBms(engine, bms, WEAK | BALANCING, 11);
+    CHECK(NoEvent(engine, cursor));
+  }
+
+  // A reader more than MAX_EVENTS behind skips to the oldest event held and is told so
+  void TestEventRing()
+  {
+    FaultEngine engine(0x700, 0);
+    OrionBMSRx4 bms(0x6B4, 0);
+    uint32_t slow = engine.GetEventHead();
+    constexpr uint32_t EVENTS = FaultEngine::MAX_EVENTS + 5;
+    for (uint32_t i = 1; i <= EVENTS; ++i)
+      SendBms(engine, bms, i % 2, i);
+    CHECK(engine.GetEventHead() - slow == EVENTS);
+    FaultEngine::Event event;
+    bool dropped;
+    CHECK(engine.ReadEvent(slow, event, dropped));
+    CHECK(dropped);
+    CHECK(event.tick == EVENTS - FaultEngine::MAX_EVENTS + 1);
+    uint32_t read = 1;
+    while(engine.ReadEvent(slow, event, dropped))
+    {
+      CHECK(!dropped);
+      ++read;
+    }
+    CHECK(read == FaultEngine::MAX_EVENTS);
+    CHECK(event.tick == EVENTS && event.raised == 1 && event.cleared == 0);
+
+    uint8_t buff[FaultEngine::EVENT_SIZE];
+    event.raised = FaultEngine::BPS_FAULT;
+    event.cleared = 0x0102030405ull;
+    event.tick = 0xA1B2C3D4;
+    FaultEngine::EncodeEvent(event, buff);
+    const uint8_t expected[FaultEngine::EVENT_SIZE] = {0, 0, 0, 0, 0, 0, 0x20, 5, 4, 3, 2, 1, 0, 0,
+                                                       0xD4, 0xC3, 0xB2, 0xA1};
+    CHECK(memcmp(buff, expected, sizeof(buff)) == 0);
+  }
+
+  // A word from another board replaces every source, bits outside ALL_FAULTS are dropped
+  void TestByteArray()
+  {
+    FaultEngine engine(0x700, 0);
+    engine.SetLatching(FaultEngine::BPS_FAULT, true);
+    uint8_t buff[FaultEngine::Size] = {0x01, 0, 0, 0x02, 0, 0, 0x20, 0xFF};
+    engine.FromByteArray(buff);
+    uint64_t word = 0x1 | (0x2ull << 24) | FaultEngine::BPS_FAULT;
+    CHECK(engine.GetActive() == word);
+    uint8_t out[FaultEngine::Size];
+    engine.ToByteArray(out);
+    CHECK(memcmp(out, buff, 7) == 0 && out[7] == 0);
+    uint8_t clear[FaultEngine::Size] = {};
+    engine.FromByteArray(clear);
+    CHECK(engine.GetActive() == FaultEngine::BPS_FAULT);
+    CHECK(engine.GetLatched() == FaultEngine::BPS_FAULT);
+  }
+}
+
+int main()
+{
+  TestEdgeEvents();
+  TestLatching();
+  TestSeverity();
+  TestEventRing();
+  TestByteArray();
+  return Test::Finish("FaultEngineTest");
+}
@@ -0,0 +1,680 @@
+/*
+ * FieldCodecTest.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Checks the Codec field layouts bit for bit: fields that cross bytes, signed and big
+ *               endian extremes and what is left of a payload no field covers. Every module ported
+ *               to a Codec is run against the shift and mask code it replaced on every single bit
+ *               and on random payloads, and timed against it.
+ */
+
+#include <FieldCodec.hpp>
+#include <Mitsuba.hpp>
+#include <OrionBMS.hpp>
+#include <Proton1.hpp>
+#include <Steering.hpp>
+#include "Test.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using namespace SolarGators::DataModules;
+
+namespace {
+  // The hand written coding the modules had before they were ported, kept as the reference.
+  // Members are the raw values, OrionBMSRx1's constant is 16 bits as the port fixed it and
+  // Proton1 keeps the raw integers its old float members were scaled from.
+  namespace Baseline
+  {
+    struct MitsubaRequest { bool requestFrame0, requestFrame1, requestFrame2; };
+    [[gnu::noinline]] void Encode(const MitsubaRequest& m, uint8_t* buff)
+    {
+      buff[0] = 0;
+      buff[0] |= static_cast<uint8_t>(m.requestFrame0) << 0;
+      buff[0] |= static_cast<uint8_t>(m.requestFrame1) << 1;
+      buff[0] |= static_cast<uint8_t>(m.requestFrame2) << 2;
+    }
+
+    struct MitsubaRx0 {
+      uint16_t battVoltage, battCurrent;
+      bool battCurrentDir;
+      uint16_t motorCurrentPkAvg;
+      uint8_t FETtemp;
+      uint16_t motorRPM, PWMDuty;
+      uint8_t LeadAngle;
+    };
+    [[gnu::noinline]] void Encode(const MitsubaRx0& m, uint8_t* buff)
+    {
+      buff[0] = static_cast<uint8_t>(m.battVoltage);
+      buff[1] = static_cast<uint8_t>(m.battVoltage >> 8);
+      buff[1] |= static_cast<uint8_t>(static_cast<uint32_t>(m.battCurrent) << 2);
+      buff[2] = static_cast<uint8_t>(m.battCurrent >> 6);
+      buff[2] |= static_cast<uint8_t>(static_cast<uint32_t>(m.battCurrentDir) << 3);
+      buff[2] |= static_cast<uint8_t>(m.motorCurrentPkAvg << 4);
+      buff[3] = static_cast<uint8_t>(m.motorCurrentPkAvg >> 4);
+      buff[3] |= static_cast<uint8_t>(static_cast<uint32_t>(m.FETtemp) << 6);
+      buff[4] = static_cast<uint8_t>(m.FETtemp >> 2);
+      buff[4] |= (static_cast<uint32_t>(m.motorRPM) & 0x1F) << 3;
+      buff[5] = (static_cast<uint32_t>(m.motorRPM) & 0xFE0) >> 5;
+      buff[5] |= static_cast<uint8_t>(m.PWMDuty << 7);
+      buff[6] = static_cast<uint8_t>(m.PWMDuty >> 1);
+      buff[7] = static_cast<uint8_t>(m.PWMDuty >> 9);
+      buff[7] |= static_cast<uint8_t>(static_cast<uint32_t>(m.LeadAngle) << 1);
+    }
+    [[gnu::noinline]] void Decode(MitsubaRx0& m, const uint8_t* buff)
+    {
+      m.battVoltage = (static_cast<uint32_t>(buff[1] & 3) << 8) | buff[0];
+      m.battCurrent = (static_cast<uint32_t>(buff[2] & 7) << 6) | (buff[1] >> 2);
+      m.battCurrentDir = buff[2] & 8;
+      m.motorCurrentPkAvg = static_cast<uint32_t>((buff[3] & 0x3F) << 4) | (buff[2] >> 4);
+      m.FETtemp = static_cast<uint32_t>((buff[4] & 7) << 2) | (buff[3] >> 6);
+      m.motorRPM = (static_cast<uint32_t>(buff[5] & 0x7F) << 5) | (buff[4] >> 3);
+      m.PWMDuty = (static_cast<uint32_t>(buff[7] & 1) << 9) | (buff[6] << 1) | (buff[5] >> 7);
+      m.LeadAngle = buff[7] >> 1;
+    }
+
+    struct MitsubaRx1 {
+      bool powerMode, MCmode;
+      uint16_t AcceleratorPosition, regenVRposition;
+      uint8_t digitSWposition;
+      uint16_t outTargetVal;
+      uint8_t driveActStat;
+      bool regenStat;
+    };
+    [[gnu::noinline]] void Encode(const MitsubaRx1& m, uint8_t* buff)
+    {
+      buff[0] = static_cast<uint8_t>(m.powerMode);
+      buff[0] |= static_cast<uint8_t>(m.MCmode) << 1;
+      buff[0] |= static_cast<uint8_t>(m.AcceleratorPosition << 2);
+      buff[1] = static_cast<uint8_t>(m.AcceleratorPosition >> 6);
+      buff[1] |= static_cast<uint8_t>(m.regenVRposition << 4);
+      buff[2] = static_cast<uint8_t>(m.regenVRposition >> 4);
+      buff[2] |= static_cast<uint8_t>(static_cast<uint32_t>(m.digitSWposition) << 6);
+      buff[3] = static_cast<uint8_t>(m.digitSWposition >> 2);
+      buff[3] |= static_cast<uint8_t>(m.outTargetVal << 2);
+      buff[4] = static_cast<uint8_t>(m.outTargetVal >> 6);
+      buff[4] |= static_cast<uint8_t>(m.driveActStat << 4);
+      buff[4] |= static_cast<uint8_t>(static_cast<uint8_t>(m.regenStat) << 6);
+    }
+    [[gnu::noinline]] void Decode(MitsubaRx1& m, const uint8_t* buff)
+    {
+      m.powerMode = buff[0] & 1;
+      m.MCmode = (buff[0] >> 1) & 1;
+      m.AcceleratorPosition = static_cast<uint32_t>((buff[1] & 0xF) << 6) | (buff[0] >> 2);
+      m.regenVRposition = static_cast<uint32_t>((buff[2] & 0x3F) << 4) | (buff[1] >> 4);
+      m.digitSWposition = static_cast<uint32_t>((buff[3] & 0x3) << 2) | (buff[2] >> 6);
+      m.outTargetVal = static_cast<uint32_t>((buff[4] & 0xF) << 6) | (buff[3] >> 2);
+      m.driveActStat = (buff[4] >> 4) & 3;
+      m.regenStat = (buff[4] >> 6) & 1;
+    }
+
+    // One bool per bit of the frame, indexed like MitsubaRx2::Fault
+    struct MitsubaRx2 {
+      bool fault[28];
+      uint8_t overHeatLevel;
+    };
+    [[gnu::noinline]] void Encode(const MitsubaRx2& m, uint8_t* buff)
+    {
+      buff[0] = 0;
+      buff[0] |= static_cast<uint8_t>(m.fault[0]) << 0;
+      buff[0] |= static_cast<uint8_t>(m.fault[1]) << 1;
+      buff[0] |= static_cast<uint8_t>(m.fault[2]) << 2;
+      buff[0] |= static_cast<uint8_t>(m.fault[3]) << 3;
+      buff[0] |= static_cast<uint8_t>(m.fault[5]) << 5;
+      buff[0] |= static_cast<uint8_t>(m.fault[6]) << 6;
+      buff[0] |= static_cast<uint8_t>(m.fault[7]) << 7;
+      buff[1] = 0;
+      buff[1] |= static_cast<uint8_t>(m.fault[8]) << 0;
+      buff[1] |= static_cast<uint8_t>(m.fault[9]) << 1;
+      buff[1] |= static_cast<uint8_t>(m.fault[11]) << 3;
+      buff[2] = 0;
+      buff[2] |= static_cast<uint8_t>(m.fault[16]) << 0;
+      buff[2] |= static_cast<uint8_t>(m.fault[17]) << 1;
+      buff[2] |= static_cast<uint8_t>(m.fault[19]) << 3;
+      buff[2] |= static_cast<uint8_t>(m.fault[21]) << 5;
+      buff[3] = 0;
+      buff[3] |= static_cast<uint8_t>(m.fault[24]) << 0;
+      buff[3] |= static_cast<uint8_t>(m.fault[25]) << 1;
+      buff[3] |= static_cast<uint8_t>(m.fault[26]) << 2;
+      buff[3] |= static_cast<uint8_t>(m.fault[27]) << 3;
+      buff[4] = static_cast<uint32_t>(m.overHeatLevel) & 0x3;
+    }
+    [[gnu::noinline]] void Decode(MitsubaRx2& m, const uint8_t* buff)
+    {
+      m.fault[0] = buff[0] & (1 << 0);
+      m.fault[1] = buff[0] & (1 << 1);
+      m.fault[2] = buff[0] & (1 << 2);
+      m.fault[3] = buff[0] & (1 << 3);
+      m.fault[5] = buff[0] & (1 << 5);
+      m.fault[6] = buff[0] & (1 << 6);
+      m.fault[7] = buff[0] & (1 << 7);
+      m.fault[8] = buff[1] & (1 << 0);
+      m.fault[9] = buff[1] & (1 << 1);
+      m.fault[11] = buff[1] & (1 << 3);
+      m.fault[16] = buff[2] & (1 << 0);
+      m.fault[17] = buff[2] & (1 << 1);
+      m.fault[19] = buff[2] & (1 << 3);
+      m.fault[21] = buff[2] & (1 << 5);
+      m.fault[24] = buff[3] & (1 << 0);
+      m.fault[25] = buff[3] & (1 << 1);
+      m.fault[26] = buff[3] & (1 << 2);
+      m.fault[27] = buff[3] & (1 << 3);
+      m.overHeatLevel = buff[4] & 0x3;
+    }
+
+    // OrionBMS messages 0, 2, 3 and 5 are big endian 16 bit words
+    template <uint8_t WORDS>
+    struct Words { uint16_t word[WORDS]; };
+    template <uint8_t WORDS>
+    [[gnu::noinline]] void Encode(const Words<WORDS>& m, uint8_t* buff)
+    {
+      for (uint8_t i = 0; i < WORDS; ++i)
+      {
+        buff[2 * i] = m.word[i] >> 8;
+        buff[2 * i + 1] = m.word[i] & 0x00FF;
+      }
+    }
+    template <uint8_t WORDS>
+    [[gnu::noinline]] void Decode(Words<WORDS>& m, const uint8_t* buff)
+    {
+      for (uint8_t i = 0; i < WORDS; ++i)
+        m.word[i] = (static_cast<uint16_t>(buff[2 * i]) << 8) | buff[2 * i + 1];
+    }
+
+    struct OrionBMSRx1 {
+      uint8_t high_temp_, high_temp_id_, low_temp_, low_temp_id_, avg_temp_, internal_temp_;
+      uint16_t constant_val_;
+    };
+    [[gnu::noinline]] void Encode(const OrionBMSRx1& m, uint8_t* buff)
+    {
+      buff[0] = m.high_temp_;
+      buff[1] = m.high_temp_id_;
+      buff[2] = m.low_temp_;
+      buff[3] = m.low_temp_id_;
+      buff[4] = m.avg_temp_;
+      buff[5] = m.internal_temp_;
+      buff[6] = m.constant_val_ >> 8;
+      buff[7] = m.constant_val_ & 0x00FF;
+    }
+    [[gnu::noinline]] void Decode(OrionBMSRx1& m, const uint8_t* buff)
+    {
+      m.high_temp_ = buff[0];
+      m.high_temp_id_ = buff[1];
+      m.low_temp_ = buff[2];
+      m.low_temp_id_ = buff[3];
+      m.avg_temp_ = buff[4];
+      m.internal_temp_ = buff[5];
+      m.constant_val_ = (static_cast<uint16_t>(buff[6]) << 8) | buff[7];
+    }
+
+    // One bool per bit, indexed like OrionBMSRx4::Fault
+    struct OrionBMSRx4 {
+      bool fault[24];
+      uint8_t pack_soc_;
+    };
+    [[gnu::noinline]] void Encode(const OrionBMSRx4& m, uint8_t* buff)
+    {
+      for (uint8_t byte = 0; byte < 3; ++byte)
+      {
+        buff[byte]  = static_cast<uint8_t>(m.fault[8 * byte + 0]) << 0;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 1]) << 1;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 2]) << 2;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 3]) << 3;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 4]) << 4;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 5]) << 5;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 6]) << 6;
+        buff[byte] |= static_cast<uint8_t>(m.fault[8 * byte + 7]) << 7;
+      }
+      buff[3] = m.pack_soc_;
+    }
+    [[gnu::noinline]] void Decode(OrionBMSRx4& m, const uint8_t* buff)
+    {
+      for (uint8_t byte = 0; byte < 3; ++byte)
+      {
+        m.fault[8 * byte + 0] = buff[byte] & (1 << 0);
+        m.fault[8 * byte + 1] = buff[byte] & (1 << 1);
+        m.fault[8 * byte + 2] = buff[byte] & (1 << 2);
+        m.fault[8 * byte + 3] = buff[byte] & (1 << 3);
+        m.fault[8 * byte + 4] = buff[byte] & (1 << 4);
+        m.fault[8 * byte + 5] = buff[byte] & (1 << 5);
+        m.fault[8 * byte + 6] = buff[byte] & (1 << 6);
+        m.fault[8 * byte + 7] = buff[byte] & (1 << 7);
+      }
+      m.pack_soc_ = buff[3];
+    }
+
+    struct Steering {
+      bool left_turn_, right_turn_, hazards_, bps_fault_, cruise_enable_, eco_enable_, headlights_, horn_, reverse_;
+      uint8_t cruise_speed_;
+    };
+    [[gnu::noinline]] void Encode(const Steering& m, uint8_t* buff)
+    {
+      memset(buff, 0, 3);
+      buff[0] |= static_cast<uint8_t>(m.left_turn_)     << 0;
+      buff[0] |= static_cast<uint8_t>(m.right_turn_)    << 1;
+      buff[0] |= static_cast<uint8_t>(m.hazards_)       << 2;
+      buff[0] |= static_cast<uint8_t>(m.bps_fault_)     << 3;
+      buff[0] |= static_cast<uint8_t>(m.cruise_enable_) << 4;
+      buff[0] |= static_cast<uint8_t>(m.eco_enable_)    << 5;
+      buff[0] |= static_cast<uint8_t>(m.headlights_)    << 6;
+      buff[0] |= static_cast<uint8_t>(m.horn_)          << 7;
+      buff[1] |= static_cast<uint8_t>(m.reverse_)       << 0;
+      buff[2] |= m.cruise_speed_;
+    }
+    [[gnu::noinline]] void Decode(Steering& m, const uint8_t* buff)
+    {
+      m.left_turn_     = buff[0] & (1 << 0);
+      m.right_turn_    = buff[0] & (1 << 1);
+      m.hazards_       = buff[0] & (1 << 2);
+      m.bps_fault_     = buff[0] & (1 << 3);
+      m.cruise_enable_ = buff[0] & (1 << 4);
+      m.eco_enable_    = buff[0] & (1 << 5);
+      m.headlights_    = buff[0] & (1 << 6);
+      m.horn_          = buff[0] & (1 << 7);
+      m.reverse_       = buff[1] & (1 << 0);
+      m.cruise_speed_  = buff[2];
+    }
+
+    struct Proton1 { uint16_t arrayVoltage, arrayCurrent, batteryVoltage, mpptTemperature; };
+    [[gnu::noinline]] void Encode(const Proton1& m, uint8_t* buff)
+    {
+      buff[0] = m.arrayVoltage & 0xFF;
+      buff[1] = (m.arrayVoltage >> 8) & 0xFF;
+      buff[2] = m.arrayCurrent & 0xFF;
+      buff[3] = (m.arrayCurrent >> 8) & 0xFF;
+      buff[4] = m.batteryVoltage & 0xFF;
+      buff[5] = (m.batteryVoltage >> 8) & 0xFF;
+      buff[6] = m.mpptTemperature & 0xFF;
+      buff[7] = (m.mpptTemperature >> 8) & 0xFF;
+    }
+    [[gnu::noinline]] void Decode(Proton1& m, const uint8_t* buff)
+    {
+      m.arrayVoltage = (static_cast<uint32_t>(buff[1]) << 8) | buff[0];
+      m.arrayCurrent = (static_cast<uint32_t>(buff[3]) << 8) | buff[2];
+      m.batteryVoltage = (static_cast<uint32_t>(buff[5]) << 8) | buff[4];
+      m.mpptTemperature = (static_cast<uint32_t>(buff[7]) << 8) | buff[6];
+    }
+  }
+
+  // Decoded values the module's getters must agree with the reference on
+  bool Same(const MitsubaRx0& m, const Baseline::MitsubaRx0& r)
+  {
+    return m.GetBatteryVoltageFixed().Count() == r.battVoltage && m.GetBatteryCurrent() == r.battCurrent &&
+        m.GetBatteryCurrentDir() == r.battCurrentDir && m.GetMotorCurrentPkAvg() == r.motorCurrentPkAvg &&
+        m.GetFetTemp() == r.FETtemp * 5 && m.GetMotorRPM() == r.motorRPM &&
+        m.GetPWMDutyFixed().Count() == r.PWMDuty && m.GetLeadAngleFixed().Count() == r.LeadAngle;
+  }
+  bool Same(const MitsubaRx1& m, const Baseline::MitsubaRx1& r)
+  {
+    return m.GetPowerMode() == r.powerMode && m.GetMcMode() == r.MCmode &&
+        m.GetAcceleratorPositionFixed().Count() == r.AcceleratorPosition &&
+        m.GetRegenVrPositionFixed().Count() == r.regenVRposition && m.GetDigitSwitchPosition() == r.digitSWposition &&
+        m.GetOutTargetVal() == static_cast<float>(r.outTargetVal / 2.0) &&
+        m.GetOutTargetCurrentFixed().Count() == r.outTargetVal && m.GetOutTargetDutyFixed().Count() == r.outTargetVal &&
+        m.GetDriveActStat() == r.driveActStat &&
+        m.GetRegenStat() == r.regenStat;
+  }
+  bool Same(const MitsubaRx2& m, const Baseline::MitsubaRx2& r)
+  {
+    bool same = m.GetOverHeatLevel() == r.overHeatLevel;
+#define MITSUBA_RX2_SAME(name, getter, bit) same = same && m.getter() == r.fault[bit];
+    MITSUBA_RX2_FAULTS(MITSUBA_RX2_SAME)
+#undef MITSUBA_RX2_SAME
+    return same;
+  }
+  bool Same(const OrionBMSRx0& m, const Baseline::Words<4>& r)
+  {
+    return m.getLowCellVoltFixed().Count() == r.word[0] && m.getHighCellVoltFixed().Count() == r.word[1] &&
+        m.getAvgCellVoltFixed().Count() == r.word[2] && m.getPackSumVoltFixed().Count() == r.word[3];
+  }
+  bool Same(const OrionBMSRx1& m, const Baseline::OrionBMSRx1& r)
+  {
+    return m.getHighTemp() == r.high_temp_ && m.getHighTempId() == r.high_temp_id_ && m.getLowTemp() == r.low_temp_ &&
+        m.getLowTempId() == r.low_temp_id_ && m.getAvgTemp() == r.avg_temp_ && m.getInternalTemp() == r.internal_temp_ &&
+        m.getConstantVal() == r.constant_val_;
+  }
+  bool Same(const OrionBMSRx2& m, const Baseline::Words<4>& r)
+  {
+    // The baseline stored the unsigned word straight into the int16_t member
+    return m.getPackDcl() == r.word[0] && m.getPackCcl() == r.word[1] &&
+        m.getPackCurrentFixed().Count() == static_cast<int16_t>(r.word[2]) && m.getConstantVal() == r.word[3];
+  }
+  bool Same(const OrionBMSRx3& m, const Baseline::Words<3>& r)
+  {
+    return m.getLowCellRes() == static_cast<float>(r.word[0] * 0.01) &&
+        m.getHighCellRes() == static_cast<float>(r.word[1] * 0.01) && m.getPackRes() == static_cast<float>(r.word[2] * 0.001) &&
+        m.getLowCellResFixed().Count() == r.word[0] && m.getHighCellResFixed().Count() == r.word[1] &&
+        m.getPackResFixed().Count() == r.word[2];
+  }
+  bool Same(const OrionBMSRx4& m, const Baseline::OrionBMSRx4& r)
+  {
+    bool same = m.getPackSocFixed().Count() == r.pack_soc_;
+#define ORION_BMS_RX4_SAME(name, getter, bit) same = same && m.getter() == r.fault[bit];
+    ORION_BMS_RX4_FAULTS(ORION_BMS_RX4_SAME)
+#undef ORION_BMS_RX4_SAME
+    return same;
+  }
+  bool Same(const OrionBMSRx5& m, const Baseline::Words<4>& r)
+  {
+    return m.getMaxPackDcl() == r.word[0] && m.getMaxPackCcl() == r.word[1] &&
+        m.getMaxPackVoltFixed().Count() == r.word[2] && m.getMinPackVoltFixed().Count() == r.word[3];
+  }
+  bool Same(const Steering& m, const Baseline::Steering& r)
+  {
+    return m.GetLeftTurnStatus() == r.left_turn_ && m.GetRightTurnStatus() == r.right_turn_ &&
+        m.GetHazardsStatus() == r.hazards_ && m.GetBpFaultStatus() == r.bps_fault_ &&
+        m.GetCruiseEnabledStatus() == r.cruise_enable_ && m.GetEcoEnabledStatus() == r.eco_enable_ &&
+        m.GetHeadlightsStatus() == r.headlights_ && m.GetHornStatus() == r.horn_ &&
+        m.GetReverseStatus() == r.reverse_ && m.GetCruiseSpeed() == r.cruise_speed_;
+  }
+  bool Same(const Proton1& m, const Baseline::Proton1& r)
+  {
+    return m.getArrayVoltageFixed().Count() == r.arrayVoltage && m.getArrayCurrentFixed().Count() == r.arrayCurrent &&
+        m.getBatteryVoltageFixed().Count() == r.batteryVoltage &&
+        m.getMpptTemperatureFixed().Count() == r.mpptTemperature;
+  }
+
+  // Every single bit, all clear, all set, then random payloads
+  std::vector<std::array<uint8_t, 8>> Payloads()
+  {
+    std::vector<std::array<uint8_t, 8>> payloads;
+    payloads.push_back({});
+    payloads.push_back({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+    for (uint8_t bit = 0; bit < 64; ++bit)
+    {
+      std::array<uint8_t, 8> payload = {};
+      payload[bit / 8] = 1 << (bit % 8);
+      payloads.push_back(payload);
+    }
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      std::array<uint8_t, 8> payload;
+      memcpy(payload.data(), &state, sizeof(state));
+      payloads.push_back(payload);
+    }
+    return payloads;
+  }
+
+  // Decodes every payload with both and compares the getters, then encodes both and compares
+  // the bytes. Encoding what was decoded gives the payload back minus the bits no field covers.
+  template <typename Module, typename Reference>
+  bool MatchesBaseline(Module& module, const char* name)
+  {
+    uint32_t mismatches = 0;
+    std::vector<std::array<uint8_t, 8>> payloads = Payloads();
+    for (std::array<uint8_t, 8>& payload : payloads)
+    {
+      Reference reference = {};
+      Baseline::Decode(reference, payload.data());
+      module.FromByteArray(payload.data());
+      uint8_t codec_bytes[8] = {};
+      uint8_t baseline_bytes[8] = {};
+      module.ToByteArray(codec_bytes);
+      Baseline::Encode(reference, baseline_bytes);
+      if(!Same(module, reference) || memcmp(codec_bytes, baseline_bytes, module.size_) != 0)
+      {
+        if(mismatches++ == 0)
+          printf("%s: first mismatch on %02X %02X %02X %02X %02X %02X %02X %02X\n", name, payload[0], payload[1],
+                 payload[2], payload[3], payload[4], payload[5], payload[6], payload[7]);
+      }
+      // Nothing is set that wasn't in the payload
+      uint64_t in = 0;
+      uint64_t out = 0;
+      memcpy(&in, payload.data(), module.size_);
+      memcpy(&out, codec_bytes, module.size_);
+      if(out & ~in)
+        ++mismatches;
+    }
+    return mismatches == 0;
+  }
+
+  void TestModulesAgainstBaseline()
+  {
+    MitsubaRx0 mitsuba0(0x08850225, 0);
+    MitsubaRx1 mitsuba1(0x08950225, 0);
+    MitsubaRx2 mitsuba2(0x08A50225, 0);
+    OrionBMSRx0 orion0(0x6B0, 0);
+    OrionBMSRx1 orion1(0x6B1, 0);
+    OrionBMSRx2 orion2(0x6B2, 0);
+    OrionBMSRx3 orion3(0x6B3, 0);
+    OrionBMSRx4 orion4(0x6B4, 0);
+    OrionBMSRx5 orion5(0x6B5, 0);
+    Steering steering;
+    Proton1 proton(0x600);
+    CHECK((MatchesBaseline<MitsubaRx0, Baseline::MitsubaRx0>(mitsuba0, "MitsubaRx0")));
+    CHECK((MatchesBaseline<MitsubaRx1, Baseline::MitsubaRx1>(mitsuba1, "MitsubaRx1")));
+    CHECK((MatchesBaseline<MitsubaRx2, Baseline::MitsubaRx2>(mitsuba2, "MitsubaRx2")));
+    CHECK((MatchesBaseline<OrionBMSRx0, Baseline::Words<4>>(orion0, "OrionBMSRx0")));
+    CHECK((MatchesBaseline<OrionBMSRx1, Baseline::OrionBMSRx1>(orion1, "OrionBMSRx1")));
+    CHECK((MatchesBaseline<OrionBMSRx2, Baseline::Words<4>>(orion2, "OrionBMSRx2")));
+    CHECK((MatchesBaseline<OrionBMSRx3, Baseline::Words<3>>(orion3, "OrionBMSRx3")));
+    CHECK((MatchesBaseline<OrionBMSRx4, Baseline::OrionBMSRx4>(orion4, "OrionBMSRx4")));
+    CHECK((MatchesBaseline<OrionBMSRx5, Baseline::Words<4>>(orion5, "OrionBMSRx5")));
+    CHECK((MatchesBaseline<Steering, Baseline::Steering>(steering, "Steering")));
+    CHECK((MatchesBaseline<Proton1, Baseline::Proton1>(proton, "Proton1")));
+
+    // Requests are only ever sent
+    MitsubaRequest request(0x08F89540);
+    for (uint8_t frames = 0; frames < 8; ++frames)
+    {
+      Baseline::MitsubaRequest reference = {static_cast<bool>(frames & 1), static_cast<bool>(frames & 2),
+                                            static_cast<bool>(frames & 4)};
+      request.SetRequests(reference.requestFrame0, reference.requestFrame1, reference.requestFrame2);
+      uint8_t codec_byte = 0xFF;
+      uint8_t baseline_byte = 0xFF;
+      request.ToByteArray(&codec_byte);
+      Baseline::Encode(reference, &baseline_byte);
+      CHECK(codec_byte == baseline_byte && codec_byte == frames);
+    }
+  }
+
+  // Hand picked values at the ends of the ranges, so a mistake is easy to read off
+  void TestModuleExtremes()
+  {
+    // Big endian signed current, most negative, most positive and -1
+    OrionBMSRx2 orion2(0x6B2, 0);
+    uint8_t current[8] = {0x01, 0x02, 0x03, 0x04, 0x80, 0x00, 0x05, 0x06};
+    orion2.FromByteArray(current);
+    CHECK(orion2.getPackDcl() == 0x0102 && orion2.getPackCcl() == 0x0304 && orion2.getConstantVal() == 0x0506);
+    CHECK(orion2.getPackCurrentFixed().Count() == -32768);
+    current[4] = 0x7F;
+    current[5] = 0xFF;
+    orion2.FromByteArray(current);
+    CHECK(orion2.getPackCurrentFixed().Count() == 32767);
+    current[4] = 0xFF;
+    orion2.FromByteArray(current);
+    CHECK(orion2.getPackCurrentFixed().Count() == -1);
+    CHECK(std::fabs(orion2.getPackCurrent() + 0.1f) < 1e-6f);
+    uint8_t out[8] = {};
+    orion2.ToByteArray(out);
+    CHECK(memcmp(out, current, sizeof(out)) == 0);
+
+    // Mitsuba fields that straddle bytes, each filled on its own
+    MitsubaRx0 mitsuba0(0x08850225, 0);
+    uint8_t duty[8] = {0, 0, 0, 0, 0, 0x80, 0xFF, 0x01};
+    mitsuba0.FromByteArray(duty);
+    CHECK(mitsuba0.GetPWMDutyFixed().Count() == 1023);
+    CHECK(mitsuba0.GetMotorRPM() == 0 && mitsuba0.GetLeadAngleFixed().Count() == 0);
+    uint8_t rpm[8] = {0, 0, 0, 0, 0xF8, 0x7F, 0, 0};
+    mitsuba0.FromByteArray(rpm);
+    CHECK(mitsuba0.GetMotorRPM() == 4095 && mitsuba0.GetFetTemp() == 0 && mitsuba0.GetPWMDutyFixed().Count() == 0);
+    uint8_t fet[8] = {0, 0, 0, 0xC0, 0x07, 0, 0, 0};
+    mitsuba0.FromByteArray(fet);
+    CHECK(mitsuba0.GetFetTemp() == 31 * 5 && mitsuba0.GetMotorCurrentPkAvg() == 0 && mitsuba0.GetMotorRPM() == 0);
+
+    // Reserved Mitsuba fault bits are dropped
+    MitsubaRx2 mitsuba2(0x08A50225, 0);
+    uint8_t faults[5] = {0x10, 0xF4, 0xD4, 0xF0, 0xFC};
+    mitsuba2.FromByteArray(faults);
+    CHECK(!mitsuba2.GetFaults().Any() && mitsuba2.GetOverHeatLevel() == 0);
+  }
+
+  // A layout with every kind of field, checked against bytes worked out by hand
+  struct Mixed {
+    uint8_t low;
+    int16_t crossing;
+    uint16_t motorola;
+    int32_t wide;
+    bool top;
+    using Layout = Codec<8,
+      Bind<&Mixed::low,       0,  3>,
+      Bind<&Mixed::crossing,  3, 13, Order::Little, true>,
+      Bind<&Mixed::motorola, 23, 12, Order::Big>,
+      Bind<&Mixed::wide,     32, 31, Order::Little, true>,
+      Bind<&Mixed::top,      63,  1>>;
+  };
+  struct Scaled {
+    float value;
+    using Layout = Codec<2, Bind<&Scaled::value, 7, 16, Order::Big, true, std::deci>>;
+  };
+
+  void TestFieldLayout()
+  {
+    Mixed mixed = {5, -1, 0xABC, 0, true};
+    uint8_t buff[8];
+    Mixed::Layout::Encode(mixed, buff);
+    // Bits 24-27 belong to no field and go out clear
+    uint8_t expected[8] = {0xFD, 0xFF, 0xAB, 0xC0, 0x00, 0x00, 0x00, 0x80};
+    CHECK(memcmp(buff, expected, sizeof(buff)) == 0);
+
+    // Signed ends of a 13 and a 31 bit field
+    mixed = {0, -4096, 0, -(1 << 30), false};
+    Mixed::Layout::Encode(mixed, buff);
+    uint8_t negative[8] = {0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40};
+    CHECK(memcmp(buff, negative, sizeof(buff)) == 0);
+    Mixed decoded = {};
+    Mixed::Layout::Decode(decoded, buff);
+    CHECK(decoded.crossing == -4096 && decoded.wide == -(1 << 30) && !decoded.top);
+    uint8_t positive[8] = {0xF8, 0x7F, 0xFF, 0xF0, 0xFF, 0xFF, 0xFF, 0x3F};
+    Mixed::Layout::Decode(decoded, positive);
+    CHECK(decoded.low == 0 && decoded.crossing == 4095 && decoded.motorola == 0xFFF && decoded.wide == (1 << 30) - 1);
+    CHECK(!decoded.top);
+    uint8_t unused[8] = {0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00};
+    Mixed::Layout::Decode(decoded, unused);
+    CHECK(decoded.low == 0 && decoded.crossing == 0 && decoded.motorola == 0 && decoded.wide == 0 && !decoded.top);
+
+    // Values too wide for their field are cut to it and leave the neighbours alone
+    mixed = {0xF, 0, 0xF000, 0, false};
+    Mixed::Layout::Encode(mixed, buff);
+    uint8_t truncated[8] = {0x07, 0, 0, 0, 0, 0, 0, 0};
+    CHECK(memcmp(buff, truncated, sizeof(buff)) == 0);
+
+    // Scaled floats round to the nearest step either side of zero
+    Scaled scaled = {-0.05f};
+    uint8_t word[2];
+    Scaled::Layout::Encode(scaled, word);
+    CHECK(word[0] == 0xFF && word[1] == 0xFF);
+    scaled.value = 3276.7f;
+    Scaled::Layout::Encode(scaled, word);
+    CHECK(word[0] == 0x7F && word[1] == 0xFF);
+    uint8_t lowest[2] = {0x80, 0x00};
+    Scaled::Layout::Decode(scaled, lowest);
+    CHECK(std::fabs(scaled.value + 3276.8f) < 1e-3f);
+    for (int32_t raw = -32768; raw < 32768; raw += 7)
+    {
+      uint8_t in[2] = {static_cast<uint8_t>(raw >> 8), static_cast<uint8_t>(raw)};
+      Scaled::Layout::Decode(scaled, in);
+      Scaled::Layout::Encode(scaled, word);
+      if(!CHECK(memcmp(in, word, sizeof(word)) == 0))
+        break;
+    }
+  }
+
+  // Steering went from 2 to 3 bytes, the cruise speed is in the third and nothing past it is written
+  void TestSteeringSize()
+  {
+    Steering steering;
+    CHECK(steering.size_ == 3);
+    uint8_t in[3] = {0x81, 0x01, 45};
+    steering.FromByteArray(in);
+    CHECK(steering.GetLeftTurnStatus() && steering.GetHornStatus() && steering.GetReverseStatus());
+    CHECK(!steering.GetHazardsStatus() && steering.GetCruiseSpeed() == 45);
+    uint8_t out[8];
+    memset(out, 0xAA, sizeof(out));
+    steering.ToByteArray(out);
+    CHECK(memcmp(out, in, sizeof(in)) == 0);
+    for (uint8_t i = sizeof(in); i < sizeof(out); ++i)
+      CHECK(out[i] == 0xAA);
+  }
+
+  // Decode then encode per frame, codec and baseline over the same payloads.
+  // Not a pass/fail check, timings on the host only hint at the target.
+  template <typename Module, typename Reference>
+  void TimeModule(Module& module, const char* name)
+  {
+    using Clock = std::chrono::steady_clock;
+    constexpr uint32_t ROUNDS = 200;
+    std::vector<std::array<uint8_t, 8>> payloads = Payloads();
+    volatile uint8_t sink = 0;
+    uint8_t out[8];
+    auto start = Clock::now();
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+      for (std::array<uint8_t, 8>& payload : payloads)
+      {
+        module.FromByteArray(payload.data());
+        module.ToByteArray(out);
+        sink = sink + out[0];
+      }
+    }
+    auto middle = Clock::now();
+    Reference reference;
+    for (uint32_t round = 0; round < ROUNDS; ++round)
+    {
+      for (std::array<uint8_t, 8>& payload : payloads)
+      {
+        Baseline::Decode(reference, payload.data());
+        Baseline::Encode(reference, out);
+        sink = sink + out[0];
+      }
+    }
+    auto end = Clock::now();
+    double frames = static_cast<double>(ROUNDS) * payloads.size();
+    printf("FieldCodecTest: %-11s codec %5.1f ns, baseline %5.1f ns per decode + encode\n", name,
+           std::chrono::duration<double, std::nano>(middle - start).count() / frames,
+           std::chrono::duration<double, std::nano>(end - middle).count() / frames);
+  }
+
+  void BenchmarkModules()
+  {
+    MitsubaRx0 mitsuba0(0x08850225, 0);
+    MitsubaRx1 mitsuba1(0x08950225, 0);
+    MitsubaRx2 mitsuba2(0x08A50225, 0);
+    OrionBMSRx0 orion0(0x6B0, 0);
+    OrionBMSRx1 orion1(0x6B1, 0);
+    OrionBMSRx2 orion2(0x6B2, 0);
+    OrionBMSRx3 orion3(0x6B3, 0);
+    OrionBMSRx4 orion4(0x6B4, 0);
+    OrionBMSRx5 orion5(0x6B5, 0);
+    Steering steering;
+    Proton1 proton(0x600);
+    TimeModule<MitsubaRx0, Baseline::MitsubaRx0>(mitsuba0, "MitsubaRx0");
+    TimeModule<MitsubaRx1, Baseline::MitsubaRx1>(mitsuba1, "MitsubaRx1");
+    TimeModule<MitsubaRx2, Baseline::MitsubaRx2>(mitsuba2, "MitsubaRx2");
+    TimeModule<OrionBMSRx0, Baseline::Words<4>>(orion0, "OrionBMSRx0");
+    TimeModule<OrionBMSRx1, Baseline::OrionBMSRx1>(orion1, "OrionBMSRx1");
+    TimeModule<OrionBMSRx2, Baseline::Words<4>>(orion2, "OrionBMSRx2");
+    TimeModule<OrionBMSRx3, Baseline::Words<3>>(orion3, "OrionBMSRx3");
+    TimeModule<OrionBMSRx4, Baseline::OrionBMSRx4>(orion4, "OrionBMSRx4");
+    TimeModule<OrionBMSRx5, Baseline::Words<4>>(orion5, "OrionBMSRx5");
+    TimeModule<Steering, Baseline::Steering>(steering, "Steering");
+    TimeModule<Proton1, Baseline::Proton1>(proton, "Proton1");
+  }
+}
+
+int main()
+{
+  TestFieldLayout();
+  TestModulesAgainstBaseline();
+  TestModuleExtremes();
+  TestSteeringSize();
+  BenchmarkModules();
+  return Test::Finish("FieldCodecTest");
+}
@@ -0,0 +1,61 @@
+/*
+ * HostNode.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: A real CANDriver on a fake bxCAN peripheral, with the HAL callbacks wired the way
+ *               the board's stm32f0xx_it code does. The driver is never destroyed, its rx task
+ *               keeps running until the test calls Test::Exit.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_HOSTNODE_HPP_
+#define SOLARGATORSBSP_TESTS_HOSTNODE_HPP_
+
+#include <CAN.hpp>
+#include "HostCan.hpp"
+
+#include <cstring>
+
+namespace Test
+{
+  struct HostNode {
+    explicit HostNode(uint32_t rx_fifo = CAN_RX_FIFO0, HostCan::FilterBanks* filters = nullptr, bool is_slave = false)
+      : can(*new HostCan::Peripheral(filters, is_slave)), driver(*new SolarGators::Drivers::CANDriver(can.Handle(), rx_fifo))
+    {
+      // The node itself can go out of scope, the handlers only hold on to the driver
+      SolarGators::Drivers::CANDriver* can_driver = &driver;
+      can.on_rx = [can_driver]() { can_driver->SetRxFlag(); };
+      can.on_tx = [can_driver]() { can_driver->HandleTxInterrupt(); };
+      can.on_error = [can_driver]() { can_driver->HandleErrorInterrupt(); };
+    }
+    HostCan::Peripheral& can;
+    SolarGators::Drivers::CANDriver& driver;
+  };
+
+  inline SolarGators::Drivers::CANFrame Frame(uint32_t id, bool is_ext, uint8_t dlc, const uint8_t* data = nullptr)
+  {
+    SolarGators::Drivers::CANFrame frame = {};
+    frame.id = id;
+    frame.is_ext = is_ext;
+    frame.dlc = dlc;
+    if(data != nullptr)
+      memcpy(frame.data, data, dlc < sizeof(frame.data) ? dlc : sizeof(frame.data));
+    return frame;
+  }
+
+  // Polls until done() holds, the rx task works on its own time. False after timeout_ms.
+  template <typename Fn>
+  bool WaitFor(Fn done, uint32_t timeout_ms = 1000)
+  {
+    uint32_t start = osKernelGetTickCount();
+    while(!done())
+    {
+      if(osKernelGetTickCount() - start >= timeout_ms)
+        return false;
+      osDelay(1);
+    }
+    return true;
+  }
+}
+
+#endif /* SOLARGATORSBSP_TESTS_HOSTNODE_HPP_ */
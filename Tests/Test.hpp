@@ -0,0 +1,44 @@
+/*
+ * Test.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Minimal checks for the host tests. A failed CHECK prints where it failed and the
+ *               test keeps going, Finish turns the count into the exit code.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_TEST_HPP_
+#define SOLARGATORSBSP_TESTS_TEST_HPP_
+
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(condition) ::Test::Check((condition), #condition, __FILE__, __LINE__)
+
+namespace Test
+{
+  inline int failures = 0;
+  inline bool Check(bool passed, const char* condition, const char* file, int line)
+  {
+    if(!passed)
+    {
+      ++failures;
+      printf("%s:%d: CHECK(%s) failed\n", file, line, condition);
+    }
+    return passed;
+  }
+  inline int Finish(const char* name)
+  {
+    printf("%s: %s\n", name, failures == 0 ? "passed" : "FAILED");
+    return failures == 0 ? 0 : 1;
+  }
+  // For tests that leave RTOS threads running, returning from main would destroy objects they use
+  [[noreturn]] inline void Exit(const char* name)
+  {
+    int status = Finish(name);
+    fflush(stdout);
+    std::_Exit(status);
+  }
+}
+
+#endif /* SOLARGATORSBSP_TESTS_TEST_HPP_ */
@@ -0,0 +1,115 @@
+/*
+ * CAN.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Stands in for the bxCAN driver in host tests of code layered on CANDriver. Sent
+ *               frames go into a queue that the test delivers to the registered modules, so one
+ *               fake is a bus every node under test shares.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_FAKES_CAN_HPP_
+#define SOLARGATORSBSP_TESTS_FAKES_CAN_HPP_
+
+#include <cmsis_os.h>
+#include "main.h"
+#include <DataModule.hpp>
+#include <CANFrame.hpp>
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace SolarGators {
+namespace Drivers {
+
+class CANDriver {
+public:
+  enum class TxStatus : uint8_t {
+    Queued,
+    Dropped,
+    Full,
+    Suppressed
+  };
+  enum class RegisterStatus : uint8_t {
+    Ok,
+    Duplicate,
+    TableFull,
+    FilterFull,
+    TooLarge,
+    NotFound,
+    Busy
+  };
+  static constexpr uint8_t MAX_DATA_SIZE = 8;
+  RegisterStatus AddRxModule(DataModules::DataModule* module, bool high_priority = false)
+  {
+    (void)high_priority;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!modules_.emplace(Key(module->can_id_, module->is_ext_id_), module).second)
+      return RegisterStatus::Duplicate;
+    return RegisterStatus::Ok;
+  }
+  TxStatus SendFrame(const CANFrame& frame)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(frame.is_fd || frame.Length() > MAX_DATA_SIZE)
+      return TxStatus::Dropped;
+    if(queue_.size() >= queue_limit_)
+      return TxStatus::Full;
+    queue_.push_back(frame);
+    sent_.push_back(frame);
+    return TxStatus::Queued;
+  }
+  // Hands the oldest queued frame to its module as the rx task would, false if none were queued
+  bool Deliver()
+  {
+    CANFrame frame;
+    DataModules::DataModule* module = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(queue_.empty())
+        return false;
+      frame = queue_.front();
+      queue_.pop_front();
+      auto it = modules_.find(Key(frame.id, frame.is_ext));
+      if(it != modules_.end())
+        module = it->second;
+    }
+    // Outside the lock, decoding can send frames of its own
+    if(module != nullptr && !frame.is_rtr)
+      module->Receive(frame.data, osKernelGetTickCount());
+    return true;
+  }
+  // Every frame ever queued, in order
+  std::vector<CANFrame> GetSent()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sent_;
+  }
+  void ClearSent()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sent_.clear();
+  }
+  void SetQueueLimit(size_t limit)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_limit_ = limit;
+  }
+private:
+  static uint32_t Key(uint32_t id, bool is_ext)
+  {
+    return id | (is_ext ? 0x80000000 : 0);
+  }
+  std::mutex mutex_;
+  std::map<uint32_t, DataModules::DataModule*> modules_;
+  std::deque<CANFrame> queue_;
+  std::vector<CANFrame> sent_;
+  size_t queue_limit_ = 16;
+};
+
+} /* namespace Drivers */
+} /* namespace SolarGators */
+
+#endif /* SOLARGATORSBSP_TESTS_FAKES_CAN_HPP_ */
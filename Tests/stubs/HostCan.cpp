@@ -0,0 +1,424 @@
+/*
+ * HostCan.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include "HostCan.hpp"
+#include <cmsis_os.h>
+
+#include <cstring>
+#include <map>
+
+namespace HostCan
+{
+  namespace {
+    std::mutex registry_mutex;
+    std::map<CAN_HandleTypeDef*, Peripheral*>& Registry()
+    {
+      static std::map<CAN_HandleTypeDef*, Peripheral*> registry;
+      return registry;
+    }
+
+    // Filter register layouts, see the bxCAN chapter of the reference manual
+    uint32_t Word32(uint32_t id, bool is_ext, bool is_rtr)
+    {
+      uint32_t rtr = is_rtr ? 1 << 1 : 0;
+      return is_ext ? (id << 3) | (1 << 2) | rtr : (id << 21) | rtr;
+    }
+
+    uint32_t Word16(uint32_t id, bool is_ext, bool is_rtr)
+    {
+      uint32_t rtr = is_rtr ? 1 << 4 : 0;
+      if(is_ext)
+        return (((id >> 18) & 0x7FF) << 5) | rtr | (1 << 3) | ((id >> 15) & 0x7);
+      return (id << 5) | rtr;
+    }
+
+    bool BankMatches(const CAN_FilterTypeDef& bank, const CANFrame& frame)
+    {
+      bool list = bank.FilterMode == CAN_FILTERMODE_IDLIST;
+      if(bank.FilterScale == CAN_FILTERSCALE_32BIT)
+      {
+        uint32_t fr1 = bank.FilterIdHigh << 16 | bank.FilterIdLow;
+        uint32_t fr2 = bank.FilterMaskIdHigh << 16 | bank.FilterMaskIdLow;
+        uint32_t word = Word32(frame.id, frame.is_ext, frame.is_rtr);
+        return list ? word == fr1 || word == fr2 : ((word ^ fr1) & fr2) == 0;
+      }
+      // The HAL writes FR1 from the "Low" fields and FR2 from the "High" fields in 16 bit scale
+      uint32_t halves[] = {bank.FilterIdLow, bank.FilterMaskIdLow, bank.FilterIdHigh, bank.FilterMaskIdHigh};
+      uint32_t word = Word16(frame.id, frame.is_ext, frame.is_rtr);
+      if(list)
+        return word == halves[0] || word == halves[1] || word == halves[2] || word == halves[3];
+      return ((word ^ halves[0]) & halves[1]) == 0 || ((word ^ halves[2]) & halves[3]) == 0;
+    }
+
+    uint32_t Priority(const CAN_TxHeaderTypeDef& header)
+    {
+      if(header.IDE == CAN_ID_EXT)
+        return ((header.ExtId >> 18) & 0x7FF) << 19 | (1 << 18) | (header.ExtId & 0x3FFFF);
+      return (header.StdId & 0x7FF) << 19;
+    }
+  }
+
+  Peripheral::Peripheral(FilterBanks* filters, bool is_slave): registers_{}, handle_{}, filters_(filters),
+      is_slave_(is_slave), started_(false), bus_fault_(false), failed_reads_(0), start_count_(0), abort_count_(0),
+      mailboxes_{}, peer_(nullptr)
+  {
+    if(filters_ == nullptr)
+      filters_ = &own_filters_;
+    registers_.BTR = BTR_500K;
+    handle_.Instance = &registers_;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Registry()[&handle_] = this;
+  }
+
+  Peripheral::~Peripheral()
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    Registry().erase(&handle_);
+  }
+
+  Peripheral* Peripheral::From(CAN_HandleTypeDef* hcan)
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    return Registry().at(hcan);
+  }
+
+  void Peripheral::Raise(const std::function<void()>& handler)
+  {
+    if(handler)
+      HostIrq::Interrupt(handler);
+  }
+
+  int Peripheral::Match(const CANFrame& frame) const
+  {
+    // A single CAN part scans every bank, on a dual part each instance only its own side of
+    // the slave start. 32 bit beats 16 bit, then list beats mask, then the lower bank wins.
+    uint32_t first = 0;
+    uint32_t last = filters_->count;
+    if(filters_->count > 14)
+    {
+      if(is_slave_)
+        first = filters_->slave_start;
+      else
+        last = filters_->slave_start;
+    }
+    int best = NOT_ACCEPTED;
+    int best_rank = 0;
+    for (uint32_t i = first; i < last && i < filters_->count; ++i)
+    {
+      const CAN_FilterTypeDef& bank = filters_->banks[i];
+      if(bank.FilterActivation != CAN_FILTER_ENABLE || !BankMatches(bank, frame))
+        continue;
+      int rank = (bank.FilterScale == CAN_FILTERSCALE_32BIT ? 2 : 0) + (bank.FilterMode == CAN_FILTERMODE_IDLIST ? 1 : 0);
+      if(best == NOT_ACCEPTED || rank > best_rank)
+      {
+        best = bank.FilterFIFOAssignment == CAN_FILTER_FIFO0 ? CAN_RX_FIFO0 : CAN_RX_FIFO1;
+        best_rank = rank;
+      }
+    }
+    return best;
+  }
+
+  int Peripheral::Receive(const CANFrame& frame)
+  {
+    int fifo;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if(!started_ || (registers_.ESR & CAN_ESR_BOFF))
+        return NOT_ACCEPTED;
+      fifo = Match(frame);
+      if(fifo == NOT_ACCEPTED)
+        return NOT_ACCEPTED;
+      if(fifos_[fifo].size() >= FIFO_DEPTH)
+      {
+        handle_.ErrorCode |= fifo == CAN_RX_FIFO0 ? HAL_CAN_ERROR_RX_FOV0 : HAL_CAN_ERROR_RX_FOV1;
+        fifo = OVERRUN;
+      }
+      else
+      {
+        Stored stored = {};
+        stored.header.IDE = frame.is_ext ? CAN_ID_EXT : CAN_ID_STD;
+        stored.header.StdId = frame.is_ext ? 0 : frame.id;
+        stored.header.ExtId = frame.is_ext ? frame.id : 0;
+        stored.header.RTR = frame.is_rtr ? CAN_RTR_REMOTE : CAN_RTR_DATA;
+        stored.header.DLC = frame.dlc & 0xF;
+        // The data registers are 8 bytes whatever the DLC says
+        memcpy(stored.data, frame.data, sizeof(stored.data));
+        fifos_[fifo].push_back(stored);
+      }
+    }
+    Raise(fifo == OVERRUN ? on_error : on_rx);
+    return fifo;
+  }
+
+  uint32_t Peripheral::Transmit(uint32_t max)
+  {
+    uint32_t sent = 0;
+    while(sent < max)
+    {
+      CANFrame frame = {};
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(!started_ || (registers_.ESR & CAN_ESR_BOFF))
+          break;
+        int best = -1;
+        for (int i = 0; i < MAILBOXES; ++i)
+        {
+          if(mailboxes_[i].loaded && (best < 0 || Priority(mailboxes_[i].header) < Priority(mailboxes_[best].header)))
+            best = i;
+        }
+        if(best < 0)
+          break;
+        Mailbox& mailbox = mailboxes_[best];
+        frame.is_ext = mailbox.header.IDE == CAN_ID_EXT;
+        frame.id = frame.is_ext ? mailbox.header.ExtId : mailbox.header.StdId;
+        frame.is_rtr = mailbox.header.RTR == CAN_RTR_REMOTE;
+        frame.dlc = mailbox.header.DLC;
+        frame.tick = osKernelGetTickCount();
+        memcpy(frame.data, mailbox.data, sizeof(mailbox.data));
+        mailbox.loaded = false;
+        sent_.push_back(frame);
+      }
+      ++sent;
+      if(peer_ != nullptr)
+        peer_->Receive(frame);
+      Raise(on_tx);
+    }
+    return sent;
+  }
+
+  void Peripheral::Connect(Peripheral* other)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer_ = other;
+  }
+
+  std::vector<CANFrame> Peripheral::TakeSent()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<CANFrame> sent;
+    sent.swap(sent_);
+    return sent;
+  }
+
+  uint8_t Peripheral::GetPendingMailboxes()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint8_t pending = 0;
+    for (const Mailbox& mailbox : mailboxes_)
+      pending += mailbox.loaded ? 1 : 0;
+    return pending;
+  }
+
+  void Peripheral::SetErrorCounters(uint16_t tec, uint8_t rec)
+  {
+    uint32_t raised;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint32_t esr = (tec > 255 ? 255 : tec) << CAN_ESR_TEC_Pos | static_cast<uint32_t>(rec) << CAN_ESR_REC_Pos;
+      if(tec >= 96 || rec >= 96)
+        esr |= CAN_ESR_EWGF;
+      if(tec > 127 || rec > 127)
+        esr |= CAN_ESR_EPVF;
+      if(tec > 255)
+        esr |= CAN_ESR_BOFF;
+      uint32_t entered = esr & ~registers_.ESR;
+      registers_.ESR = esr;
+      raised = (entered & CAN_ESR_EWGF ? HAL_CAN_ERROR_EWG : 0) | (entered & CAN_ESR_EPVF ? HAL_CAN_ERROR_EPV : 0) |
+               (entered & CAN_ESR_BOFF ? HAL_CAN_ERROR_BOF : 0);
+      handle_.ErrorCode |= raised;
+    }
+    if(raised)
+      Raise(on_error);
+  }
+
+  void Peripheral::SetBusFault(bool fault)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bus_fault_ = fault;
+  }
+
+  void Peripheral::FailRxReads(uint32_t count)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_reads_ = count;
+  }
+
+  uint32_t Peripheral::GetStartCount()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return start_count_;
+  }
+
+  uint32_t Peripheral::GetAbortCount()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return abort_count_;
+  }
+
+  bool Peripheral::IsStarted()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return started_;
+  }
+
+  HAL_StatusTypeDef Peripheral::ConfigFilter(const CAN_FilterTypeDef& config)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(config.FilterBank >= filters_->count)
+      return HAL_ERROR;
+    filters_->banks[config.FilterBank] = config;
+    if(filters_->count > 14)
+      filters_->slave_start = config.SlaveStartFilterBank;
+    return HAL_OK;
+  }
+
+  HAL_StatusTypeDef Peripheral::Start()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(started_)
+      return HAL_ERROR;
+    started_ = true;
+    ++start_count_;
+    // Leaving initialisation mode runs the bus-off recovery, which only completes on a working bus
+    if((registers_.ESR & CAN_ESR_BOFF) && !bus_fault_)
+      registers_.ESR = 0;
+    return HAL_OK;
+  }
+
+  HAL_StatusTypeDef Peripheral::Stop()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!started_)
+      return HAL_ERROR;
+    started_ = false;
+    return HAL_OK;
+  }
+
+  uint32_t Peripheral::GetRxFifoFillLevel(uint32_t fifo)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fifos_[fifo & 1].size();
+  }
+
+  HAL_StatusTypeDef Peripheral::GetRxMessage(uint32_t fifo, CAN_RxHeaderTypeDef* header, uint8_t* data)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(failed_reads_ != 0)
+    {
+      --failed_reads_;
+      return HAL_ERROR;
+    }
+    std::deque<Stored>& stored = fifos_[fifo & 1];
+    if(stored.empty())
+      return HAL_ERROR;
+    *header = stored.front().header;
+    memcpy(data, stored.front().data, sizeof(stored.front().data));
+    stored.pop_front();
+    return HAL_OK;
+  }
+
+  uint32_t Peripheral::GetTxMailboxesFreeLevel()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t free = 0;
+    for (const Mailbox& mailbox : mailboxes_)
+      free += mailbox.loaded ? 0 : 1;
+    return free;
+  }
+
+  HAL_StatusTypeDef Peripheral::AddTxMessage(const CAN_TxHeaderTypeDef* header, const uint8_t* data, uint32_t* mailbox)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < MAILBOXES; ++i)
+    {
+      if(mailboxes_[i].loaded)
+        continue;
+      mailboxes_[i].loaded = true;
+      mailboxes_[i].header = *header;
+      memcpy(mailboxes_[i].data, data, sizeof(mailboxes_[i].data));
+      *mailbox = CAN_TX_MAILBOX0 << i;
+      return HAL_OK;
+    }
+    return HAL_ERROR;
+  }
+
+  HAL_StatusTypeDef Peripheral::AbortTxRequest(uint32_t mailboxes)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < MAILBOXES; ++i)
+    {
+      if(mailboxes & (CAN_TX_MAILBOX0 << i))
+        mailboxes_[i].loaded = false;
+    }
+    ++abort_count_;
+    return HAL_OK;
+  }
+}
+
+using HostCan::Peripheral;
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef* hcan, const CAN_FilterTypeDef* sFilterConfig)
+{
+  return Peripheral::From(hcan)->ConfigFilter(*sFilterConfig);
+}
+
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef* hcan)
+{
+  return Peripheral::From(hcan)->Start();
+}
+
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef* hcan)
+{
+  return Peripheral::From(hcan)->Stop();
+}
+
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef* hcan, uint32_t ActiveITs)
+{
+  hcan->Instance->IER |= ActiveITs;
+  return HAL_OK;
+}
+
+uint32_t HAL_CAN_GetRxFifoFillLevel(CAN_HandleTypeDef* hcan, uint32_t RxFifo)
+{
+  return Peripheral::From(hcan)->GetRxFifoFillLevel(RxFifo);
+}
+
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t RxFifo, CAN_RxHeaderTypeDef* pHeader, uint8_t aData[])
+{
+  return Peripheral::From(hcan)->GetRxMessage(RxFifo, pHeader, aData);
+}
+
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(CAN_HandleTypeDef* hcan)
+{
+  return Peripheral::From(hcan)->GetTxMailboxesFreeLevel();
+}
+
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, CAN_TxHeaderTypeDef* pHeader, uint8_t aData[], uint32_t* pTxMailbox)
+{
+  return Peripheral::From(hcan)->AddTxMessage(pHeader, aData, pTxMailbox);
+}
+
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef* hcan, uint32_t TxMailboxes)
+{
+  return Peripheral::From(hcan)->AbortTxRequest(TxMailboxes);
+}
+
+uint32_t HAL_CAN_GetError(CAN_HandleTypeDef* hcan)
+{
+  return hcan->ErrorCode;
+}
+
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef* hcan)
+{
+  hcan->ErrorCode = HAL_CAN_ERROR_NONE;
+  return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq()
+{
+  return Peripheral::PCLK1;
+}
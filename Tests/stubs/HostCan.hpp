@@ -0,0 +1,118 @@
+/*
+ * HostCan.hpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: A bxCAN peripheral for host tests of the real CANDriver. It has the filter banks,
+ *               two 3 frame rx fifos, three tx mailboxes and the error counters the driver reads,
+ *               behind the HAL functions in stm32f0xx_hal.h. Tests put frames on the bus, move the
+ *               mailboxes onto it and push the error counters around, the peripheral raises the
+ *               interrupts the HAL callbacks would.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_STUBS_HOSTCAN_HPP_
+#define SOLARGATORSBSP_TESTS_STUBS_HOSTCAN_HPP_
+
+#include "main.h"
+#include <CANFrame.hpp>
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace HostCan
+{
+  using SolarGators::Drivers::CANFrame;
+
+  // Filter banks of one chip. Dual bxCAN parts have 28 shared by both instances, CAN2 owning the
+  // banks from the slave start the last filter write set.
+  struct FilterBanks {
+    static constexpr uint8_t MAX_BANKS = 28;
+    explicit FilterBanks(uint8_t count = 14): count(count), slave_start(14), banks{} {}
+    uint8_t count;
+    uint32_t slave_start;
+    CAN_FilterTypeDef banks[MAX_BANKS];
+  };
+
+  class Peripheral {
+  public:
+    static constexpr uint8_t FIFO_DEPTH = 3;
+    static constexpr uint8_t MAILBOXES = 3;
+    static constexpr uint32_t PCLK1 = 48000000;
+    // Single CAN parts get filter banks of their own. is_slave makes it CAN2 of a dual part.
+    explicit Peripheral(FilterBanks* filters = nullptr, bool is_slave = false);
+    ~Peripheral();
+    CAN_HandleTypeDef* Handle() { return &handle_; }
+    // What the HAL interrupt callbacks do, wired up by the test. They run with interrupts masked.
+    std::function<void()> on_rx;                   // HAL_CAN_RxFifo0/1MsgPendingCallback
+    std::function<void()> on_tx;                   // HAL_CAN_TxMailbox0/1/2CompleteCallback
+    std::function<void()> on_error;                // HAL_CAN_ErrorCallback
+    // A frame from the bus. dlc is put in the header as it is, like the hardware does.
+    // Returns the fifo it was stored in, NOT_ACCEPTED if the filters dropped it, or
+    // OVERRUN if the fifo was full.
+    static constexpr int NOT_ACCEPTED = -1;
+    static constexpr int OVERRUN = -2;
+    int Receive(const CANFrame& frame);
+    // Puts up to max frames on the bus one at a time, always the loaded mailbox with the lowest ID
+    // as bxCAN does. Each frame goes to the connected peripheral and the sent log, then the tx
+    // interrupt fires and can load the next one. Nothing goes out while stopped or bus-off.
+    // Returns the number of frames sent.
+    uint32_t Transmit(uint32_t max = UINT32_MAX);
+    void Connect(Peripheral* other);               // Frames this one sends are received by other
+    std::vector<CANFrame> TakeSent();              // Frames sent since the last call
+    uint8_t GetPendingMailboxes();
+    // Moves TEC and REC, a TEC above 255 is bus-off. Entering warning, passive or bus-off
+    // raises the error interrupt.
+    void SetErrorCounters(uint16_t tec, uint8_t rec);
+    // While the bus is broken a restart doesn't bring the node back from bus-off
+    void SetBusFault(bool fault);
+    // The next count HAL_CAN_GetRxMessage calls fail and leave the fifo alone
+    void FailRxReads(uint32_t count);
+    uint32_t GetStartCount();
+    uint32_t GetAbortCount();
+    bool IsStarted();
+    // Bit timing for 500kbit/s from PCLK1: 16 time quanta per bit with a prescaler of 6
+    static constexpr uint32_t BTR_500K = (5 << CAN_BTR_BRP_Pos) | (12 << CAN_BTR_TS1_Pos) | (1 << CAN_BTR_TS2_Pos);
+
+    // HAL side, called through the functions in stm32f0xx_hal.h
+    static Peripheral* From(CAN_HandleTypeDef* hcan);
+    HAL_StatusTypeDef ConfigFilter(const CAN_FilterTypeDef& config);
+    HAL_StatusTypeDef Start();
+    HAL_StatusTypeDef Stop();
+    uint32_t GetRxFifoFillLevel(uint32_t fifo);
+    HAL_StatusTypeDef GetRxMessage(uint32_t fifo, CAN_RxHeaderTypeDef* header, uint8_t* data);
+    uint32_t GetTxMailboxesFreeLevel();
+    HAL_StatusTypeDef AddTxMessage(const CAN_TxHeaderTypeDef* header, const uint8_t* data, uint32_t* mailbox);
+    HAL_StatusTypeDef AbortTxRequest(uint32_t mailboxes);
+  private:
+    struct Stored {
+      CAN_RxHeaderTypeDef header;
+      uint8_t data[8];
+    };
+    struct Mailbox {
+      bool loaded;
+      CAN_TxHeaderTypeDef header;
+      uint8_t data[8];
+    };
+    int Match(const CANFrame& frame) const;
+    static void Raise(const std::function<void()>& handler);
+    std::mutex mutex_;
+    CAN_TypeDef registers_;
+    CAN_HandleTypeDef handle_;
+    FilterBanks own_filters_;
+    FilterBanks* filters_;
+    bool is_slave_;
+    bool started_;
+    bool bus_fault_;
+    uint32_t failed_reads_;
+    uint32_t start_count_;
+    uint32_t abort_count_;
+    std::deque<Stored> fifos_[2];
+    Mailbox mailboxes_[MAILBOXES];
+    std::vector<CANFrame> sent_;
+    Peripheral* peer_;
+  };
+}
+
+#endif /* SOLARGATORSBSP_TESTS_STUBS_HOSTCAN_HPP_ */
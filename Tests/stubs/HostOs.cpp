@@ -0,0 +1,224 @@
+/*
+ * HostOs.cpp
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ */
+
+#include <cmsis_os.h>
+#include "main.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+namespace {
+  struct Flags {
+    std::mutex mutex;
+    std::condition_variable changed;
+    uint32_t bits = 0;
+  };
+  thread_local Flags* current_thread = nullptr;
+
+  uint32_t SetFlags(Flags* flags, uint32_t bits)
+  {
+    std::lock_guard<std::mutex> lock(flags->mutex);
+    flags->bits |= bits;
+    flags->changed.notify_all();
+    return flags->bits;
+  }
+
+  uint32_t WaitFlags(Flags* flags, uint32_t bits, uint32_t options, uint32_t timeout)
+  {
+    std::unique_lock<std::mutex> lock(flags->mutex);
+    auto ready = [&]() {
+      return (options & osFlagsWaitAll) ? (flags->bits & bits) == bits : (flags->bits & bits) != 0;
+    };
+    if(timeout == osWaitForever)
+      flags->changed.wait(lock, ready);
+    else if(!flags->changed.wait_for(lock, std::chrono::milliseconds(timeout), ready))
+      return osFlagsErrorTimeout;
+    uint32_t result = flags->bits;
+    if(!(options & osFlagsNoClear))
+      flags->bits &= ~bits;
+    return result;
+  }
+
+  struct Timer {
+    osTimerFunc_t func;
+    void* argument;
+    bool periodic;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool running = false;
+    uint32_t generation = 0;                      // Bumped by every start and stop
+    uint32_t period = 0;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  void RunTimer(Timer* timer)
+  {
+    std::unique_lock<std::mutex> lock(timer->mutex);
+    while(true)
+    {
+      timer->changed.wait(lock, [&]() { return timer->running; });
+      uint32_t generation = timer->generation;
+      if(timer->changed.wait_until(lock, timer->deadline, [&]() { return timer->generation != generation; }))
+        continue;
+      if(timer->periodic)
+        timer->deadline += std::chrono::milliseconds(timer->period);
+      else
+        timer->running = false;
+      lock.unlock();
+      timer->func(timer->argument);
+      lock.lock();
+    }
+  }
+}
+
+void Error_Handler()
+{
+  fprintf(stderr, "Error_Handler\n");
+  abort();
+}
+
+uint32_t osKernelGetTickCount()
+{
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint32_t osKernelGetTickFreq()
+{
+  return 1000;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+  return osOK;
+}
+
+osMutexId_t osMutexNew(const osMutexAttr_t*)
+{
+  return new std::recursive_timed_mutex;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+  auto* mutex = static_cast<std::recursive_timed_mutex*>(mutex_id);
+  if(timeout == osWaitForever)
+  {
+    mutex->lock();
+    return osOK;
+  }
+  if(timeout == 0)
+    return mutex->try_lock() ? osOK : osErrorResource;
+  return mutex->try_lock_for(std::chrono::milliseconds(timeout)) ? osOK : osErrorTimeout;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+  static_cast<std::recursive_timed_mutex*>(mutex_id)->unlock();
+  return osOK;
+}
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t*)
+{
+  Flags* flags = new Flags;
+  std::thread([=]() {
+    current_thread = flags;
+    func(argument);
+  }).detach();
+  return flags;
+}
+
+uint32_t osThreadGetStackSpace(osThreadId_t)
+{
+  return 0;
+}
+
+osThreadId_t osThreadGetId()
+{
+  if(current_thread == nullptr)
+    current_thread = new Flags;
+  return current_thread;
+}
+
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags)
+{
+  return SetFlags(static_cast<Flags*>(thread_id), flags);
+}
+
+uint32_t osThreadFlagsClear(uint32_t flags)
+{
+  Flags* self = static_cast<Flags*>(osThreadGetId());
+  std::lock_guard<std::mutex> lock(self->mutex);
+  uint32_t previous = self->bits;
+  self->bits &= ~flags;
+  return previous;
+}
+
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout)
+{
+  return WaitFlags(static_cast<Flags*>(osThreadGetId()), flags, options, timeout);
+}
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t*)
+{
+  return new Flags;
+}
+
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags)
+{
+  return SetFlags(static_cast<Flags*>(ef_id), flags);
+}
+
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout)
+{
+  return WaitFlags(static_cast<Flags*>(ef_id), flags, options, timeout);
+}
+
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t*)
+{
+  Timer* timer = new Timer;
+  timer->func = func;
+  timer->argument = argument;
+  timer->periodic = type == osTimerPeriodic;
+  std::thread(RunTimer, timer).detach();
+  return timer;
+}
+
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks)
+{
+  Timer* timer = static_cast<Timer*>(timer_id);
+  std::lock_guard<std::mutex> lock(timer->mutex);
+  timer->period = ticks;
+  timer->deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ticks);
+  timer->running = true;
+  ++timer->generation;
+  timer->changed.notify_all();
+  return osOK;
+}
+
+osStatus_t osTimerStop(osTimerId_t timer_id)
+{
+  Timer* timer = static_cast<Timer*>(timer_id);
+  std::lock_guard<std::mutex> lock(timer->mutex);
+  if(!timer->running)
+    return osErrorResource;
+  timer->running = false;
+  ++timer->generation;
+  timer->changed.notify_all();
+  return osOK;
+}
+
+uint32_t osTimerIsRunning(osTimerId_t timer_id)
+{
+  Timer* timer = static_cast<Timer*>(timer_id);
+  std::lock_guard<std::mutex> lock(timer->mutex);
+  return timer->running ? 1 : 0;
+}
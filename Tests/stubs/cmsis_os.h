@@ -0,0 +1,119 @@
+/*
+ * cmsis_os.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: The part of CMSIS-RTOS2 the drivers use, on top of std::thread so the hardware
+ *               independent code can be tested on a PC. Ticks are milliseconds of real time.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_STUBS_CMSIS_OS_H_
+#define SOLARGATORSBSP_TESTS_STUBS_CMSIS_OS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+typedef void* osMutexId_t;
+typedef void* osThreadId_t;
+typedef void* osEventFlagsId_t;
+typedef void* osTimerId_t;
+typedef void (*osThreadFunc_t)(void* argument);
+typedef void (*osTimerFunc_t)(void* argument);
+
+typedef enum {
+  osOK = 0,
+  osError = -1,
+  osErrorTimeout = -2,
+  osErrorResource = -3,
+  osErrorParameter = -4
+} osStatus_t;
+
+typedef enum {
+  osPriorityNone = 0,
+  osPriorityLow = 8,
+  osPriorityBelowNormal = 16,
+  osPriorityNormal = 24,
+  osPriorityAboveNormal = 32,
+  osPriorityHigh = 40,
+  osPriorityRealtime = 48
+} osPriority_t;
+
+typedef enum {
+  osTimerOnce = 0,
+  osTimerPeriodic = 1
+} osTimerType_t;
+
+#define osWaitForever 0xFFFFFFFFU
+#define osFlagsWaitAny 0x00000000U
+#define osFlagsWaitAll 0x00000001U
+#define osFlagsNoClear 0x00000002U
+#define osFlagsError 0x80000000U
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+#define osFlagsErrorParameter 0xFFFFFFFCU
+#define osMutexRecursive 0x00000001U
+#define osMutexPrioInherit 0x00000002U
+
+// Control blocks are only sized, the host objects are allocated
+typedef struct { uint8_t reserved[8]; } StaticSemaphore_t;
+typedef struct { uint8_t reserved[8]; } StaticTask_t;
+typedef struct { uint8_t reserved[8]; } StaticTimer_t;
+typedef struct { uint8_t reserved[8]; } StaticEventGroup_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+} osMutexAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+} osEventFlagsAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+} osTimerAttr_t;
+
+typedef struct {
+  const char* name;
+  uint32_t attr_bits;
+  void* cb_mem;
+  uint32_t cb_size;
+  void* stack_mem;
+  uint32_t stack_size;
+  osPriority_t priority;
+} osThreadAttr_t;
+
+uint32_t osKernelGetTickCount();
+uint32_t osKernelGetTickFreq();
+osStatus_t osDelay(uint32_t ticks);
+
+osMutexId_t osMutexNew(const osMutexAttr_t* attr);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void* argument, const osThreadAttr_t* attr);
+osThreadId_t osThreadGetId();
+// There is no fill pattern to measure on the host, always reports 0
+uint32_t osThreadGetStackSpace(osThreadId_t thread_id);
+uint32_t osThreadFlagsSet(osThreadId_t thread_id, uint32_t flags);
+uint32_t osThreadFlagsClear(uint32_t flags);
+uint32_t osThreadFlagsWait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+osEventFlagsId_t osEventFlagsNew(const osEventFlagsAttr_t* attr);
+uint32_t osEventFlagsSet(osEventFlagsId_t ef_id, uint32_t flags);
+uint32_t osEventFlagsWait(osEventFlagsId_t ef_id, uint32_t flags, uint32_t options, uint32_t timeout);
+
+// Callbacks run on a thread per timer, like the timer task they never overlap for one timer
+osTimerId_t osTimerNew(osTimerFunc_t func, osTimerType_t type, void* argument, const osTimerAttr_t* attr);
+osStatus_t osTimerStart(osTimerId_t timer_id, uint32_t ticks);
+osStatus_t osTimerStop(osTimerId_t timer_id);
+uint32_t osTimerIsRunning(osTimerId_t timer_id);
+
+#endif /* SOLARGATORSBSP_TESTS_STUBS_CMSIS_OS_H_ */
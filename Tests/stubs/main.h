@@ -0,0 +1,68 @@
+/*
+ * main.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Host stand in for the CubeMX main.h.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_STUBS_MAIN_H_
+#define SOLARGATORSBSP_TESTS_STUBS_MAIN_H_
+
+#include <cstdint>
+#include <mutex>
+#include "stm32f0xx_hal.h"
+
+// Interrupts are modelled as one lock. Masking them takes it and the fake peripherals run their
+// interrupt handlers under it, so a critical section keeps the "ISR" out the way it does on target.
+namespace HostIrq
+{
+  inline std::mutex& Lock()
+  {
+    static std::mutex lock;
+    return lock;
+  }
+  inline thread_local bool masked = false;
+}
+
+inline uint32_t __get_PRIMASK() { return HostIrq::masked ? 1 : 0; }
+inline void __disable_irq()
+{
+  if(!HostIrq::masked)
+  {
+    HostIrq::Lock().lock();
+    HostIrq::masked = true;
+  }
+}
+inline void __enable_irq()
+{
+  if(HostIrq::masked)
+  {
+    HostIrq::masked = false;
+    HostIrq::Lock().unlock();
+  }
+}
+inline void __set_PRIMASK(uint32_t primask)
+{
+  if(primask)
+    __disable_irq();
+  else
+    __enable_irq();
+}
+
+namespace HostIrq
+{
+  // Runs an interrupt handler, nested calls from inside a handler run straight through
+  template <typename Fn>
+  void Interrupt(Fn fn)
+  {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    fn();
+    __set_PRIMASK(primask);
+  }
+}
+
+void Error_Handler();
+
+#endif /* SOLARGATORSBSP_TESTS_STUBS_MAIN_H_ */
@@ -0,0 +1,136 @@
+/*
+ * stm32f0xx_hal.h
+ *
+ *  Created on: Oct 16, 2026
+ *      Author: agent
+ *  Description: Host stand in for the part of the STM32 HAL the CAN driver uses. The functions are
+ *               implemented by the fake peripheral in HostCan.cpp, register layouts and constants
+ *               follow the reference manual where the driver decodes them.
+ */
+
+#ifndef SOLARGATORSBSP_TESTS_STUBS_STM32F0XX_HAL_H_
+#define SOLARGATORSBSP_TESTS_STUBS_STM32F0XX_HAL_H_
+
+#include <cstdint>
+
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR = 1,
+  HAL_BUSY = 2,
+  HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+#define DISABLE 0U
+#define ENABLE 1U
+
+typedef struct {
+  volatile uint32_t MCR;
+  volatile uint32_t MSR;
+  volatile uint32_t TSR;
+  volatile uint32_t RF0R;
+  volatile uint32_t RF1R;
+  volatile uint32_t IER;
+  volatile uint32_t ESR;
+  volatile uint32_t BTR;
+} CAN_TypeDef;
+
+typedef struct {
+  CAN_TypeDef* Instance;
+  volatile uint32_t ErrorCode;
+} CAN_HandleTypeDef;
+
+typedef struct {
+  uint32_t FilterIdHigh;
+  uint32_t FilterIdLow;
+  uint32_t FilterMaskIdHigh;
+  uint32_t FilterMaskIdLow;
+  uint32_t FilterFIFOAssignment;
+  uint32_t FilterBank;
+  uint32_t FilterMode;
+  uint32_t FilterScale;
+  uint32_t FilterActivation;
+  uint32_t SlaveStartFilterBank;
+} CAN_FilterTypeDef;
+
+typedef struct {
+  uint32_t StdId;
+  uint32_t ExtId;
+  uint32_t IDE;
+  uint32_t RTR;
+  uint32_t DLC;
+  uint32_t Timestamp;
+  uint32_t FilterMatchIndex;
+} CAN_RxHeaderTypeDef;
+
+typedef struct {
+  uint32_t StdId;
+  uint32_t ExtId;
+  uint32_t IDE;
+  uint32_t RTR;
+  uint32_t DLC;
+  uint32_t TransmitGlobalTime;
+} CAN_TxHeaderTypeDef;
+
+#define CAN_ID_STD 0x00000000U
+#define CAN_ID_EXT 0x00000004U
+#define CAN_RTR_DATA 0x00000000U
+#define CAN_RTR_REMOTE 0x00000002U
+#define CAN_RX_FIFO0 0x00000000U
+#define CAN_RX_FIFO1 0x00000001U
+#define CAN_FILTER_FIFO0 0x00000000U
+#define CAN_FILTER_FIFO1 0x00000001U
+#define CAN_FILTER_DISABLE 0x00000000U
+#define CAN_FILTER_ENABLE 0x00000001U
+#define CAN_FILTERMODE_IDMASK 0x00000000U
+#define CAN_FILTERMODE_IDLIST 0x00000001U
+#define CAN_FILTERSCALE_16BIT 0x00000000U
+#define CAN_FILTERSCALE_32BIT 0x00000001U
+#define CAN_TX_MAILBOX0 0x00000001U
+#define CAN_TX_MAILBOX1 0x00000002U
+#define CAN_TX_MAILBOX2 0x00000004U
+
+#define CAN_IT_TX_MAILBOX_EMPTY 0x00000001U
+#define CAN_IT_RX_FIFO0_MSG_PENDING 0x00000002U
+#define CAN_IT_RX_FIFO0_OVERRUN 0x00000008U
+#define CAN_IT_RX_FIFO1_MSG_PENDING 0x00000010U
+#define CAN_IT_RX_FIFO1_OVERRUN 0x00000040U
+#define CAN_IT_ERROR_WARNING 0x00000100U
+#define CAN_IT_ERROR_PASSIVE 0x00000200U
+#define CAN_IT_BUSOFF 0x00000400U
+#define CAN_IT_ERROR 0x00008000U
+
+#define HAL_CAN_ERROR_NONE 0x00000000U
+#define HAL_CAN_ERROR_EWG 0x00000001U
+#define HAL_CAN_ERROR_EPV 0x00000002U
+#define HAL_CAN_ERROR_BOF 0x00000004U
+#define HAL_CAN_ERROR_RX_FOV0 0x00000200U
+#define HAL_CAN_ERROR_RX_FOV1 0x00000400U
+
+#define CAN_ESR_EWGF 0x00000001U
+#define CAN_ESR_EPVF 0x00000002U
+#define CAN_ESR_BOFF 0x00000004U
+#define CAN_ESR_TEC_Pos 16U
+#define CAN_ESR_TEC (0xFFU << CAN_ESR_TEC_Pos)
+#define CAN_ESR_REC_Pos 24U
+#define CAN_ESR_REC (0xFFU << CAN_ESR_REC_Pos)
+#define CAN_BTR_BRP_Pos 0U
+#define CAN_BTR_BRP (0x3FFU << CAN_BTR_BRP_Pos)
+#define CAN_BTR_TS1_Pos 16U
+#define CAN_BTR_TS1 (0xFU << CAN_BTR_TS1_Pos)
+#define CAN_BTR_TS2_Pos 20U
+#define CAN_BTR_TS2 (0x7U << CAN_BTR_TS2_Pos)
+
+HAL_StatusTypeDef HAL_CAN_ConfigFilter(CAN_HandleTypeDef* hcan, const CAN_FilterTypeDef* sFilterConfig);
+HAL_StatusTypeDef HAL_CAN_Start(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_Stop(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_ActivateNotification(CAN_HandleTypeDef* hcan, uint32_t ActiveITs);
+uint32_t HAL_CAN_GetRxFifoFillLevel(CAN_HandleTypeDef* hcan, uint32_t RxFifo);
+HAL_StatusTypeDef HAL_CAN_GetRxMessage(CAN_HandleTypeDef* hcan, uint32_t RxFifo, CAN_RxHeaderTypeDef* pHeader, uint8_t aData[]);
+uint32_t HAL_CAN_GetTxMailboxesFreeLevel(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_AddTxMessage(CAN_HandleTypeDef* hcan, CAN_TxHeaderTypeDef* pHeader, uint8_t aData[], uint32_t* pTxMailbox);
+HAL_StatusTypeDef HAL_CAN_AbortTxRequest(CAN_HandleTypeDef* hcan, uint32_t TxMailboxes);
+uint32_t HAL_CAN_GetError(CAN_HandleTypeDef* hcan);
+HAL_StatusTypeDef HAL_CAN_ResetError(CAN_HandleTypeDef* hcan);
+uint32_t HAL_RCC_GetPCLK1Freq();
+
+#endif /* SOLARGATORSBSP_TESTS_STUBS_STM32F0XX_HAL_H_ */
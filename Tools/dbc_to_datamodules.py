@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""
+dbc_to_datamodules.py
+
+  Created on: Oct 16, 2026
+      Author: agent
+  Description: Generates DataModule classes from a DBC file. Every message becomes a class with
+               its CAN ID and size as constants, a member per signal, getters that apply the DBC
+               scale and offset, and a FieldCodec layout for ToByteArray/FromByteArray. Getters
+               call Sync so the modules can be used in lazy mode. A registration list holds one
+               instance of every message so they can be added to a CAN driver in one loop.
+
+Usage:
+  dbc_to_datamodules.py orion.dbc --name OrionBMS2 [--prefix Orion] [--inc DataModules/inc] [--src DataModules/src]
+
+Multiplexed signals, messages over 8 bytes and signals over 32 bits are not supported by the
+codec and are reported as errors.
+"""
+
+import argparse
+import datetime
+import os
+import re
+import sys
+
+MESSAGE_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+(\w+)')
+SIGNAL_RE = re.compile(r'^SG_\s+(\w+)\s*(\w+)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*\(([^,]+),([^)]+)\)'
+                       r'\s*\[([^|]*)\|([^\]]*)\]\s*"([^"]*)"')
+EXT_FLAG = 0x80000000
+
+
+class Signal:
+  def __init__(self, name, start, length, little, signed, scale, offset, unit):
+    self.name = name
+    self.start = start
+    self.length = length
+    self.little = little
+    self.signed = signed
+    self.scale = scale
+    self.offset = offset
+    self.unit = unit
+
+  @property
+  def member(self):
+    return SnakeCase(self.name) + '_'
+
+  @property
+  def getter(self):
+    return 'Get' + CamelCase(self.name)
+
+  @property
+  def raw_type(self):
+    if self.length == 1 and not self.signed:
+      return 'bool'
+    for bits in (8, 16, 32):
+      if self.length <= bits:
+        return ('int%d_t' if self.signed else 'uint%d_t') % bits
+    raise ValueError('%s is wider than 32 bits' % self.name)
+
+  @property
+  def is_physical(self):
+    return self.scale != 1 or self.offset != 0
+
+
+class Message:
+  def __init__(self, frame_id, name, size):
+    self.is_ext = bool(frame_id & EXT_FLAG)
+    self.id = frame_id & ~EXT_FLAG
+    self.name = name
+    self.size = size
+    self.signals = []
+
+
+def SnakeCase(name):
+  name = re.sub(r'([a-z0-9])([A-Z])', r'\1_\2', name)
+  return re.sub(r'_+', '_', name).lower()
+
+
+def CamelCase(name):
+  return ''.join(part[:1].upper() + part[1:] for part in SnakeCase(name).split('_'))
+
+
+def FloatLiteral(value):
+  text = repr(float(value))
+  return text + 'f'
+
+
+def Parse(path):
+  messages = []
+  errors = []
+  with open(path, encoding='latin-1') as dbc:
+    for number, line in enumerate(dbc, 1):
+      line = line.strip()
+      match = MESSAGE_RE.match(line)
+      if match:
+        # VECTOR__INDEPENDENT_SIG_MSG carries signals that aren't in any real frame
+        if match.group(2) == 'VECTOR__INDEPENDENT_SIG_MSG':
+          messages.append(None)
+          continue
+        messages.append(Message(int(match.group(1)), match.group(2), int(match.group(3))))
+        continue
+      if not line.startswith('SG_') or not messages or messages[-1] is None:
+        continue
+      match = SIGNAL_RE.match(line)
+      if not match:
+        errors.append('%s:%d: can\'t parse signal' % (path, number))
+        continue
+      name, mux = match.group(1), match.group(2)
+      if mux:
+        errors.append('%s:%d: %s is multiplexed' % (path, number, name))
+        continue
+      messages[-1].signals.append(Signal(name, int(match.group(3)), int(match.group(4)), match.group(5) == '1',
+                                         match.group(6) == '-', float(match.group(7)), float(match.group(8)),
+                                         match.group(11)))
+  return [message for message in messages if message is not None], errors
+
+
+def Check(messages):
+  errors = []
+  for message in messages:
+    if message.size < 1 or message.size > 8:
+      errors.append('%s is %d bytes, the codec takes 1 to 8' % (message.name, message.size))
+    for signal in message.signals:
+      if signal.length > 32:
+        errors.append('%s.%s is %d bits, the codec takes up to 32' % (message.name, signal.name, signal.length))
+  return errors
+
+
+def Header(path, name, description, source):
+  today = datetime.date.today()
+  lines = ['/*',
+           ' * %s' % os.path.basename(path),
+           ' *',
+           ' *  Created on: %s %d, %d' % (today.strftime('%b'), today.day, today.year),
+           ' *      Author: dbc_to_datamodules.py',
+           ' *  Description: %s' % description,
+           ' *               Generated from %s, edit the DBC and regenerate instead of this file.' % source,
+           ' */',
+           '']
+  return '\n'.join(lines)
+
+
+def ClassName(prefix, message):
+  return prefix + CamelCase(message.name)
+
+
+def EmitHeader(messages, args, path):
+  guard = 'SOLARGATORSBSP_DATAMODULES_INC_%s_HPP_' % args.name.upper()
+  out = [Header(path, args.name, 'DataModules for the %s messages.' % args.name, os.path.basename(args.dbc)),
+         '#ifndef %s' % guard,
+         '#define %s' % guard,
+         '',
+         '#include <DataModule.hpp>',
+         '#include <FieldCodec.hpp>',
+         '',
+         'namespace SolarGators::DataModules',
+         '{']
+  for message in messages:
+    cls = ClassName(args.prefix, message)
+    out.append('  class %s final: public DataModule' % cls)
+    out.append('  {')
+    out.append('  public:')
+    out.append('    static constexpr uint32_t ID = 0x%X;' % message.id)
+    out.append('    static constexpr bool Is_Ext_Id = %s;' % ('true' if message.is_ext else 'false'))
+    out.append('    static constexpr uint8_t Size = %d;' % message.size)
+    out.append('    %s(uint32_t can_id = ID, uint16_t telem_id = 0);' % cls)
+    out.append('    ~%s() {};' % cls)
+    out.append('')
+    out.append('    void ToByteArray(uint8_t* buff) const;')
+    out.append('    void FromByteArray(uint8_t* buff);')
+    out.append('')
+    for signal in message.signals:
+      unit = ('  // %s' % signal.unit) if signal.unit else ''
+      out.append('    %s %s() const;%s' % ('float' if signal.is_physical else signal.raw_type, signal.getter, unit))
+    out.append('  protected:')
+    for signal in message.signals:
+      out.append('    %s %s;' % (signal.raw_type, signal.member))
+    width = max([len(signal.member) for signal in message.signals] + [0])
+    binds = []
+    for signal in message.signals:
+      extra = ''
+      if not signal.little or signal.signed:
+        extra = ', Order::%s' % ('Little' if signal.little else 'Big')
+        if signal.signed:
+          extra += ', true'
+      binds.append('      Bind<&%s::%s,%s %2d, %2d%s>' % (cls, signal.member, ' ' * (width - len(signal.member)),
+                                                          signal.start, signal.length, extra))
+    out.append('    using Layout = Codec<Size%s' % (',' if binds else '>;'))
+    if binds:
+      out.append(',\n'.join(binds) + '>;')
+    out.append('  };')
+    out.append('')
+  # Registration list
+  out.append('  // One of every %s module, hand each to the CAN driver with ForEach' % args.name)
+  out.append('  struct %sModules' % args.name)
+  out.append('  {')
+  for message in messages:
+    out.append('    %s %s;' % (ClassName(args.prefix, message), SnakeCase(message.name) + '_'))
+  out.append('    template <typename Fn>')
+  out.append('    void ForEach(Fn fn)')
+  out.append('    {')
+  for message in messages:
+    out.append('      fn(static_cast<DataModule&>(%s));' % (SnakeCase(message.name) + '_'))
+  out.append('    }')
+  out.append('  };')
+  out.append('}')
+  out.append('')
+  out.append('#endif /* %s */' % guard)
+  out.append('')
+  return '\n'.join(out)
+
+
+def EmitSource(messages, args, path):
+  out = [Header(path, args.name, 'DataModules for the %s messages.' % args.name, os.path.basename(args.dbc)),
+         '#include <%s.hpp>' % args.name,
+         '',
+         'namespace SolarGators::DataModules',
+         '{']
+  for message in messages:
+    cls = ClassName(args.prefix, message)
+    out.append('  // %s' % message.name)
+    init = ''.join(',\n        %s(0)' % signal.member for signal in message.signals)
+    out.append('  %s::%s(uint32_t can_id, uint16_t telem_id):' % (cls, cls))
+    out.append('        DataModule(can_id, telem_id, Size, 0, Is_Ext_Id)%s' % init)
+    out.append('  { }')
+    out.append('')
+    out.append('  void %s::ToByteArray(uint8_t* buff) const' % cls)
+    out.append('  {')
+    out.append('    Layout::Encode(*this, buff);')
+    out.append('  }')
+    out.append('')
+    out.append('  void %s::FromByteArray(uint8_t* buff)' % cls)
+    out.append('  {')
+    out.append('    Layout::Decode(*this, buff);')
+    out.append('  }')
+    out.append('')
+    for signal in message.signals:
+      if signal.is_physical:
+        if signal.scale != 1:
+          value = '%s * %s' % (signal.member, FloatLiteral(signal.scale))
+        else:
+          value = 'static_cast<float>(%s)' % signal.member
+        if signal.offset != 0:
+          value += ' %s %s' % ('-' if signal.offset < 0 else '+', FloatLiteral(abs(signal.offset)))
+        out.append('  float %s::%s() const {' % (cls, signal.getter))
+      else:
+        value = signal.member
+        out.append('  %s %s::%s() const {' % (signal.raw_type, cls, signal.getter))
+      out.append('    Sync();')
+      out.append('    return %s;' % value)
+      out.append('  }')
+      out.append('')
+  out.append('}')
+  out.append('')
+  return '\n'.join(out)
+
+
+def main():
+  root = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+  parser = argparse.ArgumentParser(description='Generate DataModule classes from a DBC file')
+  parser.add_argument('dbc')
+  parser.add_argument('--name', required=True, help='Base name of the generated files')
+  parser.add_argument('--prefix', default='', help='Prepended to every class name')
+  parser.add_argument('--inc', default=os.path.join(root, 'DataModules', 'inc'))
+  parser.add_argument('--src', default=os.path.join(root, 'DataModules', 'src'))
+  args = parser.parse_args()
+
+  messages, errors = Parse(args.dbc)
+  errors += Check(messages)
+  if errors:
+    for error in errors:
+      print(error, file=sys.stderr)
+    return 1
+
+  header = os.path.join(args.inc, args.name + '.hpp')
+  source = os.path.join(args.src, args.name + '.cpp')
+  with open(header, 'w') as out:
+    out.write(EmitHeader(messages, args, header))
+  with open(source, 'w') as out:
+    out.write(EmitSource(messages, args, source))
+  print('Wrote %d messages to %s and %s' % (len(messages), header, source))
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())